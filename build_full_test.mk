@@ -25,9 +25,16 @@ $(TEST)_SRC= \
 	tests/test_common/matrix.c \
 	tests/test_common/test_driver.cpp \
 	tests/test_common/keyboard_report_util.cpp \
-	tests/test_common/test_fixture.cpp
+	tests/test_common/test_fixture.cpp \
+	tests/test_common/trace_replay.cpp
 $(TEST)_SRC += $(patsubst $(ROOTDIR)/%,%,$(wildcard $(TEST_PATH)/*.cpp))
+ifneq ($(filter bench/%,$(TEST)),)
+    $(TEST)_SRC += tests/bench/bench_common.cpp
+    VPATH += $(TOP_DIR)/tests/bench
+endif
 
 $(TEST)_DEFS=$(TMK_COMMON_DEFS) $(OPT_DEFS)
 $(TEST)_CONFIG=$(TEST_PATH)/config.h
-VPATH+=$(TOP_DIR)/tests/test_common
\ No newline at end of file
+VPATH+=$(TOP_DIR)/tests/test_common
+# For code that includes config.h by name, like keyboard sources do
+VPATH+=$(TOP_DIR)/$(TEST_PATH)
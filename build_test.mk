@@ -63,6 +63,6 @@ include $(TMK_PATH)/native.mk
 include $(TMK_PATH)/rules.mk
 
 
-$(shell mkdir -p $(BUILD_DIR)/test 2>/dev/null)
+$(shell mkdir -p $(BUILD_DIR)/$(dir $(TARGET)) 2>/dev/null)
 $(shell mkdir -p $(TEST_OBJ) 2>/dev/null)
 
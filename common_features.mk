@@ -33,8 +33,16 @@ ifeq ($(strip $(AUDIO_ENABLE)), yes)
     MUSIC_ENABLE = yes
     SRC += $(QUANTUM_DIR)/process_keycode/process_audio.c
     SRC += $(QUANTUM_DIR)/process_keycode/process_clicky.c
-    SRC += $(QUANTUM_DIR)/audio/audio_$(PLATFORM_KEY).c
-    SRC += $(QUANTUM_DIR)/audio/voices.c
+    ifeq ($(strip $(AUDIO_SYNTH_ENABLE)), yes)
+        OPT_DEFS += -DAUDIO_SYNTH_ENABLE
+        SRC += $(QUANTUM_DIR)/audio/audio_$(PLATFORM_KEY)_synth.c
+        SRC += $(QUANTUM_DIR)/audio/synth.c
+        SRC += $(QUANTUM_DIR)/audio/mixer.c
+        SRC += $(QUANTUM_DIR)/audio/voices_synth.c
+    else
+        SRC += $(QUANTUM_DIR)/audio/audio_$(PLATFORM_KEY).c
+        SRC += $(QUANTUM_DIR)/audio/voices.c
+    endif
     SRC += $(QUANTUM_DIR)/audio/luts.c
 endif
 
@@ -53,6 +61,10 @@ ifeq ($(strip $(STENO_ENABLE)), yes)
     OPT_DEFS += -DSTENO_ENABLE
     VIRTSER_ENABLE ?= yes
     SRC += $(QUANTUM_DIR)/process_keycode/process_steno.c
+    ifeq ($(strip $(STENO_DICTIONARY_ENABLE)), yes)
+        OPT_DEFS += -DSTENO_DICTIONARY_ENABLE
+        SRC += $(QUANTUM_DIR)/process_keycode/steno_dictionary.c
+    endif
 endif
 
 ifeq ($(strip $(VIRTSER_ENABLE)), yes)
@@ -180,6 +192,16 @@ endif
     RGB_KEYCODES_ENABLE := yes
 endif
 
+# Only build the listed effects, SOLID_COLOR is always there and `none` leaves only it
+ifneq ($(strip $(RGB_MATRIX_EFFECTS)),)
+    RGB_MATRIX_EFFECT_NAMES := $(shell sed -n 's/^RGB_MATRIX_EFFECT(\([A-Z0-9_]*\)).*/\1/p' $(QUANTUM_DIR)/rgb_matrix_animations/*.h)
+    ifneq ($(filter-out $(RGB_MATRIX_EFFECT_NAMES) none,$(RGB_MATRIX_EFFECTS)),)
+        $(error RGB_MATRIX_EFFECTS has unknown effects: $(filter-out $(RGB_MATRIX_EFFECT_NAMES) none,$(RGB_MATRIX_EFFECTS)))
+    endif
+    # Empty like the config.h form, so a keyboard that already disables some does not redefine them
+    OPT_DEFS += $(patsubst %,-DDISABLE_RGB_MATRIX_%=,$(filter-out SOLID_COLOR $(RGB_MATRIX_EFFECTS),$(RGB_MATRIX_EFFECT_NAMES)))
+endif
+
 ifeq ($(strip $(RGB_MATRIX_ENABLE)), yes)
 	RGB_MATRIX_ENABLE := IS31FL3731
 endif
@@ -332,6 +354,11 @@ ifeq ($(strip $(WPM_ENABLE)), yes)
     OPT_DEFS += -DWPM_ENABLE
 endif
 
+ifeq ($(strip $(SEND_STRING_ASYNC_ENABLE)), yes)
+    SRC += $(QUANTUM_DIR)/send_string_async.c
+    OPT_DEFS += -DSEND_STRING_ASYNC_ENABLE
+endif
+
 ifeq ($(strip $(ENCODER_ENABLE)), yes)
     SRC += $(QUANTUM_DIR)/encoder.c
     OPT_DEFS += -DENCODER_ENABLE
@@ -469,6 +496,10 @@ endif
 
 ifeq ($(strip $(UNICODE_COMMON)), yes)
     SRC += $(QUANTUM_DIR)/process_keycode/process_unicode_common.c
+    ifeq ($(strip $(UNICODE_ASYNC_ENABLE)), yes)
+        SRC += $(QUANTUM_DIR)/process_keycode/process_unicode_async.c
+        OPT_DEFS += -DUNICODE_ASYNC_ENABLE
+    endif
 endif
 
 SPACE_CADET_ENABLE ?= yes
@@ -0,0 +1,94 @@
+"""Report the flash and RAM each RGB Matrix effect costs a keymap.
+"""
+import subprocess
+
+from milc import cli
+
+import qmk.rgb_matrix
+from qmk.commands import create_make_command
+from qmk.constants import QMK_FIRMWARE
+from qmk.decorators import automagic_keyboard, automagic_keymap
+
+
+def build(keyboard, keymap, effects, name, dry_run):
+    """Builds the keymap with only `effects` and returns the (flash, ram) of its firmware, or None when it does not build.
+
+    Each build has its own TARGET, so it gets its own object directory and does not rebuild the others.
+    """
+    target = '%s_%s_rgb_%s' % (keyboard.replace('/', '_'), keymap, name.lower())
+    command = create_make_command(keyboard, keymap) + ['RGB_MATRIX_EFFECTS=%s' % ' '.join(effects), 'TARGET=%s' % target]
+
+    cli.log.info('Building {fg_cyan}%s', ' '.join(command))
+    if dry_run:
+        return 0, 0
+
+    result = subprocess.run(command, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, universal_newlines=True)
+    if result.returncode:
+        cli.log.error('Could not build %s:\n%s', name, result.stderr)
+        return None
+
+    # Some keyboards add to the target name, like _proton_c
+    elf = max((QMK_FIRMWARE / '.build').glob(target + '*.elf'), key=lambda path: path.stat().st_mtime)
+    return qmk.rgb_matrix.elf_sizes(elf.read_bytes())
+
+
+@cli.argument('-kb', '--keyboard', help='The keyboard to build.')
+@cli.argument('-km', '--keymap', help='The keymap to build.')
+@cli.argument('-e', '--effects', arg_only=True, nargs='+', help='The effects to report, all of them when left out.')
+@cli.argument('--max-flash', arg_only=True, type=int, help='Fail if the listed effects together add more than this many bytes of flash.')
+@cli.argument('--max-ram', arg_only=True, type=int, help='Fail if the listed effects together add more than this many bytes of RAM.')
+@cli.argument('-n', '--dry-run', arg_only=True, action='store_true', help="Don't actually build, just show the make commands to be run.")
+@cli.subcommand('Report the flash and RAM each RGB Matrix effect costs a keymap.')
+@automagic_keyboard
+@automagic_keymap
+def rgb_matrix_report(cli):
+    """Report the flash and RAM each RGB Matrix effect costs a keymap.
+
+    The keymap is built once with only SOLID_COLOR, once with each effect on its own, and once with all the listed effects. An effect costs what its build adds to the SOLID_COLOR one. Every build goes to its own target in .build, so running the report again only rebuilds what changed.
+
+    The render time of each effect is measured on the host by `make bench:rgb_matrix`.
+    """
+    keyboard = cli.config.rgb_matrix_report.keyboard
+    keymap = cli.config.rgb_matrix_report.keymap
+
+    if not keyboard or not keymap:
+        cli.log.error('You must supply both `--keyboard` and `--keymap`, or be in a directory for a keyboard or keymap.')
+        return False
+
+    names = qmk.rgb_matrix.effect_names()
+    effects = cli.args.effects or [name for name in names if name != 'SOLID_COLOR']
+    unknown = [effect for effect in effects if effect not in names]
+
+    if unknown:
+        cli.log.error('Unknown effects: %s', ', '.join(unknown))
+        return False
+
+    baseline = build(keyboard, keymap, ['none'], 'none', cli.args.dry_run)
+    sizes = {effect: build(keyboard, keymap, [effect], effect, cli.args.dry_run) for effect in effects}
+    selected = build(keyboard, keymap, effects, 'selected', cli.args.dry_run)
+
+    if baseline is None or None in sizes.values() or selected is None:
+        cli.log.error('Could not report the effect costs, as not every build succeeded.')
+        return False
+
+    flash, ram = selected
+
+    if cli.args.dry_run:
+        return True
+
+    cli.echo('%-30s %8s %8s', 'Effect', 'Flash', 'RAM')
+    for name, effect_flash, effect_ram in qmk.rgb_matrix.effect_costs(baseline, sizes):
+        cli.echo('%-30s %8d %8d', name, effect_flash, effect_ram)
+    cli.echo('%-30s %8d %8d', 'Together', flash - baseline[0], ram - baseline[1])
+    cli.echo('%-30s %8d %8d', 'Firmware', flash, ram)
+
+    # Effects share their runners and math, so the budget is checked against the build with all of them
+    ok = True
+    if cli.args.max_flash is not None and flash - baseline[0] > cli.args.max_flash:
+        cli.log.error('The effects add %d bytes of flash, over the budget of %d.', flash - baseline[0], cli.args.max_flash)
+        ok = False
+    if cli.args.max_ram is not None and ram - baseline[1] > cli.args.max_ram:
+        cli.log.error('The effects add %d bytes of RAM, over the budget of %d.', ram - baseline[1], cli.args.max_ram)
+        ok = False
+
+    return ok
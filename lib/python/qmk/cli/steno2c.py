@@ -0,0 +1,61 @@
+"""Generate a firmware steno dictionary from a Plover dictionary.
+"""
+import json
+
+from milc import cli
+
+import qmk.path
+import qmk.steno
+
+
+@cli.argument('-o', '--output', arg_only=True, type=qmk.path.normpath, help='File to write to, raw bytes when it ends in .bin')
+@cli.argument('-q', '--quiet', arg_only=True, action='store_true', help="Quiet mode, only output error messages")
+@cli.argument('-v', '--verbose', arg_only=True, action='store_true', help="List every entry that was left out")
+@cli.argument('filename', type=qmk.path.normpath, arg_only=True, help='Plover JSON dictionary')
+@cli.subcommand('Creates a steno dictionary for STENO_DICTIONARY_ENABLE from a Plover dictionary.')
+def steno2c(cli):
+    """Generate a firmware steno dictionary from a Plover dictionary.
+
+    This command uses the `qmk.steno` module to turn a Plover JSON dictionary into a C file that defines `steno_dictionary`. The C file is written to stdout, or to a file if -o is provided. When the output ends in .bin the dictionary is written as raw bytes, to be flashed to external storage.
+    """
+    # Error checking
+    if not cli.args.filename.exists():
+        cli.log.error('JSON file does not exist!')
+        cli.print_usage()
+        exit(1)
+
+    # Environment processing
+    if cli.args.output and cli.args.output.name == '-':
+        cli.args.output = None
+
+    # Parse the Plover dictionary
+    with cli.args.filename.open('r', encoding='utf-8') as fd:
+        dictionary = json.load(fd)
+
+    # Build the trie
+    try:
+        data, skipped = qmk.steno.build(dictionary)
+    except qmk.steno.StenoError as e:
+        cli.log.error(str(e))
+        exit(1)
+
+    entries = len(dictionary) - len(skipped)
+
+    if not cli.args.quiet:
+        for outline, reason in skipped if cli.args.verbose else []:
+            cli.log.warning('Left out %s: %s', outline, reason)
+        cli.log.info('%d entries in %d bytes, %.1f bytes per entry, %d left out.', entries, len(data), len(data) / max(entries, 1), len(skipped))
+
+    if cli.args.output and cli.args.output.suffix == '.bin':
+        cli.args.output.parent.mkdir(parents=True, exist_ok=True)
+        cli.args.output.write_bytes(data)
+
+    elif cli.args.output:
+        cli.args.output.parent.mkdir(parents=True, exist_ok=True)
+        cli.args.output.write_text(qmk.steno.to_c(data, cli.args.filename.name, entries))
+
+        if not cli.args.quiet:
+            cli.log.info('Wrote dictionary to %s.', cli.args.output)
+
+    else:
+        print(qmk.steno.to_c(data, cli.args.filename.name, entries), end='')
@@ -0,0 +1,81 @@
+"""Functions that find out what each RGB Matrix effect costs in a firmware.
+
+Every effect is built on its own with `RGB_MATRIX_EFFECTS`, and its cost is the flash and RAM its firmware takes over one that only has SOLID_COLOR.
+"""
+import re
+import struct
+
+from qmk.constants import QMK_FIRMWARE
+
+ANIMATIONS_DIR = QMK_FIRMWARE / 'quantum' / 'rgb_matrix_animations'
+
+# Sections that are allocated but live in neither flash nor RAM, like avr-size leaves them out
+NOT_IN_MEMORY = ('.eeprom', '.fuse', '.lock', '.signature', '.user_signatures')
+
+SHT_NOBITS = 8
+SHF_WRITE = 0x1
+SHF_ALLOC = 0x2
+
+
+def effect_names(animations_dir=ANIMATIONS_DIR):
+    """Returns the name of every core effect, in the order of the rgb_matrix_effects enum.
+    """
+    names = []
+    includes = (animations_dir / 'rgb_matrix_effects.inc').read_text()
+
+    for header in re.findall(r'^#include "rgb_matrix_animations/([^"]+)"', includes, re.MULTILINE):
+        names += re.findall(r'^RGB_MATRIX_EFFECT\((\w+)\)', (animations_dir / header).read_text(), re.MULTILINE)
+
+    return names
+
+
+def elf_sizes(data):
+    """Returns the (flash, ram) bytes an ELF file takes, from its section headers.
+
+    Flash holds every allocated section with contents, so .data counts for its initial values. RAM holds every allocated section that can be written.
+    """
+    if data[0:4] != b'\x7fELF':
+        raise ValueError('Not an ELF file')
+
+    is_64 = data[4] == 2
+    endian = '<' if data[5] == 1 else '>'
+
+    if is_64:
+        shoff, = struct.unpack_from(endian + 'Q', data, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH', data, 0x3A)
+        header = endian + 'IIQQQQIIQQ'
+    else:
+        shoff, = struct.unpack_from(endian + 'I', data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH', data, 0x2E)
+        header = endian + 'IIIIIIIIII'
+
+    sections = [struct.unpack_from(header, data, shoff + i * shentsize) for i in range(shnum)]
+    strtab_offset = sections[shstrndx][4]
+    flash = 0
+    ram = 0
+
+    for name_offset, kind, flags, _, _, size, *_ in sections:
+        name = data[strtab_offset + name_offset:data.index(b'\0', strtab_offset + name_offset)].decode()
+
+        if not flags & SHF_ALLOC or name.startswith(NOT_IN_MEMORY):
+            continue
+        if kind != SHT_NOBITS:
+            flash += size
+        if flags & SHF_WRITE:
+            ram += size
+
+    return flash, ram
+
+
+def effect_costs(baseline, sizes):
+    """Returns (name, flash, ram) for every effect, as the bytes each adds to the baseline build.
+
+    Args:
+
+        baseline
+            The (flash, ram) of the build with no effect but SOLID_COLOR
+
+        sizes
+            A dict of effect name to the (flash, ram) of the build with only that effect
+    """
+    return [(name, flash - baseline[0], ram - baseline[1]) for name, (flash, ram) in sizes.items()]
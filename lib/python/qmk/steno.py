@@ -0,0 +1,225 @@
+"""Functions that build a steno dictionary the firmware can translate with.
+
+The dictionary is a trie of strokes. Each node is a list of edges sorted by stroke, and every edge may point at a translation, at the node for the strokes that can follow, or both. All numbers are little-endian.
+
+    header  "STN", version, longest entry in strokes, root node offset (3 bytes)
+    node    edge count (3 bytes), then per edge: stroke (3 bytes), child node offset (3 bytes, 0 for none), translation offset (3 bytes, 0 for none)
+    text    flags, length, then that many ASCII characters
+
+The flags are the TEXT_* values below, and match quantum/process_keycode/steno_dictionary.h.
+"""
+import re
+
+VERSION = 1
+HEADER_SIZE = 8
+EDGE_SIZE = 9
+MAX_OFFSET = 0xFFFFFF
+
+# Steno keys in steno order, which is also their bit in a stroke
+KEYS = ['#', 'S-', 'T-', 'K-', 'P-', 'W-', 'H-', 'R-', 'A-', 'O-', '*', '-E', '-U', '-F', '-R', '-P', '-B', '-L', '-G', '-T', '-S', '-D', '-Z']
+FIRST_RIGHT_KEY = KEYS.index('-E')
+NUMBER_KEYS = {'1': 'S-', '2': 'T-', '3': 'P-', '4': 'H-', '5': 'A-', '0': 'O-', '6': '-F', '7': '-P', '8': '-L', '9': '-T'}
+
+TEXT_ATTACH_BEFORE = 1 << 0  # no space before this translation
+TEXT_ATTACH_AFTER = 1 << 1  # no space before the next one
+TEXT_CAPITALIZE_NEXT = 1 << 2  # capitalize the next word
+TEXT_GLUE = 1 << 3  # attach to a neighbouring glue translation, for fingerspelling
+TEXT_UNDO = 1 << 4  # take back the last translation instead of typing
+
+# Plover keys that have an ASCII character
+KEY_COMBOS = {'return': '\n', 'enter': '\n', 'tab': '\t', 'space': ' '}
+PUNCTUATION = {'.': TEXT_CAPITALIZE_NEXT, '?': TEXT_CAPITALIZE_NEXT, '!': TEXT_CAPITALIZE_NEXT, ',': 0, ':': 0, ';': 0}
+
+
+class StenoError(ValueError):
+    """A stroke or translation that can not be put in the dictionary.
+    """
+
+
+def parse_stroke(text):
+    """Returns the bits of a stroke written like Plover does, for example "STKPW", "-PB", "A*EU" or "1-9".
+    """
+    bits = 0
+    position = 0
+
+    for char in text:
+        if char == '-':
+            position = max(position, FIRST_RIGHT_KEY)
+            continue
+
+        if char in NUMBER_KEYS:
+            bits |= 1
+            char = NUMBER_KEYS[char].strip('-')
+
+        for index in range(max(position, 1), len(KEYS)):
+            if KEYS[index].strip('-') == char:
+                bits |= 1 << index
+                position = index + 1
+                break
+        else:
+            if char == '#':
+                bits |= 1
+                continue
+            raise StenoError('Invalid stroke %r' % text)
+
+    if not bits:
+        raise StenoError('Empty stroke in %r' % text)
+
+    return bits
+
+
+def parse_outline(text):
+    """Returns the strokes of a dictionary key like "PRO/TKUS".
+    """
+    return tuple(parse_stroke(stroke) for stroke in text.split('/'))
+
+
+class _Translation:
+    """The text of a translation, put together piece by piece.
+    """
+    def __init__(self):
+        self.flags = 0
+        self.output = ''
+        self.attach = False  # the next piece goes right after the last one
+        self.capitalize = False
+
+    def add(self, piece):
+        if not piece:
+            return
+        if self.capitalize:
+            piece = piece[0].upper() + piece[1:]
+            self.capitalize = False
+        if self.output and not self.attach:
+            self.output += ' '
+        elif not self.output and self.attach:
+            self.flags |= TEXT_ATTACH_BEFORE
+        self.output += piece
+        self.attach = False
+
+    def command(self, meta):
+        if meta in ('-|', '>'):
+            self.capitalize = meta == '-|'
+        elif meta in PUNCTUATION:
+            self.attach = True
+            self.add(meta)
+            self.capitalize = self.capitalize or bool(PUNCTUATION[meta])
+        elif meta.startswith('&'):
+            self.flags |= TEXT_GLUE
+            self.add(meta[1:])
+        elif meta.startswith('#') and meta[1:].lower() in KEY_COMBOS:
+            self.attach = True
+            self.add(KEY_COMBOS[meta[1:].lower()])
+            self.attach = True
+        elif meta.startswith('^') or meta.endswith('^'):
+            self.attach = self.attach or meta.startswith('^')
+            self.add(meta.strip('^'))
+            if meta.endswith('^'):
+                self.attach = True
+        else:
+            raise StenoError('Unsupported command %r' % ('{' + meta + '}'))
+
+    def finish(self):
+        if not self.output and self.attach:
+            self.flags |= TEXT_ATTACH_BEFORE
+        if self.attach:
+            self.flags |= TEXT_ATTACH_AFTER
+        if self.capitalize:
+            self.flags |= TEXT_CAPITALIZE_NEXT
+        return self.flags, self.output
+
+
+def parse_translation(text):
+    """Returns the flags and the ASCII text for a Plover translation.
+
+    Supports plain text, attaching with {^}, capitalizing with {-|}, punctuation like {.} and {,}, glue with {&}, the keys {#Return}, {#Tab} and {#Space}, and =undo.
+    """
+    if text == '=undo':
+        return TEXT_UNDO, ''
+
+    translation = _Translation()
+    for token in re.split(r'(\{[^{}]*\})', text):
+        if token.startswith('{'):
+            translation.command(token[1:-1])
+        else:
+            translation.add(token.strip(' '))
+    flags, output = translation.finish()
+
+    if any(ord(char) > 126 or (ord(char) < 32 and char not in '\n\t') for char in output):
+        raise StenoError('Not ASCII: %r' % text)
+    if len(output) > 255:
+        raise StenoError('Longer than 255 characters: %r' % text)
+
+    return flags, output
+
+
+def _u24(value):
+    if value > MAX_OFFSET:
+        raise StenoError('The dictionary is larger than 16 MB')
+    return bytes((value & 0xFF, (value >> 8) & 0xFF, value >> 16))
+
+
+def build(dictionary):
+    """Returns the firmware dictionary for a Plover dictionary, as (data, skipped), where skipped lists the (outline, reason) of every entry that was left out.
+    """
+    trie = {}
+    texts = {}
+    skipped = []
+    longest = 0
+
+    for outline, translation in dictionary.items():
+        try:
+            strokes = parse_outline(outline)
+            text = parse_translation(translation)
+        except StenoError as e:
+            skipped.append((outline, str(e)))
+            continue
+
+        node = trie
+        for stroke in strokes[:-1]:
+            node = node.setdefault(stroke, [None, {}])[1]
+        node.setdefault(strokes[-1], [None, {}])[0] = text
+        texts[text] = None
+        longest = max(longest, len(strokes))
+
+    if longest > 255:
+        raise StenoError('Entries can be at most 255 strokes long')
+
+    data = bytearray(HEADER_SIZE)
+
+    # Every distinct translation is stored once
+    for text in texts:
+        flags, output = text
+        texts[text] = len(data)
+        data += bytes((flags, len(output))) + output.encode('ascii')
+
+    def write_node(node):
+        # Children first, so that a node knows their offsets
+        children = {stroke: write_node(node[stroke][1]) if node[stroke][1] else 0 for stroke in sorted(node)}
+        offset = len(data)
+        data.extend(_u24(len(node)))
+        for stroke in sorted(node):
+            text = node[stroke][0]
+            data.extend(_u24(stroke) + _u24(children[stroke]) + _u24(texts[text] if text else 0))
+        return offset
+
+    root = write_node(trie)
+    data[0:HEADER_SIZE] = b'STN' + bytes((VERSION, longest)) + _u24(root)
+
+    return bytes(data), skipped
+
+
+def to_c(data, source, entries):
+    """Returns the C source of a firmware dictionary.
+    """
+    lines = [
+        '// Generated by `qmk steno2c` from %s, %d entries in %d bytes' % (source, entries, len(data)),
+        '',
+        '#include "steno_dictionary.h"',
+        '',
+        'const uint8_t steno_dictionary[] PROGMEM = {',
+    ]
+    for start in range(0, len(data), 16):
+        lines.append('    ' + ' '.join('0x%02X,' % byte for byte in data[start:start + 16]))
+    lines.append('};')
+
+    return '\n'.join(lines) + '\n'
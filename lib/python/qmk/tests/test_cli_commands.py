@@ -84,3 +84,20 @@ def test_list_keymaps_no_keyboard_found():
     result = check_subcommand('list-keymaps', '-kb', 'asdfghjkl')
     assert result.returncode == 0
     assert 'does not exist' in result.stdout
+
+
+def test_steno2c():
+    result = check_subcommand('steno2c', 'tests/steno_dictionary/dictionary.json')
+    assert result.returncode == 0
+    assert 'const uint8_t steno_dictionary[] PROGMEM = {' in result.stdout
+
+
+def test_rgb_matrix_report():
+    result = check_subcommand('rgb-matrix-report', '-kb', 'handwired/onekey/pytest', '-km', 'default', '-e', 'BREATHING', 'CYCLE_ALL', '-n')
+    assert result.returncode == 0
+    assert 'RGB_MATRIX_EFFECTS=BREATHING CYCLE_ALL' in result.stderr
+    assert 'TARGET=handwired_onekey_pytest_default_rgb_none' in result.stderr
+
+
+def test_rgb_matrix_report_unknown_effect():
+    assert check_subcommand('rgb-matrix-report', '-kb', 'handwired/onekey/pytest', '-km', 'default', '-e', 'RAINBOW', '-n').returncode == 1
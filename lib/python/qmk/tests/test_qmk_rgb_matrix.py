@@ -0,0 +1,47 @@
+import struct
+
+import qmk.rgb_matrix
+
+
+def make_elf(sections):
+    """Returns a little-endian ELF32 file with only section headers, for (name, type, flags, size) sections.
+    """
+    names = b'\0'
+    offsets = []
+    for name, *_ in sections + [('.shstrtab', 3, 0, 0)]:
+        offsets.append(len(names))
+        names += name.encode() + b'\0'
+
+    shoff = 52 + len(names)
+    header = b'\x7fELF' + bytes((1, 1, 1)) + bytes(9) + struct.pack('<HHIIIIIHHHHHH', 2, 83, 1, 0, 0, shoff, 0, 52, 0, 0, 40, len(sections) + 2, len(sections) + 1)
+    table = bytes(40)
+    for offset, (name, kind, flags, size) in zip(offsets, sections):
+        table += struct.pack('<IIIIIIIIII', offset, kind, flags, 0, 0, size, 0, 0, 1, 0)
+    table += struct.pack('<IIIIIIIIII', offsets[-1], 3, 0, 0, 52, len(names), 0, 0, 1, 0)
+
+    return header + names + table
+
+
+def test_elf_sizes():
+    elf = make_elf([
+        ('.text', 1, 0x6, 1000),
+        ('.data', 1, 0x3, 20),
+        ('.bss', 8, 0x3, 300),
+        ('.noinit', 8, 0x3, 4),
+        ('.eeprom', 1, 0x3, 50),
+        ('.comment', 1, 0x30, 17),
+    ])
+    assert qmk.rgb_matrix.elf_sizes(elf) == (1020, 324)
+
+
+def test_effect_names():
+    names = qmk.rgb_matrix.effect_names()
+    assert names[0] == 'SOLID_COLOR'
+    assert names.index('BREATHING') < names.index('CYCLE_ALL')
+    assert 'SOLID_REACTIVE_MULTINEXUS' in names
+    assert len(names) == len(set(names))
+
+
+def test_effect_costs():
+    costs = qmk.rgb_matrix.effect_costs((1000, 100), {'BREATHING': (1200, 100), 'DIGITAL_RAIN': (1500, 148)})
+    assert costs == [('BREATHING', 200, 0), ('DIGITAL_RAIN', 500, 48)]
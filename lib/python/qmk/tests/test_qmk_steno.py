@@ -0,0 +1,60 @@
+import pytest
+
+import qmk.steno
+
+
+def test_parse_stroke():
+    assert qmk.steno.parse_stroke('S') == 1 << 1
+    assert qmk.steno.parse_stroke('-S') == 1 << 20
+    assert qmk.steno.parse_stroke('A*EU') == 1 << 8 | 1 << 10 | 1 << 11 | 1 << 12
+    assert qmk.steno.parse_stroke('TP-PL') == 1 << 2 | 1 << 4 | 1 << 15 | 1 << 17
+    assert qmk.steno.parse_stroke('1-9') == 1 | 1 << 1 | 1 << 19
+
+
+def test_parse_stroke_invalid():
+    with pytest.raises(qmk.steno.StenoError):
+        qmk.steno.parse_stroke('SX')
+    with pytest.raises(qmk.steno.StenoError):
+        qmk.steno.parse_stroke('TS-T')
+
+
+def test_parse_translation():
+    assert qmk.steno.parse_translation('hello') == (0, 'hello')
+    assert qmk.steno.parse_translation('{^ing}') == (qmk.steno.TEXT_ATTACH_BEFORE, 'ing')
+    assert qmk.steno.parse_translation('{.}') == (qmk.steno.TEXT_ATTACH_BEFORE | qmk.steno.TEXT_CAPITALIZE_NEXT, '.')
+    assert qmk.steno.parse_translation('{-|}the') == (0, 'The')
+    assert qmk.steno.parse_translation('hello{,}world') == (0, 'hello, world')
+    assert qmk.steno.parse_translation('{&a}') == (qmk.steno.TEXT_GLUE, 'a')
+    assert qmk.steno.parse_translation('=undo') == (qmk.steno.TEXT_UNDO, '')
+
+
+def test_parse_translation_unsupported():
+    with pytest.raises(qmk.steno.StenoError):
+        qmk.steno.parse_translation('{PLOVER:TOGGLE}')
+    with pytest.raises(qmk.steno.StenoError):
+        qmk.steno.parse_translation('café')
+
+
+def test_build():
+    data, skipped = qmk.steno.build({'HEL/HRO': 'hello', 'HEL': 'hell', 'TEFT': 'test', 'TP*': '{PLOVER:TOGGLE}'})
+    assert data[0:4] == b'STN\x01'
+    assert data[4] == 2
+    assert skipped == [('TP*', "Unsupported command '{PLOVER:TOGGLE}'")]
+
+    # The root has the edges for HEL and TEFT, and HEL leads to a node with HRO
+    root = int.from_bytes(data[5:8], 'little')
+    assert int.from_bytes(data[root:root + 3], 'little') == 2
+    assert data.find(b'\x05hello') > 0
+
+
+def test_build_size_per_entry():
+    # Every left hand stroke on its own and followed by one of three right hand strokes
+    dictionary = {}
+    for i in range(1, 512):
+        stroke = ''.join(key for bit, key in enumerate('STKPWHRAO') if i >> bit & 1)
+        dictionary[stroke] = 'word%d' % i
+        for right in ('-F', '-R', '-P'):
+            dictionary[stroke + '/' + right] = 'word%d%s' % (i, right[1].lower())
+    data, skipped = qmk.steno.build(dictionary)
+    assert not skipped
+    assert len(data) / len(dictionary) < 24
@@ -0,0 +1,359 @@
+/* Copyright 2016 Jack Humbert
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <string.h>
+//#include <math.h>
+#if defined(__AVR__)
+#    include <avr/pgmspace.h>
+#    include <avr/interrupt.h>
+#    include <avr/io.h>
+#endif
+#include "print.h"
+#include "audio.h"
+#include "synth.h"
+#include "keymap.h"
+#include "wait.h"
+
+#include "eeconfig.h"
+
+#define CPU_PRESCALER 8
+
+// -----------------------------------------------------------------------------
+// Timer Abstractions
+// -----------------------------------------------------------------------------
+
+// Currently we support timers 1 and 3 used at the sime time, channels A-C,
+// pins PB5, PB6, PB7, PC4, PC5, and PC6
+#if defined(C6_AUDIO)
+#    define CPIN_AUDIO
+#    define CPIN_SET_DIRECTION DDRC |= _BV(PORTC6);
+#    define INIT_AUDIO_COUNTER_3 TCCR3A = (0 << COM3A1) | (0 << COM3A0) | (1 << WGM31) | (0 << WGM30);
+#    define ENABLE_AUDIO_COUNTER_3_ISR TIMSK3 |= _BV(OCIE3A)
+#    define DISABLE_AUDIO_COUNTER_3_ISR TIMSK3 &= ~_BV(OCIE3A)
+#    define ENABLE_AUDIO_COUNTER_3_OUTPUT TCCR3A |= _BV(COM3A1);
+#    define DISABLE_AUDIO_COUNTER_3_OUTPUT TCCR3A &= ~(_BV(COM3A1) | _BV(COM3A0));
+#    define TIMER_3_PERIOD ICR3
+#    define TIMER_3_DUTY_CYCLE OCR3A
+#    define TIMER3_AUDIO_vect TIMER3_COMPA_vect
+#endif
+#if defined(C5_AUDIO)
+#    define CPIN_AUDIO
+#    define CPIN_SET_DIRECTION DDRC |= _BV(PORTC5);
+#    define INIT_AUDIO_COUNTER_3 TCCR3A = (0 << COM3B1) | (0 << COM3B0) | (1 << WGM31) | (0 << WGM30);
+#    define ENABLE_AUDIO_COUNTER_3_ISR TIMSK3 |= _BV(OCIE3B)
+#    define DISABLE_AUDIO_COUNTER_3_ISR TIMSK3 &= ~_BV(OCIE3B)
+#    define ENABLE_AUDIO_COUNTER_3_OUTPUT TCCR3A |= _BV(COM3B1);
+#    define DISABLE_AUDIO_COUNTER_3_OUTPUT TCCR3A &= ~(_BV(COM3B1) | _BV(COM3B0));
+#    define TIMER_3_PERIOD ICR3
+#    define TIMER_3_DUTY_CYCLE OCR3B
+#    define TIMER3_AUDIO_vect TIMER3_COMPB_vect
+#endif
+#if defined(C4_AUDIO)
+#    define CPIN_AUDIO
+#    define CPIN_SET_DIRECTION DDRC |= _BV(PORTC4);
+#    define INIT_AUDIO_COUNTER_3 TCCR3A = (0 << COM3C1) | (0 << COM3C0) | (1 << WGM31) | (0 << WGM30);
+#    define ENABLE_AUDIO_COUNTER_3_ISR TIMSK3 |= _BV(OCIE3C)
+#    define DISABLE_AUDIO_COUNTER_3_ISR TIMSK3 &= ~_BV(OCIE3C)
+#    define ENABLE_AUDIO_COUNTER_3_OUTPUT TCCR3A |= _BV(COM3C1);
+#    define DISABLE_AUDIO_COUNTER_3_OUTPUT TCCR3A &= ~(_BV(COM3C1) | _BV(COM3C0));
+#    define TIMER_3_PERIOD ICR3
+#    define TIMER_3_DUTY_CYCLE OCR3C
+#    define TIMER3_AUDIO_vect TIMER3_COMPC_vect
+#endif
+
+#if defined(B5_AUDIO)
+#    define BPIN_AUDIO
+#    define BPIN_SET_DIRECTION DDRB |= _BV(PORTB5);
+#    define INIT_AUDIO_COUNTER_1 TCCR1A = (0 << COM1A1) | (0 << COM1A0) | (1 << WGM11) | (0 << WGM10);
+#    define ENABLE_AUDIO_COUNTER_1_ISR TIMSK1 |= _BV(OCIE1A)
+#    define DISABLE_AUDIO_COUNTER_1_ISR TIMSK1 &= ~_BV(OCIE1A)
+#    define ENABLE_AUDIO_COUNTER_1_OUTPUT TCCR1A |= _BV(COM1A1);
+#    define DISABLE_AUDIO_COUNTER_1_OUTPUT TCCR1A &= ~(_BV(COM1A1) | _BV(COM1A0));
+#    define TIMER_1_PERIOD ICR1
+#    define TIMER_1_DUTY_CYCLE OCR1A
+#    define TIMER1_AUDIO_vect TIMER1_COMPA_vect
+#endif
+#if defined(B6_AUDIO)
+#    define BPIN_AUDIO
+#    define BPIN_SET_DIRECTION DDRB |= _BV(PORTB6);
+#    define INIT_AUDIO_COUNTER_1 TCCR1A = (0 << COM1B1) | (0 << COM1B0) | (1 << WGM11) | (0 << WGM10);
+#    define ENABLE_AUDIO_COUNTER_1_ISR TIMSK1 |= _BV(OCIE1B)
+#    define DISABLE_AUDIO_COUNTER_1_ISR TIMSK1 &= ~_BV(OCIE1B)
+#    define ENABLE_AUDIO_COUNTER_1_OUTPUT TCCR1A |= _BV(COM1B1);
+#    define DISABLE_AUDIO_COUNTER_1_OUTPUT TCCR1A &= ~(_BV(COM1B1) | _BV(COM1B0));
+#    define TIMER_1_PERIOD ICR1
+#    define TIMER_1_DUTY_CYCLE OCR1B
+#    define TIMER1_AUDIO_vect TIMER1_COMPB_vect
+#endif
+#if defined(B7_AUDIO)
+#    define BPIN_AUDIO
+#    define BPIN_SET_DIRECTION DDRB |= _BV(PORTB7);
+#    define INIT_AUDIO_COUNTER_1 TCCR1A = (0 << COM1C1) | (0 << COM1C0) | (1 << WGM11) | (0 << WGM10);
+#    define ENABLE_AUDIO_COUNTER_1_ISR TIMSK1 |= _BV(OCIE1C)
+#    define DISABLE_AUDIO_COUNTER_1_ISR TIMSK1 &= ~_BV(OCIE1C)
+#    define ENABLE_AUDIO_COUNTER_1_OUTPUT TCCR1A |= _BV(COM1C1);
+#    define DISABLE_AUDIO_COUNTER_1_OUTPUT TCCR1A &= ~(_BV(COM1C1) | _BV(COM1C0));
+#    define TIMER_1_PERIOD ICR1
+#    define TIMER_1_DUTY_CYCLE OCR1C
+#    define TIMER1_AUDIO_vect TIMER1_COMPC_vect
+#endif
+// -----------------------------------------------------------------------------
+
+// Timer counts per second and per synth tick
+#define AUDIO_TIMER_HZ ((uint32_t)F_CPU / CPU_PRESCALER)
+#define AUDIO_TICK_COUNTS (AUDIO_TIMER_HZ / SYNTH_TICK_RATE)
+
+static bool audio_initialized = false;
+
+audio_config_t audio_config;
+
+#ifndef STARTUP_SONG
+#    define STARTUP_SONG SONG(STARTUP_SOUND)
+#endif
+#ifndef AUDIO_ON_SONG
+#    define AUDIO_ON_SONG SONG(AUDIO_ON_SOUND)
+#endif
+#ifndef AUDIO_OFF_SONG
+#    define AUDIO_OFF_SONG SONG(AUDIO_OFF_SOUND)
+#endif
+float startup_song[][2]   = STARTUP_SONG;
+float audio_on_song[][2]  = AUDIO_ON_SONG;
+float audio_off_song[][2] = AUDIO_OFF_SONG;
+
+// Timer counts played since the last synth tick
+static uint32_t tick_counts = 0;
+
+/* The timer interrupt fires once per period of the note, so the synth is
+ * advanced by however many ticks that period took. */
+static void audio_advance(uint16_t period) {
+    tick_counts += (uint32_t)period + 1;
+    while (tick_counts >= AUDIO_TICK_COUNTS) {
+        tick_counts -= AUDIO_TICK_COUNTS;
+        synth_tick();
+    }
+    if (!audio_config.enable) {
+        synth_stop_all();
+    }
+}
+
+// Rests still interrupt once per tick, with the output held low
+static uint16_t timer_period(const synth_channel_t *channel) { return channel->frequency ? (AUDIO_TIMER_HZ << 8) / (channel->frequency >> 8) : AUDIO_TICK_COUNTS; }
+
+static uint16_t timer_duty_cycle(const synth_channel_t *channel, uint16_t period) { return channel->frequency ? ((uint32_t)period * channel->duty) >> 16 : 0; }
+
+static void start_output(void) {
+#ifdef CPIN_AUDIO
+    ENABLE_AUDIO_COUNTER_3_ISR;
+    ENABLE_AUDIO_COUNTER_3_OUTPUT;
+#else
+    ENABLE_AUDIO_COUNTER_1_ISR;
+    ENABLE_AUDIO_COUNTER_1_OUTPUT;
+#endif
+}
+
+static void stop_output(void) {
+#ifdef CPIN_AUDIO
+    DISABLE_AUDIO_COUNTER_3_ISR;
+    DISABLE_AUDIO_COUNTER_3_OUTPUT;
+#endif
+#ifdef BPIN_AUDIO
+    DISABLE_AUDIO_COUNTER_1_ISR;
+    DISABLE_AUDIO_COUNTER_1_OUTPUT;
+#endif
+}
+
+// Keeps the timer interrupt from running the synth while it is changed
+static void pause_output(void) {
+#ifdef CPIN_AUDIO
+    DISABLE_AUDIO_COUNTER_3_ISR;
+#endif
+#ifdef BPIN_AUDIO
+    DISABLE_AUDIO_COUNTER_1_ISR;
+#endif
+}
+
+static void resume_output(void) {
+    if (synth_is_active()) {
+        start_output();
+    } else {
+        stop_output();
+    }
+}
+
+void audio_init() {
+    // Check EEPROM
+    if (!eeconfig_is_enabled()) {
+        eeconfig_init();
+    }
+    audio_config.raw = eeconfig_read_audio();
+
+    if (!audio_initialized) {
+// Set audio ports as output
+#ifdef CPIN_AUDIO
+        CPIN_SET_DIRECTION
+        DISABLE_AUDIO_COUNTER_3_ISR;
+#endif
+#ifdef BPIN_AUDIO
+        BPIN_SET_DIRECTION
+        DISABLE_AUDIO_COUNTER_1_ISR;
+#endif
+
+// TCCR3A / TCCR3B: Timer/Counter #3 Control Registers TCCR3A/TCCR3B, TCCR1A/TCCR1B
+// Compare Output Mode (COM3An and COM1An) = 0b00 = Normal port operation
+//   OC3A -- PC6
+//   OC3B -- PC5
+//   OC3C -- PC4
+//   OC1A -- PB5
+//   OC1B -- PB6
+//   OC1C -- PB7
+
+// Waveform Generation Mode (WGM3n) = 0b1110 = Fast PWM Mode 14. Period = ICR3, Duty Cycle OCR3A)
+//   OCR3A - PC6
+//   OCR3B - PC5
+//   OCR3C - PC4
+//   OCR1A - PB5
+//   OCR1B - PB6
+//   OCR1C - PB7
+
+// Clock Select (CS3n) = 0b010 = Clock / 8
+#ifdef CPIN_AUDIO
+        INIT_AUDIO_COUNTER_3
+        TCCR3B             = (1 << WGM33) | (1 << WGM32) | (0 << CS32) | (1 << CS31) | (0 << CS30);
+        TIMER_3_PERIOD     = (uint16_t)(AUDIO_TIMER_HZ / 440);
+        TIMER_3_DUTY_CYCLE = TIMER_3_PERIOD / 2;
+#endif
+#ifdef BPIN_AUDIO
+        INIT_AUDIO_COUNTER_1
+        TCCR1B             = (1 << WGM13) | (1 << WGM12) | (0 << CS12) | (1 << CS11) | (0 << CS10);
+        TIMER_1_PERIOD     = (uint16_t)(AUDIO_TIMER_HZ / 440);
+        TIMER_1_DUTY_CYCLE = TIMER_1_PERIOD / 2;
+#endif
+
+        audio_initialized = true;
+    }
+
+    if (audio_config.enable) {
+        PLAY_SONG(startup_song);
+    }
+}
+
+void stop_all_notes() {
+    dprintf("audio stop all notes");
+
+    if (!audio_initialized) {
+        audio_init();
+    }
+    stop_output();
+    synth_stop_all();
+}
+
+void stop_note(float freq) {
+    dprintf("audio stop note freq=%d", (int)freq);
+
+    if (!audio_initialized) {
+        audio_init();
+    }
+    pause_output();
+    synth_stop_note(freq);
+    resume_output();
+}
+
+#ifdef CPIN_AUDIO
+ISR(TIMER3_AUDIO_vect) {
+    audio_advance(TIMER_3_PERIOD);
+    if (!synth_is_active()) {
+        stop_output();
+        return;
+    }
+
+    TIMER_3_PERIOD     = timer_period(&synth_channels[0]);
+    TIMER_3_DUTY_CYCLE = timer_duty_cycle(&synth_channels[0], TIMER_3_PERIOD);
+
+#    ifdef BPIN_AUDIO
+    // The second note held goes to the other pin
+    if (synth_channels[1].frequency) {
+        TIMER_1_PERIOD     = timer_period(&synth_channels[1]);
+        TIMER_1_DUTY_CYCLE = timer_duty_cycle(&synth_channels[1], TIMER_1_PERIOD);
+        ENABLE_AUDIO_COUNTER_1_OUTPUT;
+    } else {
+        DISABLE_AUDIO_COUNTER_1_OUTPUT;
+    }
+#    endif
+}
+#endif
+
+#if defined(BPIN_AUDIO) && !defined(CPIN_AUDIO)
+ISR(TIMER1_AUDIO_vect) {
+    audio_advance(TIMER_1_PERIOD);
+    if (!synth_is_active()) {
+        stop_output();
+        return;
+    }
+
+    TIMER_1_PERIOD     = timer_period(&synth_channels[0]);
+    TIMER_1_DUTY_CYCLE = timer_duty_cycle(&synth_channels[0], TIMER_1_PERIOD);
+}
+#endif
+
+void play_note(float freq, int vol) {
+    dprintf("audio play note freq=%d vol=%d", (int)freq, vol);
+
+    if (!audio_initialized) {
+        audio_init();
+    }
+
+    if (audio_config.enable) {
+        pause_output();
+        synth_play_note(freq, vol);
+        resume_output();
+    }
+}
+
+void play_notes(float (*np)[][2], uint16_t n_count, bool n_repeat) {
+    if (!audio_initialized) {
+        audio_init();
+    }
+
+    if (audio_config.enable) {
+        pause_output();
+        synth_play_notes(np, n_count, n_repeat);
+        resume_output();
+    }
+}
+
+bool is_audio_on(void) { return (audio_config.enable != 0); }
+
+void audio_toggle(void) {
+    audio_config.enable ^= 1;
+    eeconfig_update_audio(audio_config.raw);
+    if (audio_config.enable) audio_on_user();
+}
+
+void audio_on(void) {
+    audio_config.enable = 1;
+    eeconfig_update_audio(audio_config.raw);
+    audio_on_user();
+    PLAY_SONG(audio_on_song);
+}
+
+void audio_off(void) {
+    PLAY_SONG(audio_off_song);
+    wait_ms(100);
+    stop_all_notes();
+    audio_config.enable = 0;
+    eeconfig_update_audio(audio_config.raw);
+}
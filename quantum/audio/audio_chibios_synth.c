@@ -0,0 +1,332 @@
+/* Copyright 2016 Jack Humbert
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "audio.h"
+#include "synth.h"
+#ifdef AUDIO_MIXER
+#    include "mixer.h"
+#endif
+#include "ch.h"
+#include "hal.h"
+
+#include <string.h>
+#include "print.h"
+#include "keymap.h"
+
+#include "eeconfig.h"
+
+// -----------------------------------------------------------------------------
+
+static bool audio_initialized = false;
+
+audio_config_t audio_config;
+
+#ifndef STARTUP_SONG
+#    define STARTUP_SONG SONG(STARTUP_SOUND)
+#endif
+float startup_song[][2] = STARTUP_SONG;
+
+/* The synth fills a circular buffer which the DACs stream by DMA, one sample
+ * of each channel every time GPT6 overflows. The DAC callback only wakes the
+ * audio thread, which renders the next notes into the half that has just been
+ * played, so the sound keeps going while the main loop is blocked, as in
+ * wait_ms() before a reset. A half lasts AUDIO_DAC_BUFFER_SIZE / 2 /
+ * SYNTH_SAMPLE_RATE seconds, 6.4 ms by default, and the thread has to be done
+ * with it before the other half has been played. */
+#ifndef AUDIO_DAC_BUFFER_SIZE
+#    define AUDIO_DAC_BUFFER_SIZE 256
+#endif
+#ifndef AUDIO_THREAD_PRIORITY
+#    define AUDIO_THREAD_PRIORITY HIGHPRIO
+#endif
+#ifndef DAC_SAMPLE_MAX
+#    define DAC_SAMPLE_MAX 65535U
+#endif
+
+// Larger values would wrap around in the 12 bit DACs, so they play at full volume
+#define DAC_SAMPLE_HIGH SYNTH_DAC_HIGH(DAC_SAMPLE_MAX)
+
+#define GPT6_FREQUENCY 1000000U
+
+static dacsample_t dac_buffer[AUDIO_DAC_BUFFER_SIZE];
+static dacsample_t dac_buffer_2[AUDIO_DAC_BUFFER_SIZE];
+
+static volatile bool output_active = false;
+static uint8_t       silent_halves = 0;
+
+// Offsets of the halves played since the thread last woke up, the first and the second
+static volatile uint8_t   pending_halves = 0;
+static volatile uint16_t  underruns      = 0;
+static thread_reference_t audio_thread   = NULL;
+
+/*
+ * GPT6 configuration.
+ */
+static const GPTConfig gpt6cfg1 = {.frequency = GPT6_FREQUENCY,
+                                   .callback  = NULL,
+                                   .cr2       = TIM_CR2_MMS_1, /* MMS = 010 = TRGO on Update Event.    */
+                                   .dier      = 0U};
+
+static void render(uint16_t offset, uint16_t samples) {
+#ifdef AUDIO_MIXER
+    // Held notes are mixed into A4, and A5 gets the inverse
+    if (mixer_is_active()) {
+        mixer_render((uint16_t *)dac_buffer + offset, samples, DAC_SAMPLE_HIGH);
+        for (uint16_t i = offset; i < offset + samples; i++) {
+            dac_buffer_2[i] = 2 * SYNTH_SILENCE(DAC_SAMPLE_HIGH) - dac_buffer[i];
+        }
+        return;
+    }
+#endif
+    synth_render((uint16_t *)dac_buffer + offset, (uint16_t *)dac_buffer_2 + offset, samples, DAC_SAMPLE_HIGH);
+}
+
+static bool is_active(void) {
+#ifdef AUDIO_MIXER
+    if (mixer_is_active()) {
+        return true;
+    }
+#endif
+    return synth_is_active();
+}
+
+/*
+ * DAC streaming callback, called when the first half and when the whole buffer has been played.
+ */
+static void end_cb1(DACDriver *dacp) {
+    uint8_t half = dacIsBufferComplete(dacp) ? 2 : 1;
+
+    chSysLockFromISR();
+    // The thread has not rendered this half since it was last played, so it plays again
+    if (pending_halves & half) {
+        underruns++;
+    }
+    pending_halves |= half;
+    chThdResumeI(&audio_thread, MSG_OK);
+    chSysUnlockFromISR();
+}
+
+static THD_WORKING_AREA(waAudioThread, 256);
+static THD_FUNCTION(AudioThread, arg) {
+    (void)arg;
+    chRegSetThreadName("audio");
+    while (true) {
+        chSysLock();
+        while (pending_halves == 0) {
+            chThdSuspendS(&audio_thread);
+        }
+        uint8_t halves = pending_halves;
+        pending_halves = 0;
+        chSysUnlock();
+
+        // The main loop changes the notes with the kernel locked and runs at a lower priority, so it can't interrupt a render
+        for (uint8_t half = 1; half <= 2; half++) {
+            if (!(halves & half)) {
+                continue;
+            }
+            if (!audio_config.enable) {
+                synth_stop_all();
+#ifdef AUDIO_MIXER
+                mixer_stop_all();
+#endif
+            }
+            // The other half may still hold the end of the last note, so stop once it has been played too
+            silent_halves = is_active() ? 0 : silent_halves + 1;
+            render(half == 2 ? AUDIO_DAC_BUFFER_SIZE / 2 : 0, AUDIO_DAC_BUFFER_SIZE / 2);
+        }
+        if (silent_halves >= 2) {
+            chSysLock();
+            gptStopTimerI(&GPTD6);
+            dacStopConversionI(&DACD1);
+            dacStopConversionI(&DACD2);
+            pending_halves = 0;
+            output_active  = false;
+            chSysUnlock();
+        }
+    }
+}
+
+uint16_t audio_dac_underruns(void) { return underruns; }
+
+/*
+ * DAC error callback.
+ */
+static void error_cb1(DACDriver *dacp, dacerror_t err) {
+    (void)dacp;
+    (void)err;
+
+    chSysHalt("DAC failure");
+}
+
+static const DACConfig dac1cfg1 = {.init = SYNTH_SILENCE(DAC_SAMPLE_HIGH), .datamode = DAC_DHRM_12BIT_RIGHT};
+
+static const DACConversionGroup dacgrpcfg1 = {.num_channels = 1U, .end_cb = end_cb1, .error_cb = error_cb1, .trigger = DAC_TRG(0)};
+
+static const DACConfig dac1cfg2 = {.init = SYNTH_SILENCE(DAC_SAMPLE_HIGH), .datamode = DAC_DHRM_12BIT_RIGHT};
+
+// Both DACs are triggered by GPT6 and stay in step, so only DAC1 reports the halves
+static const DACConversionGroup dacgrpcfg2 = {.num_channels = 1U, .end_cb = NULL, .error_cb = error_cb1, .trigger = DAC_TRG(0)};
+
+static void start_output(void) {
+    if (output_active) {
+        return;
+    }
+    render(0, AUDIO_DAC_BUFFER_SIZE);
+    silent_halves = 0;
+    output_active = true;
+
+    /*
+     * Starting a continuous conversion, from the start of the buffer.
+     */
+    dacStartConversion(&DACD1, &dacgrpcfg1, dac_buffer, AUDIO_DAC_BUFFER_SIZE);
+    dacStartConversion(&DACD2, &dacgrpcfg2, dac_buffer_2, AUDIO_DAC_BUFFER_SIZE);
+    gptStartContinuous(&GPTD6, GPT6_FREQUENCY / SYNTH_SAMPLE_RATE);
+}
+
+void audio_init() {
+    if (audio_initialized) {
+        return;
+    }
+
+// Check EEPROM
+#ifdef EEPROM_ENABLE
+    if (!eeconfig_is_enabled()) {
+        eeconfig_init();
+    }
+    audio_config.raw = eeconfig_read_audio();
+#else  // ARM EEPROM
+    audio_config.enable        = true;
+#    ifdef AUDIO_CLICKY_ON
+    audio_config.clicky_enable = true;
+#    endif
+#endif  // ARM EEPROM
+
+    /*
+     * Starting DAC1 driver, setting up the output pin as analog as suggested
+     * by the Reference Manual.
+     */
+    palSetPadMode(GPIOA, 4, PAL_MODE_INPUT_ANALOG);
+    palSetPadMode(GPIOA, 5, PAL_MODE_INPUT_ANALOG);
+    dacStart(&DACD1, &dac1cfg1);
+    dacStart(&DACD2, &dac1cfg2);
+
+    /*
+     * Starting GPT6 driver, it is used for triggering the DAC. The timer only
+     * runs while something is playing.
+     */
+    gptStart(&GPTD6, &gpt6cfg1);
+
+    chThdCreateStatic(waAudioThread, sizeof(waAudioThread), AUDIO_THREAD_PRIORITY, AudioThread, NULL);
+
+    audio_initialized = true;
+
+    if (audio_config.enable) {
+        PLAY_SONG(startup_song);
+    } else {
+        stop_all_notes();
+    }
+}
+
+void stop_all_notes() {
+    dprintf("audio stop all notes");
+
+    if (!audio_initialized) {
+        audio_init();
+    }
+    // The audio thread renders the synth, so it is locked out while the notes change
+    chSysLock();
+    synth_stop_all();
+#ifdef AUDIO_MIXER
+    mixer_stop_all();
+#endif
+    chSysUnlock();
+}
+
+void stop_note(float freq) {
+    dprintf("audio stop note freq=%d", (int)freq);
+
+    if (!audio_initialized) {
+        audio_init();
+    }
+    chSysLock();
+#ifdef AUDIO_MIXER
+    mixer_note_off(SYNTH_HZ(freq));
+#else
+    synth_stop_note(freq);
+#endif
+    chSysUnlock();
+}
+
+void play_note(float freq, int vol) {
+    dprintf("audio play note freq=%d vol=%d", (int)freq, vol);
+
+    if (!audio_initialized) {
+        audio_init();
+    }
+
+    if (audio_config.enable) {
+        chSysLock();
+#ifdef AUDIO_MIXER
+        // Cancel notes if notes are playing
+        if (is_playing_notes()) {
+            synth_stop_all();
+        }
+        mixer_note_on(SYNTH_HZ(freq), vol);
+#else
+        synth_play_note(freq, vol);
+#endif
+        chSysUnlock();
+        start_output();
+    }
+}
+
+void play_notes(float (*np)[][2], uint16_t n_count, bool n_repeat) {
+    if (!audio_initialized) {
+        audio_init();
+    }
+
+    if (audio_config.enable) {
+        chSysLock();
+#ifdef AUDIO_MIXER
+        mixer_stop_all();
+#endif
+        synth_play_notes(np, n_count, n_repeat);
+        chSysUnlock();
+        start_output();
+    }
+}
+
+bool is_audio_on(void) { return (audio_config.enable != 0); }
+
+void audio_toggle(void) {
+    audio_config.enable ^= 1;
+    eeconfig_update_audio(audio_config.raw);
+    if (audio_config.enable) {
+        audio_on_user();
+    }
+}
+
+void audio_on(void) {
+    audio_config.enable = 1;
+    eeconfig_update_audio(audio_config.raw);
+    audio_on_user();
+}
+
+void audio_off(void) {
+    stop_all_notes();
+    audio_config.enable = 0;
+    eeconfig_update_audio(audio_config.raw);
+}
@@ -18,9 +18,11 @@
 #    include <avr/io.h>
 #    include <avr/interrupt.h>
 #    include <avr/pgmspace.h>
-#else
+#elif defined(PROTOCOL_CHIBIOS)
 #    include "ch.h"
 #    include "hal.h"
+#else
+#    include <stdint.h>
 #endif
 
 #ifndef LUTS_H
@@ -30,7 +32,21 @@
 
 #    define FREQUENCY_LUT_LENGTH 349
 
-extern const float    vibrato_lut[VIBRATO_LUT_LENGTH];
+#    ifdef AUDIO_SYNTH_ENABLE
+// Covers 0 to 1024 Hz in steps of 32 Hz, above that the glissando step barely changes
+#        define GLISSANDO_LUT_LENGTH 32
+#        define GLISSANDO_LUT_SHIFT (5 + 16)
+
+// Deviation from the average frequency, in 1/65536
+extern const int16_t vibrato_lut[VIBRATO_LUT_LENGTH];
+#    else
+extern const float vibrato_lut[VIBRATO_LUT_LENGTH];
+#    endif
 extern const uint16_t frequency_lut[FREQUENCY_LUT_LENGTH];
+#    ifdef AUDIO_SYNTH_ENABLE
+// One glissando step of f * 2^(+-440 / f / 24) - f, in 1/256 Hz, looked up with (f >> GLISSANDO_LUT_SHIFT) for f in 1/65536 Hz
+extern const uint16_t glissando_up_lut[GLISSANDO_LUT_LENGTH];
+extern const uint16_t glissando_down_lut[GLISSANDO_LUT_LENGTH];
+#    endif
 
 #endif /* LUTS_H */
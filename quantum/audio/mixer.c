@@ -0,0 +1,232 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include "mixer.h"
+#include "wave.h"
+
+#define SAMPLES_PER_TICK (SYNTH_SAMPLE_RATE / SYNTH_TICK_RATE)
+#define SINE_SHIFT (32 - 11)
+#define FULL_LEVEL (65535 / MIXER_HEADROOM)
+
+typedef enum {
+    STAGE_OFF,
+    STAGE_ATTACK,
+    STAGE_DECAY,
+    STAGE_SUSTAIN,
+    STAGE_RELEASE,
+} stage_t;
+
+typedef struct {
+    uint32_t frequency;
+    uint32_t phase;
+    uint32_t increment;
+    uint16_t level;  // in 1/65536 of full scale
+    uint16_t peak;
+    uint16_t step;  // level change per tick in the current stage
+    uint16_t serial;
+    stage_t  stage;
+} voice_t;
+
+_Static_assert(SINE_LENGTH == 1 << (32 - SINE_SHIFT), "sinewave must have 2048 entries");
+
+static voice_t          voices[MIXER_VOICES];
+static uint16_t         next_serial      = 0;
+static uint16_t         render_countdown = 0;
+static mixer_waveform_t waveform         = MIXER_SINE;
+static mixer_envelope_t envelope         = {.attack = 5, .decay = 60, .sustain = 49152, .release = 80};
+
+void mixer_set_waveform(mixer_waveform_t new_waveform) { waveform = new_waveform; }
+
+void mixer_set_envelope(const mixer_envelope_t *new_envelope) { envelope = *new_envelope; }
+
+// Level change per tick to get from one level to another in the given ticks
+static uint16_t ramp(uint16_t from, uint16_t to, uint16_t ticks) {
+    uint16_t distance = from > to ? from - to : to - from;
+    if (ticks == 0) {
+        return distance;
+    }
+    return distance / ticks > 0 ? distance / ticks : 1;
+}
+
+static uint16_t sustain_level(const voice_t *voice) { return (uint32_t)voice->peak * envelope.sustain >> 16; }
+
+static void start_stage(voice_t *voice, stage_t stage) {
+    voice->stage = stage;
+    switch (stage) {
+        case STAGE_ATTACK:
+            voice->step = ramp(voice->level, voice->peak, envelope.attack);
+            break;
+        case STAGE_DECAY:
+            voice->step = ramp(voice->peak, sustain_level(voice), envelope.decay);
+            break;
+        case STAGE_RELEASE:
+            voice->step = ramp(voice->level, 0, envelope.release);
+            break;
+        default:
+            voice->step = 0;
+            break;
+    }
+}
+
+static void envelope_tick(voice_t *voice) {
+    switch (voice->stage) {
+        case STAGE_ATTACK:
+            if (voice->peak - voice->level > voice->step) {
+                voice->level += voice->step;
+            } else {
+                voice->level = voice->peak;
+                start_stage(voice, STAGE_DECAY);
+            }
+            break;
+        case STAGE_DECAY:
+            if (voice->level - sustain_level(voice) > voice->step) {
+                voice->level -= voice->step;
+            } else {
+                voice->level = sustain_level(voice);
+                start_stage(voice, STAGE_SUSTAIN);
+            }
+            break;
+        case STAGE_RELEASE:
+            if (voice->level > voice->step) {
+                voice->level -= voice->step;
+            } else {
+                voice->level = 0;
+                start_stage(voice, STAGE_OFF);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// A free voice, else the quietest one being released, else the oldest
+static voice_t *allocate_voice(void) {
+    voice_t *releasing = NULL;
+    voice_t *oldest    = &voices[0];
+    for (uint8_t i = 0; i < MIXER_VOICES; i++) {
+        voice_t *voice = &voices[i];
+        if (voice->stage == STAGE_OFF) {
+            return voice;
+        }
+        if (voice->stage == STAGE_RELEASE && (!releasing || voice->level < releasing->level)) {
+            releasing = voice;
+        }
+        if ((uint16_t)(next_serial - voice->serial) > (uint16_t)(next_serial - oldest->serial)) {
+            oldest = voice;
+        }
+    }
+    return releasing ? releasing : oldest;
+}
+
+static voice_t *find_voice(uint32_t frequency) {
+    for (uint8_t i = 0; i < MIXER_VOICES; i++) {
+        if (voices[i].frequency == frequency && voices[i].stage != STAGE_OFF && voices[i].stage != STAGE_RELEASE) {
+            return &voices[i];
+        }
+    }
+    return NULL;
+}
+
+void mixer_note_on(uint32_t frequency, uint8_t volume) {
+    if (frequency == 0) {
+        return;
+    }
+    voice_t *voice = find_voice(frequency);
+    if (!voice) {
+        voice = allocate_voice();
+        // a stolen voice keeps its level and phase, so it does not click
+        if (voice->stage == STAGE_OFF) {
+            voice->phase = 0;
+            voice->level = 0;
+        }
+        voice->frequency = frequency;
+        voice->increment = SYNTH_PHASE_INCREMENT(frequency);
+    }
+    voice->peak   = (uint32_t)FULL_LEVEL * (volume > 15 ? 15 : volume) / 15;
+    voice->serial = next_serial++;
+    start_stage(voice, voice->level > voice->peak ? STAGE_DECAY : STAGE_ATTACK);
+}
+
+void mixer_note_off(uint32_t frequency) {
+    voice_t *voice = find_voice(frequency);
+    if (voice) {
+        start_stage(voice, STAGE_RELEASE);
+    }
+}
+
+void mixer_stop_all(void) {
+    for (uint8_t i = 0; i < MIXER_VOICES; i++) {
+        voices[i].level = 0;
+        start_stage(&voices[i], STAGE_OFF);
+    }
+    render_countdown = 0;
+}
+
+bool mixer_is_active(void) {
+    for (uint8_t i = 0; i < MIXER_VOICES; i++) {
+        if (voices[i].stage != STAGE_OFF) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool mixer_is_playing(uint32_t frequency) { return find_voice(frequency) != NULL; }
+
+// One period of the waveform from -32767 to 32767
+static int16_t wave(uint32_t phase) {
+    switch (waveform) {
+        case MIXER_SQUARE:
+            return phase < 0x80000000 ? 32767 : -32767;
+        case MIXER_TRIANGLE: {
+            uint16_t rise = phase >> 16;
+            return (int32_t)(rise < 0x8000 ? rise : 0xFFFF - rise) * 2 - 32767;
+        }
+        default:
+            return ((int16_t)pgm_read_byte(&sinewave[phase >> SINE_SHIFT]) - 128) * 256;
+    }
+}
+
+void mixer_render(uint16_t *samples, uint16_t count, uint16_t high) {
+    int32_t half = SYNTH_SILENCE(high);
+
+    for (uint16_t i = 0; i < count; i++) {
+        if (render_countdown == 0) {
+            for (uint8_t v = 0; v < MIXER_VOICES; v++) {
+                envelope_tick(&voices[v]);
+            }
+            render_countdown = SAMPLES_PER_TICK;
+        }
+        render_countdown--;
+
+        int32_t mix = 0;
+        for (uint8_t v = 0; v < MIXER_VOICES; v++) {
+            voice_t *voice = &voices[v];
+            if (voice->stage != STAGE_OFF) {
+                voice->phase += voice->increment;
+                mix += (int32_t)wave(voice->phase) * voice->level >> 16;
+            }
+        }
+
+        if (mix > 32767) {
+            mix = 32767;
+        } else if (mix < -32767) {
+            mix = -32767;
+        }
+        samples[i] = half + (mix * half >> 15);
+    }
+}
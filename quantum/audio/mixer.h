@@ -0,0 +1,71 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "synth.h"
+
+/* Plays held notes as a chord: every voice reads its own waveform at its own
+ * phase, and the voices are summed into one sample at SYNTH_SAMPLE_RATE.
+ *
+ * Each voice has an attack, decay, sustain and release envelope that moves
+ * once per SYNTH_TICK_RATE. When all voices are busy a new note takes over
+ * the quietest voice that is being released, or else the oldest one. The
+ * cost of a sample is bounded by MIXER_VOICES, since only that many are ever
+ * mixed, with one table lookup and one multiply each.
+ */
+
+// Notes that sound at the same time
+#ifndef MIXER_VOICES
+#    define MIXER_VOICES 6
+#endif
+
+// Voices at full volume that fit in the output before the sum is clipped
+#ifndef MIXER_HEADROOM
+#    define MIXER_HEADROOM 3
+#endif
+
+typedef enum {
+    MIXER_SQUARE,
+    MIXER_TRIANGLE,
+    MIXER_SINE,
+} mixer_waveform_t;
+
+typedef struct {
+    uint16_t attack;   // ticks from silence to the peak
+    uint16_t decay;    // ticks from the peak to the sustain level
+    uint16_t sustain;  // level held while the note is, in 1/65536 of the peak
+    uint16_t release;  // ticks from the sustain level to silence
+} mixer_envelope_t;
+
+void mixer_set_waveform(mixer_waveform_t waveform);
+void mixer_set_envelope(const mixer_envelope_t *envelope);
+
+/** \brief Starts a note, frequency in 1/65536 Hz and volume from 0 to 15 */
+void mixer_note_on(uint32_t frequency, uint8_t volume);
+/** \brief Releases a note started with the same frequency */
+void mixer_note_off(uint32_t frequency);
+/** \brief Silences every voice right away */
+void mixer_stop_all(void);
+
+/** \brief Whether a note is held or still being released */
+bool mixer_is_active(void);
+bool mixer_is_playing(uint32_t frequency);
+
+/** \brief Renders samples from 0 to high, silence being SYNTH_SILENCE(high) */
+void mixer_render(uint16_t *samples, uint16_t count, uint16_t high);
@@ -0,0 +1,359 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synth.h"
+#include "musical_notes.h"
+#include "voices.h"
+#include "luts.h"
+
+#if SYNTH_SAMPLE_RATE % SYNTH_TICK_RATE != 0
+#    error "SYNTH_SAMPLE_RATE must be a multiple of SYNTH_TICK_RATE"
+#endif
+
+#define SAMPLES_PER_TICK (SYNTH_SAMPLE_RATE / SYNTH_TICK_RATE)
+
+synth_channel_t synth_channels[SYNTH_CHANNELS];
+
+static uint32_t frequencies[SYNTH_MAX_VOICES];
+static uint8_t  voices        = 0;
+static uint8_t  voice_place   = 0;
+static uint32_t frequency     = 0;
+static uint32_t frequency_alt = 0;
+static uint16_t place         = 0;
+
+static bool     playing_notes  = false;
+static bool     playing_note   = false;
+static uint32_t note_frequency = 0;
+static uint16_t note_length    = 0;
+static uint16_t note_position  = 0;
+static float (*notes_pointer)[][2];
+static uint16_t notes_count;
+static bool     notes_repeat;
+static bool     note_resting = false;
+static uint16_t current_note = 0;
+
+uint8_t note_tempo = TEMPO_DEFAULT;
+
+// these are also set by the voices
+uint16_t note_timbre    = SYNTH_DUTY(TIMBRE_DEFAULT);
+uint16_t polyphony_rate = 0;  // in 1/256 Hz
+uint16_t envelope_index = 0;
+bool     glissando      = true;
+
+#ifdef VIBRATO_ENABLE
+static uint16_t vibrato_counter  = 0;    // position in vibrato_lut, in 1/256
+static uint16_t vibrato_strength = 128;  // in 1/256
+static uint16_t vibrato_rate     = 32;   // in 1/256
+#endif
+
+static uint32_t phases[SYNTH_CHANNELS];
+static uint32_t phase_increments[SYNTH_CHANNELS];
+static uint32_t phase_thresholds[SYNTH_CHANNELS];
+static bool     mirror           = false;
+static uint16_t render_countdown = 0;
+
+static uint32_t note_frequency_of(uint16_t index) {
+    uint32_t freq = SYNTH_HZ((*notes_pointer)[index][0]);
+    // NOTE_REST is not 0 on every platform
+    return freq < SYNTH_MIN_FREQUENCY ? 0 : freq;
+}
+
+static void load_note(uint16_t index) {
+    envelope_index = 0;
+    note_frequency = note_frequency_of(index);
+    note_length    = SYNTH_DURATION_TICKS((*notes_pointer)[index][1], note_tempo);
+    note_position  = 0;
+}
+
+// Slides from one frequency towards another by a quarter tone per tick at 440 Hz, more for lower notes
+static uint32_t glide(uint32_t from, uint32_t to) {
+    if (from == 0 || from == to) {
+        return to;
+    }
+    if (from < to) {
+        uint32_t step = (uint32_t)glissando_up_lut[from >> GLISSANDO_LUT_SHIFT < GLISSANDO_LUT_LENGTH ? from >> GLISSANDO_LUT_SHIFT : GLISSANDO_LUT_LENGTH - 1] << 8;
+        return from + step < to ? from + step : to;
+    }
+    uint32_t step = (uint32_t)glissando_down_lut[from >> GLISSANDO_LUT_SHIFT < GLISSANDO_LUT_LENGTH ? from >> GLISSANDO_LUT_SHIFT : GLISSANDO_LUT_LENGTH - 1] << 8;
+    return from > to + step ? from - step : to;
+}
+
+static uint32_t vibrato(uint32_t average_freq) {
+#ifdef VIBRATO_ENABLE
+    if (vibrato_strength > 0 && average_freq >= SYNTH_HZ(1)) {
+        int16_t deviation = vibrato_lut[vibrato_counter >> 8];
+#    ifdef VIBRATO_STRENGTH_ENABLE
+        deviation = (int32_t)deviation * vibrato_strength >> 8;
+#    endif
+        // faster for lower notes, like the float version did with rate * (1 + 440 / f)
+        vibrato_counter = (vibrato_counter + vibrato_rate + (uint32_t)vibrato_rate * 440 / (average_freq >> 16)) % (VIBRATO_LUT_LENGTH << 8);
+        return synth_detune(average_freq, deviation);
+    }
+#endif
+    return average_freq;
+}
+
+static void set_channel(uint8_t channel, uint32_t freq) {
+    if (freq > 0) {
+        freq = voice_envelope(freq);
+    }
+    if (freq > 0 && freq < SYNTH_MIN_FREQUENCY) {
+        freq = SYNTH_MIN_FREQUENCY;
+    }
+    synth_channels[channel].frequency = freq;
+    synth_channels[channel].duty      = note_timbre;
+}
+
+static void silence(void) {
+    for (uint8_t i = 0; i < SYNTH_CHANNELS; i++) {
+        synth_channels[i].frequency = 0;
+    }
+}
+
+void synth_tick(void) {
+    if (!playing_note && !playing_notes) {
+        silence();
+        return;
+    }
+
+    if (envelope_index < 65535) {
+        envelope_index++;
+    }
+
+    if (playing_note) {
+        if (voices == 0) {
+            silence();
+            return;
+        }
+
+        if (voices > 1 && polyphony_rate == 0) {
+            frequency_alt = glissando ? glide(frequency_alt, frequencies[voices - 2]) : frequencies[voices - 2];
+            set_channel(1, vibrato(frequency_alt));
+        } else {
+            synth_channels[1].frequency = 0;
+        }
+
+        uint32_t freq;
+        if (polyphony_rate > 0) {
+            if (voices > 1) {
+                voice_place %= voices;
+                if ((uint32_t)place++ * polyphony_rate > frequencies[voice_place] >> 8) {
+                    voice_place = (voice_place + 1) % voices;
+                    place       = 0;
+                }
+            }
+            freq = frequencies[voice_place];
+        } else {
+            frequency = glissando ? glide(frequency, frequencies[voices - 1]) : frequencies[voices - 1];
+            freq      = frequency;
+        }
+        set_channel(0, vibrato(freq));
+    }
+
+    if (playing_notes) {
+        set_channel(0, vibrato(note_frequency));
+        synth_channels[1].frequency = 0;
+
+        if (++note_position < note_length) {
+            return;
+        }
+
+        uint16_t next_note = current_note + 1;
+        if (next_note >= notes_count) {
+            if (!notes_repeat) {
+                playing_notes = false;
+                return;
+            }
+            next_note = 0;
+        }
+
+        if (!note_resting) {
+            // the note keeps sounding into the rest, unless the next one has the same pitch
+            note_resting = true;
+            if (note_frequency_of(next_note) == note_frequency) {
+                note_frequency = 0;
+            }
+            note_length   = SYNTH_REST_TICKS;
+            note_position = 0;
+        } else {
+            note_resting = false;
+            current_note = next_note;
+            load_note(current_note);
+        }
+    }
+}
+
+void synth_render(uint16_t *channel_1, uint16_t *channel_2, uint16_t samples, uint16_t high) {
+    uint16_t silence = SYNTH_SILENCE(high);
+
+    for (uint16_t i = 0; i < samples; i++) {
+        if (render_countdown == 0) {
+            synth_tick();
+            for (uint8_t c = 0; c < SYNTH_CHANNELS; c++) {
+                phase_increments[c] = SYNTH_PHASE_INCREMENT(synth_channels[c].frequency);
+                phase_thresholds[c] = synth_channels[c].frequency ? (uint32_t)synth_channels[c].duty << 16 : 0;
+            }
+            mirror           = synth_channels[1].frequency == 0 && phase_thresholds[0] != 0;
+            render_countdown = SAMPLES_PER_TICK;
+        }
+        render_countdown--;
+
+        phases[0] += phase_increments[0];
+        if (mirror) {
+            channel_1[i] = phases[0] < phase_thresholds[0] ? high : 0;
+            channel_2[i] = high - channel_1[i];
+        } else {
+            phases[1] += phase_increments[1];
+            channel_1[i] = phase_thresholds[0] == 0 ? silence : phases[0] < phase_thresholds[0] ? high : 0;
+            channel_2[i] = phase_thresholds[1] == 0 ? silence : phases[1] < phase_thresholds[1] ? high : 0;
+        }
+    }
+}
+
+void synth_play_note(float freq, int vol) {
+    if (voices >= SYNTH_MAX_VOICES) {
+        return;
+    }
+
+    // Cancel notes if notes are playing
+    if (playing_notes) {
+        synth_stop_all();
+    }
+
+    playing_note   = true;
+    envelope_index = 0;
+
+    if (freq > 0) {
+        frequencies[voices++] = SYNTH_HZ(freq);
+    }
+}
+
+void synth_stop_note(float freq) {
+    if (!playing_note) {
+        return;
+    }
+
+    uint32_t stopped = SYNTH_HZ(freq);
+    for (int8_t i = voices - 1; i >= 0; i--) {
+        if (frequencies[i] == stopped) {
+            for (uint8_t j = i; j + 1 < voices; j++) {
+                frequencies[j] = frequencies[j + 1];
+            }
+            voices--;
+            break;
+        }
+    }
+    if (voice_place >= voices) {
+        voice_place = 0;
+    }
+    if (voices == 0) {
+        frequency     = 0;
+        frequency_alt = 0;
+        playing_note  = false;
+        silence();
+    }
+}
+
+void synth_play_notes(float (*np)[][2], uint16_t n_count, bool n_repeat) {
+    // Cancel note if a note is playing
+    if (playing_note) {
+        synth_stop_all();
+    }
+
+    playing_notes = n_count > 0;
+    notes_pointer = np;
+    notes_count   = n_count;
+    notes_repeat  = n_repeat;
+    note_resting  = false;
+    place         = 0;
+    current_note  = 0;
+
+    if (playing_notes) {
+        load_note(current_note);
+    }
+}
+
+void synth_stop_all(void) {
+    voices        = 0;
+    voice_place   = 0;
+    playing_notes = false;
+    playing_note  = false;
+    frequency     = 0;
+    frequency_alt = 0;
+    silence();
+
+    // the next notes start a new waveform right away
+    for (uint8_t i = 0; i < SYNTH_CHANNELS; i++) {
+        phases[i] = 0;
+    }
+    render_countdown = 0;
+}
+
+bool synth_is_active(void) { return playing_note || playing_notes; }
+
+bool is_playing_notes(void) { return playing_notes; }
+
+#ifdef VIBRATO_ENABLE
+
+// Vibrato rate functions
+
+void set_vibrato_rate(float rate) { vibrato_rate = rate * 256; }
+
+void increase_vibrato_rate(float change) { vibrato_rate *= change; }
+
+void decrease_vibrato_rate(float change) { vibrato_rate /= change; }
+
+#    ifdef VIBRATO_STRENGTH_ENABLE
+
+void set_vibrato_strength(float strength) { vibrato_strength = strength * 256; }
+
+void increase_vibrato_strength(float change) { vibrato_strength *= change; }
+
+void decrease_vibrato_strength(float change) { vibrato_strength /= change; }
+
+#    endif /* VIBRATO_STRENGTH_ENABLE */
+
+#endif /* VIBRATO_ENABLE */
+
+// Polyphony functions
+
+void set_polyphony_rate(float rate) { polyphony_rate = rate * 256; }
+
+void enable_polyphony(void) { polyphony_rate = 5 * 256; }
+
+void disable_polyphony(void) { polyphony_rate = 0; }
+
+void increase_polyphony_rate(float change) { polyphony_rate *= change; }
+
+void decrease_polyphony_rate(float change) { polyphony_rate /= change; }
+
+// Timbre function
+
+void set_timbre(float timbre) { note_timbre = SYNTH_DUTY(timbre); }
+
+// Tempo functions
+
+void set_tempo(uint8_t tempo) { note_tempo = tempo; }
+
+void decrease_tempo(uint8_t tempo_change) { note_tempo += tempo_change; }
+
+void increase_tempo(uint8_t tempo_change) {
+    if (note_tempo - tempo_change < 10) {
+        note_tempo = 10;
+    } else {
+        note_tempo -= tempo_change;
+    }
+}
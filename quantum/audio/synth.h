@@ -0,0 +1,101 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* The note sequencer, glissando, vibrato, polyphony and voices shared by the
+ * audio drivers, in integer math only.
+ *
+ * Frequencies are in 1/65536 Hz and duty cycles in 1/65536 of the period. The
+ * float arguments of the audio API are converted once, when a note starts.
+ * synth_tick() advances everything by one control step and leaves the result
+ * in synth_channels, which a driver either turns into timer periods, or hands
+ * to synth_render() to get a square wave at SYNTH_SAMPLE_RATE.
+ */
+
+// Control steps per second
+#ifndef SYNTH_TICK_RATE
+#    define SYNTH_TICK_RATE 1000
+#endif
+
+// Samples per second written by synth_render(), a multiple of SYNTH_TICK_RATE
+#ifndef SYNTH_SAMPLE_RATE
+#    define SYNTH_SAMPLE_RATE 20000
+#endif
+
+// Notes held at the same time with play_note()
+#ifndef SYNTH_MAX_VOICES
+#    define SYNTH_MAX_VOICES 8
+#endif
+
+// Silence between two song notes of the same pitch
+#ifndef SYNTH_REST_TICKS
+#    define SYNTH_REST_TICKS (SYNTH_TICK_RATE / 100)
+#endif
+
+#define SYNTH_CHANNELS 2
+
+// The DACs take 12 bit samples aligned right, so a render for them must not go above this
+#define SYNTH_DAC_MAX 4095U
+#define SYNTH_DAC_HIGH(high) ((high) < SYNTH_DAC_MAX ? (high) : SYNTH_DAC_MAX)
+// Silent output of both the synth and the mixer, so switching between them or stopping doesn't click
+#define SYNTH_SILENCE(high) ((high) / 2)
+
+#define SYNTH_HZ(f) ((uint32_t)((f)*65536))
+#define SYNTH_DUTY(t) ((uint16_t)((t)*65535))
+
+// Step of a 32 bit phase accumulator per sample, for a frequency in 1/65536 Hz
+#define SYNTH_PHASE_INCREMENT(frequency) ((uint32_t)(((uint64_t)(frequency) * (((uint64_t)1 << 40) / SYNTH_SAMPLE_RATE)) >> 24))
+
+// Lower notes are played at this frequency, which keeps a 16 bit timer period at F_CPU / 8 in range
+#define SYNTH_MIN_FREQUENCY SYNTH_HZ(30.52)
+
+// A note of duration 1 lasts 8 ms at TEMPO_DEFAULT, a QUARTER_NOTE 128 ms
+#define SYNTH_DURATION_TICKS(duration, tempo) ((uint32_t)(duration) * (tempo)*SYNTH_TICK_RATE / 12500)
+
+typedef struct {
+    uint32_t frequency;  // 0 when silent
+    uint16_t duty;
+} synth_channel_t;
+
+/* What to play until the next tick. Channel 1 plays the last note held or the
+ * song, channel 2 the note held before it. */
+extern synth_channel_t synth_channels[SYNTH_CHANNELS];
+
+/** \brief Moves frequency by the deviation, in 1/65536, of a vibrato_lut entry */
+static inline uint32_t synth_detune(uint32_t frequency, int16_t deviation) { return frequency + (((int32_t)(frequency >> 10) * deviation) >> 6); }
+
+void synth_play_note(float freq, int vol);
+void synth_stop_note(float freq);
+void synth_play_notes(float (*np)[][2], uint16_t n_count, bool n_repeat);
+void synth_stop_all(void);
+
+/** \brief Whether a note is held or a song is playing */
+bool synth_is_active(void);
+
+void synth_tick(void);
+
+/** \brief Renders samples of both channels, calling synth_tick() on the way
+ *
+ * Samples are either 0 or high, and SYNTH_SILENCE(high) while a channel has
+ * nothing to play. While channel 2 has nothing to play it gets
+ * the inverse of channel 1, so a speaker between both outputs is driven from
+ * both ends.
+ */
+void synth_render(uint16_t *channel_1, uint16_t *channel_2, uint16_t samples, uint16_t high);
@@ -24,7 +24,12 @@
 #ifndef VOICES_H
 #    define VOICES_H
 
+#    ifdef AUDIO_SYNTH_ENABLE
+// Frequencies are in 1/65536 Hz, see synth.h
+uint32_t voice_envelope(uint32_t frequency);
+#    else
 float voice_envelope(float frequency);
+#    endif
 
 typedef enum {
     default_voice,
@@ -14,9 +14,10 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <avr/io.h>
-#include <avr/interrupt.h>
-#include <avr/pgmspace.h>
+#pragma once
+
+#include <stdint.h>
+#include "progmem.h"
 
 #define SINE_LENGTH 2048
 
@@ -18,71 +18,50 @@
 #include "led_tables.h"
 #include "progmem.h"
 
+/* Which of v, p, q and t each channel takes in the six hue segments, two bits per channel */
+enum { SEG_V, SEG_P, SEG_Q, SEG_T };
+#define HUE_SEGMENT(r, g, b) ((r) | (g) << 2 | (b) << 4)
+static const uint8_t hue_segments[7] = {
+    HUE_SEGMENT(SEG_V, SEG_T, SEG_P),  // red to yellow
+    HUE_SEGMENT(SEG_Q, SEG_V, SEG_P),  // yellow to green
+    HUE_SEGMENT(SEG_P, SEG_V, SEG_T),  // green to cyan
+    HUE_SEGMENT(SEG_P, SEG_Q, SEG_V),  // cyan to blue
+    HUE_SEGMENT(SEG_T, SEG_P, SEG_V),  // blue to magenta
+    HUE_SEGMENT(SEG_V, SEG_P, SEG_Q),  // magenta to red
+    HUE_SEGMENT(SEG_V, SEG_T, SEG_P),  // hue 255 is red again
+};
+
 RGB hsv_to_rgb(HSV hsv) {
-    RGB      rgb;
-    uint8_t  region, remainder, p, q, t;
-    uint16_t h, s, v;
+    RGB     rgb;
+    uint8_t value[4];
 
-    if (hsv.s == 0) {
 #ifdef USE_CIE1931_CURVE
-        rgb.r = rgb.g = rgb.b = pgm_read_byte(&CIE1931_CURVE[hsv.v]);
+    uint16_t v = pgm_read_byte(&CIE1931_CURVE[hsv.v]);
 #else
-        rgb.r = hsv.v;
-        rgb.g = hsv.v;
-        rgb.b = hsv.v;
+    uint16_t v = hsv.v;
 #endif
+    uint16_t s = hsv.s;
+
+    if (s == 0) {
+        rgb.r = v;
+        rgb.g = v;
+        rgb.b = v;
         return rgb;
     }
 
-    h = hsv.h;
-    s = hsv.s;
-#ifdef USE_CIE1931_CURVE
-    v = pgm_read_byte(&CIE1931_CURVE[hsv.v]);
-#else
-    v = hsv.v;
-#endif
-
-    region    = h * 6 / 255;
-    remainder = (h * 2 - region * 85) * 3;
+    uint16_t h6        = hsv.h * 6;
+    uint8_t  region    = (h6 + 1 + (h6 >> 8)) >> 8;  // h * 6 / 255 without a divide
+    uint8_t  remainder = (hsv.h * 2 - region * 85) * 3;
 
-    p = (v * (255 - s)) >> 8;
-    q = (v * (255 - ((s * remainder) >> 8))) >> 8;
-    t = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
-
-    switch (region) {
-        case 6:
-        case 0:
-            rgb.r = v;
-            rgb.g = t;
-            rgb.b = p;
-            break;
-        case 1:
-            rgb.r = q;
-            rgb.g = v;
-            rgb.b = p;
-            break;
-        case 2:
-            rgb.r = p;
-            rgb.g = v;
-            rgb.b = t;
-            break;
-        case 3:
-            rgb.r = p;
-            rgb.g = q;
-            rgb.b = v;
-            break;
-        case 4:
-            rgb.r = t;
-            rgb.g = p;
-            rgb.b = v;
-            break;
-        default:
-            rgb.r = v;
-            rgb.g = p;
-            rgb.b = q;
-            break;
-    }
+    value[SEG_V] = v;
+    value[SEG_P] = (v * (255 - s)) >> 8;
+    value[SEG_Q] = (v * (255 - ((s * remainder) >> 8))) >> 8;
+    value[SEG_T] = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
 
+    uint8_t segment = hue_segments[region];
+    rgb.r           = value[segment & 3];
+    rgb.g           = value[(segment >> 2) & 3];
+    rgb.b           = value[segment >> 4];
     return rgb;
 }
 
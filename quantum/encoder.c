@@ -38,28 +38,39 @@ static pin_t encoders_pad_b[] = ENCODERS_PAD_B;
 #ifndef ENCODER_DIRECTION_FLIP
 #    define ENCODER_CLOCKWISE true
 #    define ENCODER_COUNTER_CLOCKWISE false
+#    define ENCODER_CLOCKWISE_SIGN -1
 #else
 #    define ENCODER_CLOCKWISE false
 #    define ENCODER_COUNTER_CLOCKWISE true
+#    define ENCODER_CLOCKWISE_SIGN 1
 #endif
 static int8_t encoder_LUT[] = {0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1, 0};
 
+/* Sampler state, only touched by encoder_sample() once the encoders are set up */
 static uint8_t encoder_state[NUMBER_OF_ENCODERS]  = {0};
 static int8_t  encoder_pulses[NUMBER_OF_ENCODERS] = {0};
+static uint8_t encoder_count[NUMBER_OF_ENCODERS]  = {0};
 
+/* Detents already reported, which split halves exchange */
 #ifdef SPLIT_KEYBOARD
 // right half encoders come over as second set of encoders
-static uint8_t encoder_value[NUMBER_OF_ENCODERS * 2] = {0};
+static uint8_t  encoder_value[NUMBER_OF_ENCODERS * 2]     = {0};
+static uint16_t encoder_step_time[NUMBER_OF_ENCODERS * 2] = {0};
 // row offsets for each hand
 static uint8_t thisHand, thatHand;
 #else
-static uint8_t encoder_value[NUMBER_OF_ENCODERS] = {0};
+static uint8_t  encoder_value[NUMBER_OF_ENCODERS]     = {0};
+static uint16_t encoder_step_time[NUMBER_OF_ENCODERS] = {0};
 #endif
 
 __attribute__((weak)) void encoder_update_user(int8_t index, bool clockwise) {}
 
 __attribute__((weak)) void encoder_update_kb(int8_t index, bool clockwise) { encoder_update_user(index, clockwise); }
 
+__attribute__((weak)) bool encoder_update_steps_user(int8_t index, int8_t steps, uint16_t velocity) { return true; }
+
+__attribute__((weak)) bool encoder_update_steps_kb(int8_t index, int8_t steps, uint16_t velocity) { return encoder_update_steps_user(index, steps, velocity); }
+
 void encoder_init(void) {
 #if defined(SPLIT_KEYBOARD) && defined(ENCODERS_PAD_A_RIGHT) && defined(ENCODERS_PAD_B_RIGHT)
     if (!isLeftHand) {
@@ -85,28 +96,69 @@ void encoder_init(void) {
 #endif
 }
 
-static void encoder_update(int8_t index, uint8_t state) {
-    uint8_t i = index;
-#ifdef SPLIT_KEYBOARD
-    index += thisHand;
-#endif
-    encoder_pulses[i] += encoder_LUT[state & 0xF];
-    if (encoder_pulses[i] >= ENCODER_RESOLUTION) {
-        encoder_value[index]++;
-        encoder_update_kb(index, ENCODER_COUNTER_CLOCKWISE);
+/** \brief Reads the encoder pins and counts the detents
+ *
+ * Called by encoder_read(), or with ENCODER_INTERRUPT_SAMPLING from a pin
+ * change interrupt or a fast timer, so that quick turns are seen edge by edge
+ * however long the main loop takes. Only one context may call it.
+ */
+void encoder_sample(void) {
+    for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
+        encoder_state[i] <<= 2;
+        encoder_state[i] |= (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1);
+        encoder_pulses[i] += encoder_LUT[encoder_state[i] & 0xF];
+        if (encoder_pulses[i] >= ENCODER_RESOLUTION) {
+            __atomic_store_n(&encoder_count[i], (uint8_t)(encoder_count[i] + 1), __ATOMIC_RELEASE);
+        }
+        if (encoder_pulses[i] <= -ENCODER_RESOLUTION) {  // direction is arbitrary here, but this clockwise
+            __atomic_store_n(&encoder_count[i], (uint8_t)(encoder_count[i] - 1), __ATOMIC_RELEASE);
+        }
+        encoder_pulses[i] %= ENCODER_RESOLUTION;
+    }
+}
+
+/* Detents per second, from the time since the last detent of this encoder */
+static uint16_t encoder_velocity(uint8_t index, int8_t steps) {
+    uint16_t elapsed = timer_elapsed(encoder_step_time[index]);
+
+    encoder_step_time[index] = timer_read();
+    if (elapsed > ENCODER_VELOCITY_TIMEOUT) {
+        elapsed = ENCODER_VELOCITY_TIMEOUT;
+    }
+    return (uint32_t)(steps < 0 ? -steps : steps) * 1000 / (elapsed ? elapsed : 1);
+}
+
+/* Reports every detent between the last reported count and this one in one callback */
+static void encoder_update(uint8_t index, uint8_t count) {
+    int8_t delta = count - encoder_value[index];
+    if (delta == 0) {
+        return;
+    }
+    encoder_value[index] = count;
+
+    int8_t steps = delta * ENCODER_CLOCKWISE_SIGN;
+    if (!encoder_update_steps_kb(index, steps, encoder_velocity(index, steps))) {
+        return;
+    }
+    // then one callback per detent, unless the batched detents have been handled
+    for (; steps > 0; steps--) {
+        encoder_update_kb(index, true);
     }
-    if (encoder_pulses[i] <= -ENCODER_RESOLUTION) {  // direction is arbitrary here, but this clockwise
-        encoder_value[index]--;
-        encoder_update_kb(index, ENCODER_CLOCKWISE);
+    for (; steps < 0; steps++) {
+        encoder_update_kb(index, false);
     }
-    encoder_pulses[i] %= ENCODER_RESOLUTION;
 }
 
 void encoder_read(void) {
+#ifndef ENCODER_INTERRUPT_SAMPLING
+    encoder_sample();
+#endif
     for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
-        encoder_state[i] <<= 2;
-        encoder_state[i] |= (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1);
-        encoder_update(i, encoder_state[i]);
+        uint8_t index = i;
+#ifdef SPLIT_KEYBOARD
+        index += thisHand;
+#endif
+        encoder_update(index, __atomic_load_n(&encoder_count[i], __ATOMIC_ACQUIRE));
     }
 }
 
@@ -115,18 +167,7 @@ void encoder_state_raw(uint8_t* slave_state) { memcpy(slave_state, &encoder_valu
 
 void encoder_update_raw(uint8_t* slave_state) {
     for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
-        uint8_t index = i + thatHand;
-        int8_t  delta = slave_state[i] - encoder_value[index];
-        while (delta > 0) {
-            delta--;
-            encoder_value[index]++;
-            encoder_update_kb(index, ENCODER_COUNTER_CLOCKWISE);
-        }
-        while (delta < 0) {
-            delta++;
-            encoder_value[index]--;
-            encoder_update_kb(index, ENCODER_CLOCKWISE);
-        }
+        encoder_update(i + thatHand, slave_state[i]);
     }
 }
 #endif
@@ -19,12 +19,23 @@
 
 #include "quantum.h"
 
+/* Pauses longer than this count as turning slowly again */
+#ifndef ENCODER_VELOCITY_TIMEOUT
+#    define ENCODER_VELOCITY_TIMEOUT 200
+#endif
+
 void encoder_init(void);
 void encoder_read(void);
+void encoder_sample(void);
 
 void encoder_update_kb(int8_t index, bool clockwise);
 void encoder_update_user(int8_t index, bool clockwise);
 
+/* All detents since the last call, clockwise positive, with the turning speed in detents per second.
+ * Return false when they have been handled, true to also get encoder_update_kb() once per detent. */
+bool encoder_update_steps_kb(int8_t index, int8_t steps, uint16_t velocity);
+bool encoder_update_steps_user(int8_t index, int8_t steps, uint16_t velocity);
+
 #ifdef SPLIT_KEYBOARD
 void encoder_state_raw(uint8_t* slave_state);
 void encoder_update_raw(uint8_t* slave_state);
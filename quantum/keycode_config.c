@@ -18,12 +18,20 @@
 
 extern keymap_config_t keymap_config;
 
-/** \brief keycode_config
+/* Remapped basic keycodes, for the two ranges the bootmagic config touches,
+ * and the remapped 5-bit mods, rebuilt whenever keymap_config changes. */
+static uint8_t  keycode_remap[KC_CAPSLOCK - KC_ESCAPE + 1];
+static uint8_t  modifier_remap[KC_RGUI - KC_LCTRL + 1];
+static uint8_t  mod_remap[32];
+static uint16_t remap_config;
+static bool     remap_built = false;
+
+/** \brief remap_keycode
  *
- * This function is used to check a specific keycode against the bootmagic config,
- * and will return the corrected keycode, when appropriate.
+ * Checks a basic keycode against the bootmagic config. Only used to build the
+ * remap tables.
  */
-uint16_t keycode_config(uint16_t keycode) {
+static uint8_t remap_keycode(uint8_t keycode) {
     switch (keycode) {
         case KC_CAPSLOCK:
         case KC_LOCKING_CAPS:
@@ -113,13 +121,12 @@ uint16_t keycode_config(uint16_t keycode) {
     }
 }
 
-/** \brief mod_config
+/** \brief remap_mods
  *
- *  This function checks the mods passed to it against the bootmagic config,
- *  and will remove or replace mods, based on that.
+ * Checks 5-bit mods against the bootmagic config, and removes or replaces
+ * them. Only used to build the remap tables.
  */
-
-uint8_t mod_config(uint8_t mod) {
+static uint8_t remap_mods(uint8_t mod) {
     if (keymap_config.swap_lalt_lgui) {
         if ((mod & MOD_RGUI) == MOD_LGUI) {
             mod &= ~MOD_LGUI;
@@ -163,3 +170,57 @@ uint8_t mod_config(uint8_t mod) {
 
     return mod;
 }
+
+/** \brief keycode_config_update
+ *
+ * Rebuilds the remap tables from the current keymap_config. Lookups call it
+ * themselves once keymap_config has changed, so it never has to be called
+ * after magic keycodes, bootmagic or an eeconfig load.
+ */
+void keycode_config_update(void) {
+    for (uint8_t i = 0; i < sizeof(keycode_remap); i++) {
+        keycode_remap[i] = remap_keycode(KC_ESCAPE + i);
+    }
+    for (uint8_t i = 0; i < sizeof(modifier_remap); i++) {
+        modifier_remap[i] = remap_keycode(KC_LCTRL + i);
+    }
+    for (uint8_t i = 0; i < sizeof(mod_remap); i++) {
+        mod_remap[i] = remap_mods(i);
+    }
+    remap_config = keymap_config.raw;
+    remap_built  = true;
+}
+
+/** \brief keycode_config
+ *
+ * This function is used to check a specific keycode against the bootmagic config,
+ * and will return the corrected keycode, when appropriate.
+ */
+uint16_t keycode_config(uint16_t keycode) {
+    if (remap_config != keymap_config.raw || !remap_built) {
+        keycode_config_update();
+    }
+    switch (keycode) {
+        case KC_ESCAPE ... KC_CAPSLOCK:
+            return keycode_remap[keycode - KC_ESCAPE];
+        case KC_LCTRL ... KC_RGUI:
+            return modifier_remap[keycode - KC_LCTRL];
+        case KC_LOCKING_CAPS:
+            // remapped along with Caps Lock, which only ever turns into Left Control
+            return keycode_remap[KC_CAPSLOCK - KC_ESCAPE] == KC_LCTL ? KC_LCTL : keycode;
+        default:
+            return keycode;
+    }
+}
+
+/** \brief mod_config
+ *
+ *  This function checks the mods passed to it against the bootmagic config,
+ *  and will remove or replace mods, based on that.
+ */
+uint8_t mod_config(uint8_t mod) {
+    if (remap_config != keymap_config.raw || !remap_built) {
+        keycode_config_update();
+    }
+    return mod_remap[mod & 0x1F] | (mod & ~0x1F);
+}
@@ -23,6 +23,7 @@
 
 uint16_t keycode_config(uint16_t keycode);
 uint8_t  mod_config(uint8_t mod);
+void     keycode_config_update(void);
 
 /* NOTE: Not portable. Bit field order depends on implementation */
 typedef union {
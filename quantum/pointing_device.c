@@ -22,21 +22,150 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "print.h"
 #include "debug.h"
 #include "pointing_device.h"
+#if defined(__AVR__)
+#    include <util/atomic.h>
+#elif defined(PROTOCOL_CHIBIOS)
+#    include "ch.h"
+#endif
 
 static report_mouse_t mouseReport = {};
 
+/* Motion that did not fit in the reports sent so far */
+static int16_t pending_x = 0;
+static int16_t pending_y = 0;
+static int16_t pending_v = 0;
+static int16_t pending_h = 0;
+
+/* Motion from pointing_device_push_motion() that the main loop has not taken
+ * yet. It may be pushed from an interrupt, and two bytes can't be read or
+ * written at once on AVR, so both sides only touch it with interrupts masked.
+ */
+static volatile int16_t pushed_x = 0;
+static volatile int16_t pushed_y = 0;
+
+static uint8_t  last_buttons = 0;
+static uint16_t last_send    = 0;
+static bool     throttled    = false;
+
+static inline void add_axis(int16_t *axis, int16_t delta) {
+    int32_t sum = (int32_t)*axis + delta;
+    *axis       = sum > INT16_MAX ? INT16_MAX : sum < -INT16_MAX ? -INT16_MAX : sum;
+}
+
+/* Takes as much of an axis as fits in one report */
+static inline int16_t take_axis(int16_t *axis, int16_t limit) {
+    int16_t value = *axis > limit ? limit : *axis < -limit ? -limit : *axis;
+    *axis -= value;
+    return value;
+}
+
+/* The pending wheels are in 1/POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER notch,
+ * which a report holds as is once the host has enabled the multiplier, and
+ * as whole notches before. The rest of a notch stays pending.
+ */
+static inline int16_t wheel_unit(void) {
+#ifdef POINTING_DEVICE_HIRES_SCROLL
+    return mouse_resolution_multiplier ? 1 : POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER;
+#else
+    return 1;
+#endif
+}
+
+static inline int16_t take_wheel(int16_t *axis, int16_t unit) {
+    int16_t value = *axis / unit;
+    value         = value > MOUSE_WHEEL_MAX ? MOUSE_WHEEL_MAX : value < -MOUSE_WHEEL_MAX ? -MOUSE_WHEEL_MAX : value;
+    *axis -= value * unit;
+    return value;
+}
+
+void pointing_device_add_motion(int16_t x, int16_t y) {
+    add_axis(&pending_x, x);
+    add_axis(&pending_y, y);
+}
+
+void pointing_device_add_scroll(int16_t v, int16_t h) {
+    add_axis(&pending_v, v);
+    add_axis(&pending_h, h);
+}
+
+void pointing_device_push_motion(int16_t x, int16_t y) {
+#if defined(__AVR__)
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        pushed_x += x;
+        pushed_y += y;
+    }
+#elif defined(PROTOCOL_CHIBIOS)
+    syssts_t sts = chSysGetStatusAndLockX();
+    pushed_x += x;
+    pushed_y += y;
+    chSysRestoreStatusX(sts);
+#else
+    pushed_x += x;
+    pushed_y += y;
+#endif
+}
+
+static void take_pushed_motion(void) {
+    int16_t x, y;
+#if defined(__AVR__)
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        x        = pushed_x;
+        y        = pushed_y;
+        pushed_x = 0;
+        pushed_y = 0;
+    }
+#elif defined(PROTOCOL_CHIBIOS)
+    chSysLock();
+    x        = pushed_x;
+    y        = pushed_y;
+    pushed_x = 0;
+    pushed_y = 0;
+    chSysUnlock();
+#else
+    x        = pushed_x;
+    y        = pushed_y;
+    pushed_x = 0;
+    pushed_y = 0;
+#endif
+    pointing_device_add_motion(x, y);
+}
+
 __attribute__((weak)) void pointing_device_init(void) {
     // initialize device, if that needs to be done.
 }
 
 __attribute__((weak)) void pointing_device_send(void) {
-    // If you need to do other things, like debugging, this is the place to do it.
-    host_mouse_send(&mouseReport);
-    // send it and 0 it out except for buttons, so those stay until they are explicity over-ridden using update_pointing_device
+    // Motion set in the report is added to the pending motion, so nothing is lost when it does not fit
+    take_pushed_motion();
+    pointing_device_add_motion(mouseReport.x, mouseReport.y);
+    pointing_device_add_scroll(mouseReport.v, mouseReport.h);
     mouseReport.x = 0;
     mouseReport.y = 0;
     mouseReport.v = 0;
     mouseReport.h = 0;
+
+    if (throttled && timer_elapsed(last_send) >= POINTING_DEVICE_INTERVAL) {
+        throttled = false;
+    }
+
+    // Buttons go out right away, motion at most once per interval, and the first motion after a pause right away as well
+    int16_t unit   = wheel_unit();
+    bool    moving = pending_x || pending_y || pending_v / unit || pending_h / unit;
+    if (mouseReport.buttons == last_buttons && (!moving || throttled)) {
+        return;
+    }
+
+    report_mouse_t report = mouseReport;
+    report.x              = take_axis(&pending_x, 127);
+    report.y              = take_axis(&pending_y, 127);
+    report.v              = take_wheel(&pending_v, unit);
+    report.h              = take_wheel(&pending_h, unit);
+    // If you need to do other things, like debugging, this is the place to do it.
+    host_mouse_send(&report);
+
+    last_buttons = report.buttons;
+    last_send    = timer_read();
+    throttled    = true;
 }
 
 __attribute__((weak)) void pointing_device_task(void) {
@@ -46,10 +175,11 @@ __attribute__((weak)) void pointing_device_task(void) {
     // mouseReport.v = 127 max -127 min (scroll vertical)
     // mouseReport.h = 127 max -127 min (scroll horizontal)
     // mouseReport.buttons = 0x1F (decimal 31, binary 00011111) max (bitmask for mouse buttons 1-5, 1 is rightmost, 5 is leftmost) 0x00 min
+    // or for larger deltas, e.g. from a high DPI sensor, call pointing_device_add_motion()
     // send the report
     pointing_device_send();
 }
 
 report_mouse_t pointing_device_get_report(void) { return mouseReport; }
 
-void pointing_device_set_report(report_mouse_t newMouseReport) { mouseReport = newMouseReport; }
\ No newline at end of file
+void pointing_device_set_report(report_mouse_t newMouseReport) { mouseReport = newMouseReport; }
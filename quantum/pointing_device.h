@@ -22,10 +22,26 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "host.h"
 #include "report.h"
 
+/* Shortest time between two motion reports, one per USB poll by default */
+#ifndef POINTING_DEVICE_INTERVAL
+#    ifdef USB_POLLING_INTERVAL_MS
+#        define POINTING_DEVICE_INTERVAL USB_POLLING_INTERVAL_MS
+#    else
+#        define POINTING_DEVICE_INTERVAL 10
+#    endif
+#endif
+
 void           pointing_device_init(void);
 void           pointing_device_task(void);
 void           pointing_device_send(void);
 report_mouse_t pointing_device_get_report(void);
 void           pointing_device_set_report(report_mouse_t newMouseReport);
 
+/* Motion that has not been sent yet, from keyboard_task() */
+void pointing_device_add_motion(int16_t x, int16_t y);
+void pointing_device_add_scroll(int16_t v, int16_t h);
+
+/* Motion from an interrupt or another thread, e.g. a sensor ISR or a timer callback */
+void pointing_device_push_motion(int16_t x, int16_t y);
+
 #endif
@@ -16,6 +16,7 @@
 
 #include "print.h"
 #include "process_combo.h"
+#include "action_tapping.h"
 
 #ifndef COMBO_VARIABLE_LEN
 __attribute__((weak)) combo_t key_combos[COMBO_COUNT] = {};
@@ -26,11 +27,11 @@ extern int      COMBO_LEN;
 
 __attribute__((weak)) void process_combo_event(uint8_t combo_index, bool pressed) {}
 
-static uint16_t timer               = 0;
-static uint8_t  current_combo_index = 0;
-static bool     drop_buffer         = false;
-static bool     is_active           = false;
-static bool     b_combo_enable      = true;  // defaults to enabled
+static event_time_t timer               = 0;
+static uint8_t      current_combo_index = 0;
+static bool         drop_buffer         = false;
+static bool         is_active           = false;
+static bool         b_combo_enable      = true;  // defaults to enabled
 
 static uint8_t buffer_size = 0;
 #ifdef COMBO_ALLOW_ACTION_KEYS
@@ -59,7 +60,7 @@ static inline void dump_key_buffer(bool emit) {
     if (emit) {
         for (uint8_t i = 0; i < buffer_size; i++) {
 #ifdef COMBO_ALLOW_ACTION_KEYS
-            const action_t action = store_or_get_action(key_buffer[i].event.pressed, key_buffer[i].event.key);
+            const action_t action = action_for_keycode(get_record_keycode(&key_buffer[i], true));
             process_action(&(key_buffer[i]), action);
 #else
             register_code16(key_buffer[i]);
@@ -157,10 +158,15 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
     if (drop_buffer) {
         /* buffer is only dropped when we complete a combo, so we refresh the timer
          * here */
-        timer = timer_read();
+        timer = event_timer_read();
         dump_key_buffer(false);
     } else if (!is_combo_key) {
-        /* if no combos claim the key we need to emit the keybuffer */
+        /* if no combos claim the key we need to emit the keybuffer. The keys
+         * in it are now held on the host, so like after a timeout no combo
+         * may claim them until every combo key is up again */
+        if (buffer_size) {
+            is_active = false;
+        }
         dump_key_buffer(true);
 
         // reset state if there are no combo keys pressed at all
@@ -170,7 +176,7 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
         }
     } else if (record->event.pressed && is_active) {
         /* otherwise the key is consumed and placed in the buffer */
-        timer = timer_read();
+        timer = event_timer_read();
 
         if (buffer_size < MAX_COMBO_LENGTH) {
 #ifdef COMBO_ALLOW_ACTION_KEYS
@@ -185,7 +191,7 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
 }
 
 void matrix_scan_combo(void) {
-    if (b_combo_enable && is_active && timer && timer_elapsed(timer) > COMBO_TERM) {
+    if (b_combo_enable && is_active && timer && EVENT_TIME_DIFF(event_timer_read(), timer) > EVENT_TIME_MS(COMBO_TERM)) {
         /* This disables the combo, meaning key events for this
          * combo will be handled by the next processors in the chain
          */
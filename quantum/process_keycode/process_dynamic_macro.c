@@ -17,6 +17,9 @@
 
 /* Author: Wojciech Siewierski < wojciech dot siewierski at onet dot pl > */
 #include "process_dynamic_macro.h"
+#ifdef DYNAMIC_MACRO_EEPROM_ADDR
+#    include "eeprom.h"
+#endif
 
 // default feedback method
 void dynamic_macro_led_blink(void) {
@@ -44,96 +47,399 @@ __attribute__((weak)) void dynamic_macro_record_end_user(int8_t direction) { dyn
 #define DYNAMIC_MACRO_CURRENT_LENGTH(BEGIN, POINTER) ((int)(direction * ((POINTER) - (BEGIN))))
 #define DYNAMIC_MACRO_CURRENT_CAPACITY(BEGIN, END2) ((int)(direction * ((END2) - (BEGIN)) + 1))
 
+/* Each key event is a header byte, the keycode in one or two bytes, the
+ * key position as its index in the matrix and, when delays are recorded,
+ * the time since the previous event as a varint of 7 bits per byte. Macro 2
+ * stores the same bytes right to left.
+ */
+#define DYNAMIC_MACRO_EVENT_PRESSED 0x01
+#define DYNAMIC_MACRO_EVENT_TAPPED 0x02
+#define DYNAMIC_MACRO_EVENT_KEYCODE16 0x04
+#define DYNAMIC_MACRO_EVENT_DELAY 0x08
+#define DYNAMIC_MACRO_EVENT_KEYPOS 0x10
+
+#if MATRIX_ROWS * MATRIX_COLS > 256
+#    define DYNAMIC_MACRO_KEYPOS_SIZE 2
+#else
+#    define DYNAMIC_MACRO_KEYPOS_SIZE 1
+#endif
+#define DYNAMIC_MACRO_EVENT_MAX_SIZE (6 + DYNAMIC_MACRO_KEYPOS_SIZE)
+
+/* Events recorded from outside the matrix, like combos, are played back
+ * from this position. It is outside the matrix too, so handlers that look
+ * up the key position skip them, and their keycode is given.
+ */
+#define DYNAMIC_MACRO_NO_KEYPOS ((keypos_t){.row = 254, .col = 254})
+
+typedef struct {
+    uint8_t  flags;
+    uint16_t keycode;
+    keypos_t key;
+    uint16_t delay;
+} dynamic_macro_event_t;
+
+typedef struct {
+    int16_t       position;
+    int16_t       end;
+    int8_t        direction;
+    layer_state_t saved_layer_state;
+} dynamic_macro_playback_t;
+
+/* Both macros use the same buffer but read/write on different
+ * ends of it.
+ *
+ * Macro1 is written left-to-right starting from the beginning of
+ * the buffer.
+ *
+ * Macro2 is written right-to-left starting from the end of the
+ * buffer.
+ *
+ *  0               macro_end
+ *  v                   v
+ * +------------------------------------------------------------+
+ * |>>>>>> MACRO1 >>>>>>      <<<<<<<<<<<<< MACRO2 <<<<<<<<<<<<<|
+ * +------------------------------------------------------------+
+ *                           ^                                 ^
+ *                         r_macro_end                  r_macro_start
+ *
+ * During the recording when one macro encounters the end of the
+ * other macro, the recording is stopped. Apart from this, there
+ * are no arbitrary limits for the macros' length in relation to
+ * each other: for example one can either have two medium sized
+ * macros or one long macro and one short macro. Or even one empty
+ * and one using the whole buffer.
+ */
+static uint8_t macro_buffer[DYNAMIC_MACRO_BUFFER_BYTES];
+
+/* The other end of the macro buffer. Serves as the beginning of
+ * the second macro. */
+static const int16_t r_macro_start = DYNAMIC_MACRO_BUFFER_BYTES - 1;
+
+/* Index of the first byte after the first macro. Initially the very
+ * beginning of the buffer since the macro is empty. */
+static int16_t macro_end = 0;
+
+/* Like macro_end but for the second macro. */
+static int16_t r_macro_end = DYNAMIC_MACRO_BUFFER_BYTES - 1;
+
+/* The current macro position (iterator) used during the recording,
+ * and when the last event was recorded. */
+static int16_t  macro_pointer = 0;
+static uint16_t macro_timer   = 0;
+
+/* 0   - no macro is being recorded right now
+ * 1,2 - either macro 1 or 2 is being recorded */
+static uint8_t macro_id = 0;
+
+/* The macros being played back. A macro replaying the other one
+ * is the only nesting possible. */
+static dynamic_macro_playback_t playback[2];
+static uint8_t                  playback_depth = 0;
+static uint16_t                 playback_timer = 0;
+
+static void dynamic_macro_write(uint8_t byte, int8_t direction) {
+    macro_buffer[macro_pointer] = byte;
+    macro_pointer += direction;
+}
+
+static uint8_t dynamic_macro_read(int16_t *position, int8_t direction) {
+    uint8_t byte = macro_buffer[*position];
+    *position += direction;
+    return byte;
+}
+
+static uint8_t dynamic_macro_encode(uint8_t *event, uint16_t keycode, keyrecord_t *record, uint16_t delay) {
+    uint8_t size = 1;
+
+    event[0] = record->event.pressed ? DYNAMIC_MACRO_EVENT_PRESSED : 0;
+#ifndef NO_ACTION_TAPPING
+    if (record->tap.count) {
+        event[0] |= DYNAMIC_MACRO_EVENT_TAPPED;
+    }
+#endif
+    event[size++] = keycode & 0xFF;
+    if (keycode > 0xFF) {
+        event[0] |= DYNAMIC_MACRO_EVENT_KEYCODE16;
+        event[size++] = keycode >> 8;
+    }
+    if (record->event.key.row < MATRIX_ROWS && record->event.key.col < MATRIX_COLS) {
+        uint16_t index = record->event.key.row * MATRIX_COLS + record->event.key.col;
+
+        event[0] |= DYNAMIC_MACRO_EVENT_KEYPOS;
+        event[size++] = index & 0xFF;
+#if DYNAMIC_MACRO_KEYPOS_SIZE > 1
+        event[size++] = index >> 8;
+#endif
+    }
+    if (delay) {
+        event[0] |= DYNAMIC_MACRO_EVENT_DELAY;
+        for (; delay > 0x7F; delay >>= 7) {
+            event[size++] = (delay & 0x7F) | 0x80;
+        }
+        event[size++] = delay;
+    }
+    return size;
+}
+
+/**
+ * Decode the event at the given position.
+ *
+ * @return The position of the next event.
+ */
+static int16_t dynamic_macro_decode(int16_t position, int8_t direction, dynamic_macro_event_t *event) {
+    event->flags   = dynamic_macro_read(&position, direction);
+    event->keycode = dynamic_macro_read(&position, direction);
+    if (event->flags & DYNAMIC_MACRO_EVENT_KEYCODE16) {
+        event->keycode |= dynamic_macro_read(&position, direction) << 8;
+    }
+    event->key = DYNAMIC_MACRO_NO_KEYPOS;
+    if (event->flags & DYNAMIC_MACRO_EVENT_KEYPOS) {
+        uint16_t index = dynamic_macro_read(&position, direction);
+#if DYNAMIC_MACRO_KEYPOS_SIZE > 1
+        index |= dynamic_macro_read(&position, direction) << 8;
+#endif
+        event->key = (keypos_t){.row = index / MATRIX_COLS, .col = index % MATRIX_COLS};
+    }
+    event->delay = 0;
+    if (event->flags & DYNAMIC_MACRO_EVENT_DELAY) {
+        uint8_t byte;
+        uint8_t shift = 0;
+        do {
+            byte = dynamic_macro_read(&position, direction);
+            event->delay |= (byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+    }
+    return position;
+}
+
+#ifdef DYNAMIC_MACRO_EEPROM_ADDR
+#    define DYNAMIC_MACRO_EEPROM_MAGIC 0xD14D
+
+typedef struct {
+    uint16_t magic;
+    uint16_t size;
+    int16_t  macro_end;
+    int16_t  r_macro_end;
+} dynamic_macro_eeprom_header_t;
+
+#    define DYNAMIC_MACRO_EEPROM_BUFFER ((uint8_t *)(DYNAMIC_MACRO_EEPROM_ADDR) + sizeof(dynamic_macro_eeprom_header_t))
+
+/**
+ * Save both macros to EEPROM. Only the bytes used by the macros are
+ * written, and unchanged bytes are skipped by eeprom_update_block().
+ */
+static void dynamic_macro_save(void) {
+    dynamic_macro_eeprom_header_t header = {
+        .magic       = DYNAMIC_MACRO_EEPROM_MAGIC,
+        .size        = DYNAMIC_MACRO_BUFFER_BYTES,
+        .macro_end   = macro_end,
+        .r_macro_end = r_macro_end,
+    };
+
+    eeprom_update_block(&header, (void *)(DYNAMIC_MACRO_EEPROM_ADDR), sizeof(header));
+    eeprom_update_block(macro_buffer, DYNAMIC_MACRO_EEPROM_BUFFER, macro_end);
+    eeprom_update_block(macro_buffer + r_macro_end + 1, DYNAMIC_MACRO_EEPROM_BUFFER + r_macro_end + 1, r_macro_start - r_macro_end);
+    dprintln("dynamic macro: saved to eeprom");
+}
+#endif
+
+/**
+ * Load the macros saved in EEPROM, if any.
+ */
+void dynamic_macro_init(void) {
+#ifdef DYNAMIC_MACRO_EEPROM_ADDR
+    dynamic_macro_eeprom_header_t header;
+
+    eeprom_read_block(&header, (void *)(DYNAMIC_MACRO_EEPROM_ADDR), sizeof(header));
+    if (header.magic != DYNAMIC_MACRO_EEPROM_MAGIC || header.size != DYNAMIC_MACRO_BUFFER_BYTES || header.macro_end < 0 || header.macro_end > header.r_macro_end + 1 || header.r_macro_end > r_macro_start) {
+        dprintln("dynamic macro: no macros in eeprom");
+        return;
+    }
+
+    macro_end   = header.macro_end;
+    r_macro_end = header.r_macro_end;
+    eeprom_read_block(macro_buffer, DYNAMIC_MACRO_EEPROM_BUFFER, macro_end);
+    eeprom_read_block(macro_buffer + r_macro_end + 1, DYNAMIC_MACRO_EEPROM_BUFFER + r_macro_end + 1, r_macro_start - r_macro_end);
+    dprintln("dynamic macro: loaded from eeprom");
+#endif
+}
+
 /**
  * Start recording of the dynamic macro.
  *
- * @param[out] macro_pointer The new macro buffer iterator.
- * @param[in]  macro_buffer  The macro buffer used to initialize macro_pointer.
+ * @param[in] macro_start The beginning of the macro being recorded.
  */
-void dynamic_macro_record_start(keyrecord_t **macro_pointer, keyrecord_t *macro_buffer) {
+static void dynamic_macro_record_start(int16_t macro_start) {
     dprintln("dynamic macro recording: started");
 
     dynamic_macro_record_start_user();
 
     clear_keyboard();
     layer_clear();
-    *macro_pointer = macro_buffer;
+    macro_pointer = macro_start;
 }
 
 /**
- * Play the dynamic macro.
+ * Play the dynamic macro. The events are processed one per main loop
+ * iteration by dynamic_macro_task().
  *
- * @param macro_buffer[in] The beginning of the macro buffer being played.
- * @param macro_end[in]    The element after the last macro buffer element.
- * @param direction[in]    Either +1 or -1, which way to iterate the buffer.
+ * @param macro_start[in] The beginning of the macro being played.
+ * @param macro_end[in]   The position after the last macro event.
+ * @param direction[in]   Either +1 or -1, which way to iterate the buffer.
  */
-void dynamic_macro_play(keyrecord_t *macro_buffer, keyrecord_t *macro_end, int8_t direction) {
+static void dynamic_macro_play(int16_t macro_start, int16_t macro_end, int8_t direction) {
+    for (uint8_t i = 0; i < playback_depth; i++) {
+        if (playback[i].direction == direction) {
+            dprintln("dynamic macro: ignoring a macro replaying itself");
+            return;
+        }
+    }
+
     dprintf("dynamic macro: slot %d playback\n", DYNAMIC_MACRO_CURRENT_SLOT());
 
-    layer_state_t saved_layer_state = layer_state;
+    playback[playback_depth++] = (dynamic_macro_playback_t){
+        .position          = macro_start,
+        .end               = macro_end,
+        .direction         = direction,
+        .saved_layer_state = layer_state,
+    };
+    playback_timer = timer_read();
 
     clear_keyboard();
     layer_clear();
+}
 
-    while (macro_buffer != macro_end) {
-        process_record(macro_buffer);
-        macro_buffer += direction;
-    }
+/**
+ * Finish playing back the innermost macro.
+ */
+static void dynamic_macro_play_end(void) {
+    int8_t direction = playback[--playback_depth].direction;
 
     clear_keyboard();
 
-    layer_state = saved_layer_state;
+    layer_state = playback[playback_depth].saved_layer_state;
 
     dynamic_macro_play_user(direction);
 }
 
+bool dynamic_macro_is_playing(void) { return playback_depth; }
+
+/**
+ * Play back the next event of the macro being played, if any. Called
+ * from matrix_scan_quantum(), so playback never stalls the keyboard.
+ */
+void dynamic_macro_task(void) {
+    if (!playback_depth) {
+        return;
+    }
+
+    dynamic_macro_playback_t *current = &playback[playback_depth - 1];
+    if (current->position == current->end) {
+        dynamic_macro_play_end();
+        return;
+    }
+
+    dynamic_macro_event_t event;
+    int16_t               next = dynamic_macro_decode(current->position, current->direction, &event);
+    if (timer_elapsed(playback_timer) < event.delay) {
+        return;
+    }
+    current->position = next;
+
+    keyrecord_t record = {
+        .event =
+            {
+                .key     = event.key,
+                .pressed = event.flags & DYNAMIC_MACRO_EVENT_PRESSED,
+                .time    = (event_timer_read() | 1),
+            },
+        .keycode = event.keycode,
+    };
+#ifndef NO_ACTION_TAPPING
+    record.tap.count = (event.flags & DYNAMIC_MACRO_EVENT_TAPPED) ? 1 : 0;
+#endif
+    process_record(&record);
+    playback_timer = timer_read();
+}
+
 /**
  * Record a single key in a dynamic macro.
  *
- * @param macro_buffer[in] The start of the used macro buffer.
- * @param macro_pointer[in,out] The current buffer position.
- * @param macro2_end[in] The end of the other macro.
- * @param direction[in]  Either +1 or -1, which way to iterate the buffer.
- * @param record[in]     The current keypress.
+ * @param macro_start[in] The beginning of the macro being recorded.
+ * @param macro2_end[in]  The end of the other macro.
+ * @param direction[in]   Either +1 or -1, which way to iterate the buffer.
+ * @param keycode[in]     The keycode of the current keypress.
+ * @param record[in]      The current keypress.
  */
-void dynamic_macro_record_key(keyrecord_t *macro_buffer, keyrecord_t **macro_pointer, keyrecord_t *macro2_end, int8_t direction, keyrecord_t *record) {
+static void dynamic_macro_record_key(int16_t macro_start, int16_t macro2_end, int8_t direction, uint16_t keycode, keyrecord_t *record) {
     /* If we've just started recording, ignore all the key releases. */
-    if (!record->event.pressed && *macro_pointer == macro_buffer) {
+    if (!record->event.pressed && macro_pointer == macro_start) {
         dprintln("dynamic macro: ignoring a leading key-up event");
         return;
     }
 
+    /* KC_NO does nothing. Played back, an event without a keycode would be
+     * looked up again from its key position in the current keymap, so it
+     * is not recorded at all.
+     */
+    if (keycode == KC_NO) {
+        return;
+    }
+
+    uint16_t delay = 0;
+#ifdef DYNAMIC_MACRO_RECORD_DELAYS
+    if (macro_pointer != macro_start) {
+        delay = timer_elapsed(macro_timer);
+    }
+#endif
+    macro_timer = timer_read();
+
+    uint8_t event[DYNAMIC_MACRO_EVENT_MAX_SIZE];
+    uint8_t size = dynamic_macro_encode(event, keycode, record, delay);
+
     /* The other end of the other macro is the last buffer element it
      * is safe to use before overwriting the other macro.
      */
-    if (*macro_pointer - direction != macro2_end) {
-        **macro_pointer = *record;
-        *macro_pointer += direction;
+    if (direction * (macro2_end - macro_pointer) + 1 >= size) {
+        for (uint8_t i = 0; i < size; i++) {
+            dynamic_macro_write(event[i], direction);
+        }
     } else {
         dynamic_macro_record_key_user(direction, record);
     }
 
-    dprintf("dynamic macro: slot %d length: %d/%d\n", DYNAMIC_MACRO_CURRENT_SLOT(), DYNAMIC_MACRO_CURRENT_LENGTH(macro_buffer, *macro_pointer), DYNAMIC_MACRO_CURRENT_CAPACITY(macro_buffer, macro2_end));
+    dprintf("dynamic macro: slot %d length: %d/%d\n", DYNAMIC_MACRO_CURRENT_SLOT(), DYNAMIC_MACRO_CURRENT_LENGTH(macro_start, macro_pointer), DYNAMIC_MACRO_CURRENT_CAPACITY(macro_start, macro2_end));
 }
 
 /**
  * End recording of the dynamic macro. Essentially just update the
- * pointer to the end of the macro.
+ * end of the macro.
  */
-void dynamic_macro_record_end(keyrecord_t *macro_buffer, keyrecord_t *macro_pointer, int8_t direction, keyrecord_t **macro_end) {
+static void dynamic_macro_record_end(int16_t macro_start, int8_t direction, int16_t *macro_end) {
     dynamic_macro_record_end_user(direction);
 
     /* Do not save the keys being held when stopping the recording,
      * i.e. the keys used to access the layer DYN_REC_STOP is on.
      */
-    while (macro_pointer != macro_buffer && (macro_pointer - direction)->event.pressed) {
-        dprintln("dynamic macro: trimming a trailing key-down event");
-        macro_pointer -= direction;
+    int16_t end = macro_start;
+    for (int16_t position = macro_start; position != macro_pointer;) {
+        dynamic_macro_event_t event;
+        position = dynamic_macro_decode(position, direction, &event);
+        if (!(event.flags & DYNAMIC_MACRO_EVENT_PRESSED)) {
+            end = position;
+        }
+    }
+    if (end != macro_pointer) {
+        dprintln("dynamic macro: trimming the trailing key-down events");
     }
 
-    dprintf("dynamic macro: slot %d saved, length: %d\n", DYNAMIC_MACRO_CURRENT_SLOT(), DYNAMIC_MACRO_CURRENT_LENGTH(macro_buffer, macro_pointer));
+    dprintf("dynamic macro: slot %d saved, length: %d\n", DYNAMIC_MACRO_CURRENT_SLOT(), DYNAMIC_MACRO_CURRENT_LENGTH(macro_start, end));
 
-    *macro_end = macro_pointer;
+    *macro_end = end;
+#ifdef DYNAMIC_MACRO_EEPROM_ADDR
+    dynamic_macro_save();
+#endif
 }
 
 /* Handle the key events related to the dynamic macros. Should be
@@ -147,69 +453,23 @@ void dynamic_macro_record_end(keyrecord_t *macro_buffer, keyrecord_t *macro_poin
  *   }
  */
 bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record) {
-    /* Both macros use the same buffer but read/write on different
-     * ends of it.
-     *
-     * Macro1 is written left-to-right starting from the beginning of
-     * the buffer.
-     *
-     * Macro2 is written right-to-left starting from the end of the
-     * buffer.
-     *
-     * &macro_buffer   macro_end
-     *  v                   v
-     * +------------------------------------------------------------+
-     * |>>>>>> MACRO1 >>>>>>      <<<<<<<<<<<<< MACRO2 <<<<<<<<<<<<<|
-     * +------------------------------------------------------------+
-     *                           ^                                 ^
-     *                         r_macro_end                  r_macro_buffer
-     *
-     * During the recording when one macro encounters the end of the
-     * other macro, the recording is stopped. Apart from this, there
-     * are no arbitrary limits for the macros' length in relation to
-     * each other: for example one can either have two medium sized
-     * macros or one long macro and one short macro. Or even one empty
-     * and one using the whole buffer.
-     */
-    static keyrecord_t macro_buffer[DYNAMIC_MACRO_SIZE];
-
-    /* Pointer to the first buffer element after the first macro.
-     * Initially points to the very beginning of the buffer since the
-     * macro is empty. */
-    static keyrecord_t *macro_end = macro_buffer;
-
-    /* The other end of the macro buffer. Serves as the beginning of
-     * the second macro. */
-    static keyrecord_t *const r_macro_buffer = macro_buffer + DYNAMIC_MACRO_SIZE - 1;
-
-    /* Like macro_end but for the second macro. */
-    static keyrecord_t *r_macro_end = r_macro_buffer;
-
-    /* A persistent pointer to the current macro position (iterator)
-     * used during the recording. */
-    static keyrecord_t *macro_pointer = NULL;
-
-    /* 0   - no macro is being recorded right now
-     * 1,2 - either macro 1 or 2 is being recorded */
-    static uint8_t macro_id = 0;
-
     if (macro_id == 0) {
         /* No macro recording in progress. */
         if (!record->event.pressed) {
             switch (keycode) {
                 case DYN_REC_START1:
-                    dynamic_macro_record_start(&macro_pointer, macro_buffer);
+                    dynamic_macro_record_start(0);
                     macro_id = 1;
                     return false;
                 case DYN_REC_START2:
-                    dynamic_macro_record_start(&macro_pointer, r_macro_buffer);
+                    dynamic_macro_record_start(r_macro_start);
                     macro_id = 2;
                     return false;
                 case DYN_MACRO_PLAY1:
-                    dynamic_macro_play(macro_buffer, macro_end, +1);
+                    dynamic_macro_play(0, macro_end, +1);
                     return false;
                 case DYN_MACRO_PLAY2:
-                    dynamic_macro_play(r_macro_buffer, r_macro_end, -1);
+                    dynamic_macro_play(r_macro_start, r_macro_end, -1);
                     return false;
             }
         }
@@ -223,10 +483,10 @@ bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record) {
                                               * starts. */
                     switch (macro_id) {
                         case 1:
-                            dynamic_macro_record_end(macro_buffer, macro_pointer, +1, &macro_end);
+                            dynamic_macro_record_end(0, +1, &macro_end);
                             break;
                         case 2:
-                            dynamic_macro_record_end(r_macro_buffer, macro_pointer, -1, &r_macro_end);
+                            dynamic_macro_record_end(r_macro_start, -1, &r_macro_end);
                             break;
                     }
                     macro_id = 0;
@@ -242,10 +502,10 @@ bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record) {
                 /* Store the key in the macro buffer and process it normally. */
                 switch (macro_id) {
                     case 1:
-                        dynamic_macro_record_key(macro_buffer, &macro_pointer, r_macro_end, +1, record);
+                        dynamic_macro_record_key(0, r_macro_end, +1, keycode, record);
                         break;
                     case 2:
-                        dynamic_macro_record_key(r_macro_buffer, &macro_pointer, macro_end, -1, record);
+                        dynamic_macro_record_key(r_macro_start, macro_end, -1, keycode, record);
                         break;
                 }
                 return true;
@@ -33,8 +33,24 @@
 #    define DYNAMIC_MACRO_SIZE 128
 #endif
 
+/* The size of the buffer shared by both macros, in bytes. By default it
+ * takes the six bytes per event an AVR key record took when the macros
+ * were stored as DYNAMIC_MACRO_SIZE records. A key event takes three bytes,
+ * one more for keycodes above 0xFF or matrices of more than 256 keys, plus
+ * up to three for its delay when DYNAMIC_MACRO_RECORD_DELAYS is defined.
+ */
+#ifndef DYNAMIC_MACRO_BUFFER_BYTES
+#    define DYNAMIC_MACRO_BUFFER_BYTES (DYNAMIC_MACRO_SIZE * 6)
+#endif
+
+/* Define DYNAMIC_MACRO_EEPROM_ADDR to keep the macros in EEPROM. They take
+ * DYNAMIC_MACRO_BUFFER_BYTES + 8 bytes from that address on. */
+
 void dynamic_macro_led_blink(void);
 bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record);
+void dynamic_macro_init(void);
+void dynamic_macro_task(void);
+bool dynamic_macro_is_playing(void);
 void dynamic_macro_record_start_user(void);
 void dynamic_macro_play_user(int8_t direction);
 void dynamic_macro_record_key_user(int8_t direction, keyrecord_t *record);
@@ -19,10 +19,6 @@
 #    include "process_leader.h"
 #    include <string.h>
 
-#    ifndef LEADER_TIMEOUT
-#        define LEADER_TIMEOUT 300
-#    endif
-
 __attribute__((weak)) void leader_start(void) {}
 
 __attribute__((weak)) void leader_end(void) {}
@@ -31,8 +27,121 @@ __attribute__((weak)) void leader_end(void) {}
 bool     leading     = false;
 uint16_t leader_time = 0;
 
-uint16_t leader_sequence[5]   = {0, 0, 0, 0, 0};
-uint8_t  leader_sequence_size = 0;
+uint16_t leader_sequence[LEADER_MAX_SEQUENCE_LENGTH] = {0};
+uint8_t  leader_sequence_size                        = 0;
+
+// Keymaps without LEADER_SEQUENCES() match sequences in matrix_scan_user()
+__attribute__((weak)) const leader_sequence_t *leader_get_dictionary(uint16_t *size) {
+    *size = 0;
+    return NULL;
+}
+
+/* The dictionary is sorted, so the entries starting with the keys pressed so
+ * far are always next to each other. Each key narrows them down like a step
+ * down a trie. */
+static const leader_sequence_t *leader_dictionary;
+static uint16_t                 leader_dictionary_size;
+static uint16_t                 dictionary_first;
+static uint16_t                 dictionary_end;
+static int8_t                   dictionary_sorted = -1;
+
+// Whether matrix_scan_user() checked LEADER_DICTIONARY() since the leader key was pressed
+static bool user_dictionary = false;
+
+bool leader_user_dictionary(void) {
+    user_dictionary = true;
+    return true;
+}
+
+static inline uint16_t dictionary_key(uint16_t entry, uint8_t index) { return index < LEADER_MAX_SEQUENCE_LENGTH ? pgm_read_word(&leader_dictionary[entry].sequence[index]) : 0; }
+
+static bool dictionary_is_sorted(void) {
+    for (uint16_t entry = 1; entry < leader_dictionary_size; entry++) {
+        for (uint8_t i = 0; i < LEADER_MAX_SEQUENCE_LENGTH; i++) {
+            uint16_t previous = dictionary_key(entry - 1, i);
+            uint16_t key      = dictionary_key(entry, i);
+            if (previous < key) {
+                break;
+            }
+            if (previous > key) {
+                dprintf("leader: dictionary entry %u is out of order\n", entry);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/* Returns the first entry in the range whose key at `index` is not below `keycode` */
+static uint16_t dictionary_lower_bound(uint16_t first, uint16_t end, uint8_t index, uint16_t keycode) {
+    while (first < end) {
+        uint16_t middle = first + (end - first) / 2;
+        if (dictionary_key(middle, index) < keycode) {
+            first = middle + 1;
+        } else {
+            end = middle;
+        }
+    }
+    return first;
+}
+
+/* Returns the entry that is exactly the sequence typed so far, or leader_dictionary_size */
+static uint16_t dictionary_match(void) {
+    if (!leader_sequence_size) {
+        return leader_dictionary_size;
+    }
+    if (dictionary_sorted) {
+        // a sequence sorts before the longer ones it starts
+        if (dictionary_first < dictionary_end && !dictionary_key(dictionary_first, leader_sequence_size)) {
+            return dictionary_first;
+        }
+        return leader_dictionary_size;
+    }
+    for (uint16_t entry = 0; entry < leader_dictionary_size; entry++) {
+        uint8_t i = 0;
+        while (i < LEADER_MAX_SEQUENCE_LENGTH && dictionary_key(entry, i) == (i < leader_sequence_size ? leader_sequence[i] : 0)) {
+            i++;
+        }
+        if (i == LEADER_MAX_SEQUENCE_LENGTH) {
+            return entry;
+        }
+    }
+    return leader_dictionary_size;
+}
+
+static void dictionary_finish(uint16_t entry) {
+    leading = false;
+    if (entry < leader_dictionary_size) {
+        void (*action)(void) = (void (*)(void))pgm_read_ptr(&leader_dictionary[entry].action);
+        if (action) {
+            action();
+        }
+    }
+    leader_end();
+}
+
+/* Narrows the dictionary down to the entries starting with the keys typed so
+ * far. A sequence that is the only one left fires right away. One that no
+ * entry starts with ends the leader sequence, unless matrix_scan_user() has
+ * its own sequences to look it up in once the timeout has passed. */
+static void dictionary_advance(void) {
+    if (!dictionary_sorted) {
+        return;
+    }
+
+    uint8_t  index   = leader_sequence_size - 1;
+    uint16_t keycode = leader_sequence[index];
+    dictionary_first = dictionary_lower_bound(dictionary_first, dictionary_end, index, keycode);
+    dictionary_end   = keycode == 0xFFFF ? dictionary_end : dictionary_lower_bound(dictionary_first, dictionary_end, index, keycode + 1);
+
+    if (dictionary_first == dictionary_end) {
+        if (!user_dictionary) {
+            dictionary_finish(leader_dictionary_size);
+        }
+    } else if (dictionary_end - dictionary_first == 1 && dictionary_match() == dictionary_first) {
+        dictionary_finish(dictionary_first);
+    }
+}
 
 void qk_leader_start(void) {
     if (leading) {
@@ -43,6 +152,14 @@ void qk_leader_start(void) {
     leader_time          = timer_read();
     leader_sequence_size = 0;
     memset(leader_sequence, 0, sizeof(leader_sequence));
+    user_dictionary      = false;
+
+    if (dictionary_sorted < 0) {
+        leader_dictionary = leader_get_dictionary(&leader_dictionary_size);
+        dictionary_sorted = dictionary_is_sorted();
+    }
+    dictionary_first = 0;
+    dictionary_end   = leader_dictionary_size;
 }
 
 bool process_leader(uint16_t keycode, keyrecord_t *record) {
@@ -58,6 +175,9 @@ bool process_leader(uint16_t keycode, keyrecord_t *record) {
                 if (leader_sequence_size < (sizeof(leader_sequence) / sizeof(leader_sequence[0]))) {
                     leader_sequence[leader_sequence_size] = keycode;
                     leader_sequence_size++;
+                    if (leader_dictionary_size) {
+                        dictionary_advance();
+                    }
                 } else {
                     leading = false;
                     leader_end();
@@ -76,4 +196,20 @@ bool process_leader(uint16_t keycode, keyrecord_t *record) {
     return true;
 }
 
+/** \brief Ends a dictionary sequence once LEADER_TIMEOUT has passed
+ *
+ * Fires the sequence typed so far if it is in the dictionary, even when
+ * longer sequences start with it. Runs before matrix_scan_user(), where
+ * LEADER_DICTIONARY() ends the sequence whether it matches or not, so any
+ * other sequence is left to it when it is there.
+ */
+void matrix_scan_leader(void) {
+    if (leading && leader_dictionary_size && timer_elapsed(leader_time) > LEADER_TIMEOUT) {
+        uint16_t entry = dictionary_match();
+        if (entry < leader_dictionary_size || !user_dictionary) {
+            dictionary_finish(entry);
+        }
+    }
+}
+
 #endif
@@ -19,7 +19,41 @@
 
 #include "quantum.h"
 
+#ifndef LEADER_TIMEOUT
+#    define LEADER_TIMEOUT 300
+#endif
+
+#ifndef LEADER_MAX_SEQUENCE_LENGTH
+#    define LEADER_MAX_SEQUENCE_LENGTH 5
+#endif
+
+#if LEADER_MAX_SEQUENCE_LENGTH < 5
+#    error "LEADER_MAX_SEQUENCE_LENGTH must be at least 5, SEQ_FIVE_KEYS() reads that many keys"
+#endif
+
+typedef struct {
+    uint16_t sequence[LEADER_MAX_SEQUENCE_LENGTH];
+    void (*action)(void);
+} leader_sequence_t;
+
+/* One entry of the leader dictionary: the action, then the keys of the sequence */
+#define LEADER_SEQ(action, ...) \
+    { {__VA_ARGS__}, action }
+
+/* Defines the leader dictionary. Entries have to be sorted by their keycodes,
+ * in the order the keys are pressed, with shorter sequences first. */
+#define LEADER_SEQUENCES(...)                                                   \
+    static const leader_sequence_t PROGMEM leader_dictionary[] = {__VA_ARGS__}; \
+    const leader_sequence_t *leader_get_dictionary(uint16_t *size) {           \
+        *size = sizeof(leader_dictionary) / sizeof(leader_dictionary[0]);       \
+        return leader_dictionary;                                               \
+    }
+
+const leader_sequence_t *leader_get_dictionary(uint16_t *size);
+
 bool process_leader(uint16_t keycode, keyrecord_t *record);
+void matrix_scan_leader(void);
+bool leader_user_dictionary(void);
 
 void leader_start(void);
 void leader_end(void);
@@ -31,11 +65,12 @@ void qk_leader_start(void);
 #define SEQ_FOUR_KEYS(key1, key2, key3, key4) if (leader_sequence[0] == (key1) && leader_sequence[1] == (key2) && leader_sequence[2] == (key3) && leader_sequence[3] == (key4) && leader_sequence[4] == 0)
 #define SEQ_FIVE_KEYS(key1, key2, key3, key4, key5) if (leader_sequence[0] == (key1) && leader_sequence[1] == (key2) && leader_sequence[2] == (key3) && leader_sequence[3] == (key4) && leader_sequence[4] == (key5))
 
-#define LEADER_EXTERNS()                \
-    extern bool     leading;            \
-    extern uint16_t leader_time;        \
-    extern uint16_t leader_sequence[5]; \
+#define LEADER_EXTERNS()                                         \
+    extern bool     leading;                                     \
+    extern uint16_t leader_time;                                 \
+    extern uint16_t leader_sequence[LEADER_MAX_SEQUENCE_LENGTH]; \
     extern uint8_t  leader_sequence_size
-#define LEADER_DICTIONARY() if (leading && timer_elapsed(leader_time) > LEADER_TIMEOUT)
+// Also tells the leader dictionary that matrix_scan_user() looks up sequences of its own
+#define LEADER_DICTIONARY() if (leader_user_dictionary() && leading && timer_elapsed(leader_time) > LEADER_TIMEOUT)
 
 #endif
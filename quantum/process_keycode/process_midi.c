@@ -19,6 +19,7 @@
 #    include <LUFA/Drivers/USB/USB.h>
 #    include "midi.h"
 #    include "qmk_midi.h"
+#    include "timer.h"
 
 #    ifdef MIDI_BASIC
 
@@ -32,8 +33,6 @@ void process_midi_all_notes_off(void) { midi_send_cc(&midi_device, 0, 0x7B, 0);
 
 #    ifdef MIDI_ADVANCED
 
-#        include "timer.h"
-
 static uint8_t tone_status[MIDI_TONE_COUNT];
 
 static uint8_t  midi_modulation;
@@ -224,8 +223,17 @@ bool process_midi(uint16_t keycode, keyrecord_t *record) {
 
 #    endif  // MIDI_ADVANCED
 
+static uint16_t midi_flush_time;
+
 void midi_task(void) {
     midi_device_process(&midi_device);
+
+    // What is sent within the same millisecond goes out in one transfer
+    if (midi_device.output_length > 0 && timer_read() != midi_flush_time) {
+        midi_flush_time = timer_read();
+        midi_device_flush(&midi_device);
+    }
+
 #    ifdef MIDI_ADVANCED
     if (timer_elapsed(midi_modulation_timer) < midi_config.modulation_interval) return;
     midi_modulation_timer = timer_read();
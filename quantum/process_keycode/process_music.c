@@ -187,6 +187,9 @@ bool process_music(uint16_t keycode, keyrecord_t *record) {
 
         uint8_t note = 36;
 #    ifdef MUSIC_MAP
+        if (record->event.key.row >= MATRIX_ROWS || record->event.key.col >= MATRIX_COLS) {
+            return true;
+        }
         if (music_mode == MUSIC_MODE_CHROMATIC) {
             note = music_starting_note + music_offset + 36 + music_map[record->event.key.row][record->event.key.col];
         } else {
@@ -65,9 +65,21 @@ static steno_mode_t mode;
 
 static const uint8_t boltmap[64] PROGMEM = {TXB_NUL, TXB_NUM, TXB_NUM, TXB_NUM, TXB_NUM, TXB_NUM, TXB_NUM, TXB_S_L, TXB_S_L, TXB_T_L, TXB_K_L, TXB_P_L, TXB_W_L, TXB_H_L, TXB_R_L, TXB_A_L, TXB_O_L, TXB_STR, TXB_STR, TXB_NUL, TXB_NUL, TXB_NUL, TXB_STR, TXB_STR, TXB_E_R, TXB_U_R, TXB_F_R, TXB_R_R, TXB_P_R, TXB_B_R, TXB_L_R, TXB_G_R, TXB_T_R, TXB_S_R, TXB_D_R, TXB_NUM, TXB_NUM, TXB_NUM, TXB_NUM, TXB_NUM, TXB_NUM, TXB_Z_R};
 
+#ifdef STENO_DICTIONARY_ENABLE
+#    define STENO_BIT_NONE 0xFF
+
+// Bit of each key in a stroke for steno_translate(), in steno order
+static const uint8_t strokemap[42] PROGMEM = {STENO_BIT_NONE, 0, 0, 0, 0, 0, 0, 1, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 10, STENO_BIT_NONE, STENO_BIT_NONE, STENO_BIT_NONE, 10, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 0, 0, 0, 0, 0, 0, 22};
+
+static uint32_t stroke = 0;
+#endif
+
 static void steno_clear_state(void) {
     memset(state, 0, sizeof(state));
     memset(chord, 0, sizeof(chord));
+#ifdef STENO_DICTIONARY_ENABLE
+    stroke = 0;
+#endif
 }
 
 static void send_steno_state(uint8_t size, bool send_empty) {
@@ -89,6 +101,9 @@ void steno_init() {
 
 void steno_set_mode(steno_mode_t new_mode) {
     steno_clear_state();
+#ifdef STENO_DICTIONARY_ENABLE
+    steno_translate_clear();
+#endif
     mode = new_mode;
     eeprom_update_byte(EECONFIG_STENOMODE, mode);
 }
@@ -115,6 +130,13 @@ static void send_steno_chord(void) {
                 chord[0] |= 0x80;  // Indicate start of packet
                 send_steno_state(GEMINI_STATE_SIZE, true);
                 break;
+#ifdef STENO_DICTIONARY_ENABLE
+            case STENO_MODE_DICTIONARY:
+                if (stroke) {
+                    steno_translate(stroke);
+                }
+                break;
+#endif
         }
     }
     steno_clear_state();
@@ -147,6 +169,17 @@ static bool update_state_gemini(uint8_t key, bool press) {
     return false;
 }
 
+#ifdef STENO_DICTIONARY_ENABLE
+// Keeps the Gemini state as well, for the hooks that look at the chord
+static bool update_state_dictionary(uint8_t key, bool press) {
+    uint8_t bit = pgm_read_byte(strokemap + key);
+    if (press && bit != STENO_BIT_NONE) {
+        stroke |= 1UL << bit;
+    }
+    return update_state_gemini(key, press);
+}
+#endif
+
 bool process_steno(uint16_t keycode, keyrecord_t *record) {
     switch (keycode) {
         case QK_STENO_BOLT:
@@ -167,6 +200,17 @@ bool process_steno(uint16_t keycode, keyrecord_t *record) {
             }
             return false;
 
+#ifdef STENO_DICTIONARY_ENABLE
+        case QK_STENO_DICT:
+            if (!process_steno_user(keycode, record)) {
+                return false;
+            }
+            if (IS_PRESSED(record->event)) {
+                steno_set_mode(STENO_MODE_DICTIONARY);
+            }
+            return false;
+#endif
+
         case STN__MIN ... STN__MAX:
             if (!process_steno_user(keycode, record)) {
                 return false;
@@ -178,6 +222,11 @@ bool process_steno(uint16_t keycode, keyrecord_t *record) {
                 case STENO_MODE_GEMINI:
                     update_state_gemini(keycode - QK_STENO, IS_PRESSED(record->event));
                     break;
+#ifdef STENO_DICTIONARY_ENABLE
+                case STENO_MODE_DICTIONARY:
+                    update_state_dictionary(keycode - QK_STENO, IS_PRESSED(record->event));
+                    break;
+#endif
             }
             // allow postprocessing hooks
             if (postprocess_steno_user(keycode, record, mode, chord, pressed)) {
@@ -17,8 +17,17 @@
 #define PROCESS_STENO_H
 
 #include "quantum.h"
+#ifdef STENO_DICTIONARY_ENABLE
+#    include "steno_dictionary.h"
+#endif
 
-typedef enum { STENO_MODE_BOLT, STENO_MODE_GEMINI } steno_mode_t;
+typedef enum {
+    STENO_MODE_BOLT,
+    STENO_MODE_GEMINI,
+#ifdef STENO_DICTIONARY_ENABLE
+    STENO_MODE_DICTIONARY,  // translated on the keyboard, see steno_dictionary.h
+#endif
+} steno_mode_t;
 
 bool     process_steno(uint16_t keycode, keyrecord_t *record);
 void     steno_init(void);
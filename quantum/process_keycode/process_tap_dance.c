@@ -24,9 +24,58 @@
 uint8_t get_oneshot_mods(void);
 #endif
 
+#ifndef TAP_DANCE_MAX_ACTIVE
+#    define TAP_DANCE_MAX_ACTIVE 8
+#endif
+
 static uint16_t last_td;
 static int8_t   highest_td = -1;
 
+/* Dances with taps counted, sorted by index, so scans and keypresses only look
+ * at those. If more are ever in progress at once, every dance up to highest_td
+ * is checked until they are all over. */
+static uint8_t active_td[TAP_DANCE_MAX_ACTIVE];
+static uint8_t active_td_count    = 0;
+static bool    active_td_overflow = false;
+
+static void activate_tap_dance(uint8_t idx) {
+    for (uint8_t i = 0; i < active_td_count; i++) {
+        if (active_td[i] == idx) return;
+    }
+    if (active_td_count == TAP_DANCE_MAX_ACTIVE) {
+        active_td_overflow = true;
+        return;
+    }
+
+    uint8_t i = active_td_count++;
+    for (; i > 0 && active_td[i - 1] > idx; i--) {
+        active_td[i] = active_td[i - 1];
+    }
+    active_td[i] = idx;
+}
+
+/* Drops the dances that have been reset since they were added */
+static void prune_active_tap_dances(void) {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < active_td_count; i++) {
+        if (tap_dance_actions[active_td[i]].state.count) {
+            active_td[count++] = active_td[i];
+        }
+    }
+    active_td_count = count;
+
+    if (active_td_overflow) {
+        for (int i = 0; i <= highest_td; i++) {
+            if (tap_dance_actions[i].state.count) return;
+        }
+        active_td_overflow = false;
+    }
+}
+
+static inline uint8_t active_tap_dances(void) { return active_td_overflow ? highest_td + 1 : active_td_count; }
+
+static inline qk_tap_dance_action_t *active_tap_dance(uint8_t i) { return &tap_dance_actions[active_td_overflow ? i : active_td[i]]; }
+
 void qk_tap_dance_pair_on_each_tap(qk_tap_dance_state_t *state, void *user_data) {
     qk_tap_dance_pair_t *pair = (qk_tap_dance_pair_t *)user_data;
 
@@ -112,10 +161,10 @@ void preprocess_tap_dance(uint16_t keycode, keyrecord_t *record) {
 
     if (!record->event.pressed) return;
 
-    if (highest_td == -1) return;
+    if (!active_tap_dances()) return;
 
-    for (int i = 0; i <= highest_td; i++) {
-        action = &tap_dance_actions[i];
+    for (uint8_t i = 0; i < active_tap_dances(); i++) {
+        action = active_tap_dance(i);
         if (action->state.count) {
             if (keycode == action->state.keycode && keycode == last_td) continue;
             action->state.interrupted          = true;
@@ -124,6 +173,7 @@ void preprocess_tap_dance(uint16_t keycode, keyrecord_t *record) {
             reset_tap_dance(&action->state);
         }
     }
+    prune_active_tap_dances();
 }
 
 bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
@@ -139,7 +189,8 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
             if (record->event.pressed) {
                 action->state.keycode = keycode;
                 action->state.count++;
-                action->state.timer = timer_read();
+                activate_tap_dance(idx);
+                action->state.timer = event_timer_read();
 #ifndef NO_ACTION_ONESHOT
                 action->state.oneshot_mods = get_oneshot_mods();
 #else
@@ -163,21 +214,22 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
 }
 
 void matrix_scan_tap_dance() {
-    if (highest_td == -1) return;
+    if (!active_tap_dances()) return;
     uint16_t tap_user_defined;
 
-    for (uint8_t i = 0; i <= highest_td; i++) {
-        qk_tap_dance_action_t *action = &tap_dance_actions[i];
+    for (uint8_t i = 0; i < active_tap_dances(); i++) {
+        qk_tap_dance_action_t *action = active_tap_dance(i);
         if (action->custom_tapping_term > 0) {
             tap_user_defined = action->custom_tapping_term;
         } else {
             tap_user_defined = TAPPING_TERM;
         }
-        if (action->state.count && timer_elapsed(action->state.timer) > tap_user_defined) {
+        if (action->state.count && EVENT_TIME_DIFF(event_timer_read(), action->state.timer) > EVENT_TIME_MS(tap_user_defined)) {
             process_tap_dance_action_on_dance_finished(action);
             reset_tap_dance(&action->state);
         }
     }
+    prune_active_tap_dances();
 }
 
 void reset_tap_dance(qk_tap_dance_state_t *state) {
@@ -22,15 +22,15 @@
 #    include <inttypes.h>
 
 typedef struct {
-    uint8_t  count;
-    uint8_t  oneshot_mods;
-    uint8_t  weak_mods;
-    uint16_t keycode;
-    uint16_t interrupting_keycode;
-    uint16_t timer;
-    bool     interrupted;
-    bool     pressed;
-    bool     finished;
+    uint8_t      count;
+    uint8_t      oneshot_mods;
+    uint8_t      weak_mods;
+    uint16_t     keycode;
+    uint16_t     interrupting_keycode;
+    event_time_t timer;
+    bool         interrupted;
+    bool         pressed;
+    bool         finished;
 } qk_tap_dance_state_t;
 
 #    define TD(n) (QK_TAP_DANCE | ((n)&0xFF))
@@ -0,0 +1,286 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "process_unicode_common.h"
+#include "process_unicode_async.h"
+
+/* The longest code point, U+10FFFF on Linux, is three steps to start input,
+ * six digits with a release between each repeated one, and two to finish. */
+#define UNICODE_ASYNC_MAX_STEPS 24
+
+/* Each step is exactly one report: the modifiers and the single key held */
+typedef struct {
+    uint8_t mods;
+    uint8_t key;
+    uint8_t delay;
+} unicode_step_t;
+
+static uint32_t queue[UNICODE_ASYNC_QUEUE_SIZE];
+static uint8_t  queue_head = 0;
+static uint8_t  queue_len  = 0;
+
+static unicode_step_t steps[UNICODE_ASYNC_MAX_STEPS];
+static uint8_t        step_count = 0;
+static uint8_t        step_index = 0;
+static uint16_t       step_timer = 0;
+static uint8_t        step_delay = 0;
+
+/* Key events that happened while a batch was typed, executed once it is done */
+static keyevent_t held_events[UNICODE_ASYNC_HELD_EVENTS];
+static uint8_t    held_head  = 0;
+static uint8_t    held_count = 0;
+
+static bool    batch_active = false;
+static bool    session_open = false;
+static uint8_t batch_mode;
+static uint8_t held_mods = 0;
+static uint8_t held_key  = KC_NO;
+
+/** \brief Appends the report with `mods` and `key` held
+ *
+ * Modifiers are never pressed in the same report as a key, and a key tapped
+ * twice in a row is released in between, so every step is an edge the host
+ * can order unambiguously.
+ */
+static void add_step(uint8_t mods, uint8_t key, uint8_t delay) {
+    unicode_step_t last = step_count ? steps[step_count - 1] : (unicode_step_t){.mods = held_mods, .key = held_key};
+
+    if (key == KC_NO && last.key == KC_NO && mods == last.mods && step_count) {
+        steps[step_count - 1].delay += delay;
+        return;
+    }
+    if (key != KC_NO && (key == last.key || mods != last.mods)) {
+        steps[step_count++] = (unicode_step_t){.mods = mods, .key = KC_NO};
+    }
+    steps[step_count++] = (unicode_step_t){.mods = mods, .key = key, .delay = delay};
+}
+
+static void add_tap16(uint8_t mods, uint16_t code) {
+    uint8_t code_mods = (code >> 8) & 0x0F;
+    if (code & QK_RMODS_MIN) {
+        code_mods <<= 4;
+    }
+    code &= 0xFF;
+    if (IS_MOD(code)) {
+        add_step(mods | code_mods | MOD_BIT(code), KC_NO, 0);
+    } else {
+        add_step(mods | code_mods, code, 0);
+    }
+    add_step(mods, KC_NO, 0);
+}
+
+/* Same digits as register_hex32(): at least four, no other leading zeros */
+static void add_hex(uint8_t mods, uint32_t hex) {
+    bool onzerostart = true;
+    for (int8_t i = 7; i >= 0; i--) {
+        uint8_t digit = (hex >> (i * 4)) & 0xF;
+        if (digit || i <= 3 || !onzerostart) {
+            add_step(mods, hex_to_keycode(digit), 0);
+            onzerostart = false;
+        }
+    }
+}
+
+/** \brief Precomputes the reports that type one code point
+ *
+ * macOS keeps Option held across a whole batch of code points. IBus and
+ * WinCompose commit one code point per input sequence, so there only the
+ * modifier override is shared across the batch.
+ */
+static void load_code_point(uint32_t code_point) {
+    if (code_point > 0x10FFFF || (code_point >= 0xD800 && code_point <= 0xDFFF) || (code_point > 0xFFFF && batch_mode == UC_WIN)) {
+        return;
+    }
+
+    switch (batch_mode) {
+        case UC_MAC: {
+            uint8_t mods = MOD_BIT(UNICODE_KEY_MAC);
+            if (!session_open) {
+                add_step(mods, KC_NO, UNICODE_TYPE_DELAY);
+                session_open = true;
+            }
+            if (code_point > 0xFFFF) {
+                // Unicode Hex Input only takes UTF-16 code units
+                code_point -= 0x10000;
+                add_hex(mods, 0xD800 + (code_point >> 10));
+                add_hex(mods, 0xDC00 + (code_point & 0x3FF));
+            } else {
+                add_hex(mods, code_point);
+            }
+            return;
+        }
+        case UC_LNX:
+            add_tap16(0, UNICODE_KEY_LNX);
+            steps[step_count - 1].delay = UNICODE_TYPE_DELAY;
+            add_hex(0, code_point);
+            add_tap16(0, KC_SPC);
+            break;
+        case UC_WIN:
+            add_step(MOD_BIT(KC_LALT), KC_NO, 0);
+            add_tap16(MOD_BIT(KC_LALT), KC_PPLS);
+            steps[step_count - 1].delay = UNICODE_TYPE_DELAY;
+            add_hex(MOD_BIT(KC_LALT), code_point);
+            add_step(0, KC_NO, 0);
+            break;
+        case UC_WINC:
+            add_tap16(0, UNICODE_KEY_WINC);
+            add_tap16(0, KC_U);
+            steps[step_count - 1].delay = UNICODE_TYPE_DELAY;
+            add_hex(0, code_point);
+            add_tap16(0, KC_ENTER);
+            break;
+    }
+}
+
+/** \brief Loads the steps of the next code point in the queue
+ *
+ * Returns false once the queue is empty and the input session is closed.
+ */
+static bool load_next(void) {
+    step_count = 0;
+    step_index = 0;
+
+    while (!step_count) {
+        if (!queue_len) {
+            if (!session_open) {
+                return false;
+            }
+            add_step(0, KC_NO, 0);
+            session_open = false;
+            break;
+        }
+        uint32_t code_point = queue[queue_head];
+        queue_head          = (queue_head + 1) % UNICODE_ASYNC_QUEUE_SIZE;
+        queue_len--;
+        load_code_point(code_point);
+    }
+    return true;
+}
+
+/** \brief Queues a code point to be typed from the main loop
+ *
+ * Returns false when the queue is full.
+ */
+bool register_unicode_async(uint32_t code_point) {
+    if (queue_len == UNICODE_ASYNC_QUEUE_SIZE) {
+        return false;
+    }
+    queue[(queue_head + queue_len++) % UNICODE_ASYNC_QUEUE_SIZE] = code_point;
+    return true;
+}
+
+/** \brief Queues every code point of a UTF-8 string
+ *
+ * Nothing is queued if the whole string does not fit.
+ */
+bool send_unicode_string_async(const char *str) {
+    if (!str) {
+        return false;
+    }
+
+    int32_t     code_point = 0;
+    uint16_t    count      = 0;
+    const char *p          = str;
+    while (*p) {
+        p = decode_utf8(p, &code_point);
+        if (code_point >= 0) {
+            count++;
+        }
+    }
+    if (count > UNICODE_ASYNC_QUEUE_SIZE - queue_len) {
+        return false;
+    }
+
+    while (*str) {
+        str = decode_utf8(str, &code_point);
+        if (code_point >= 0) {
+            register_unicode_async(code_point);
+        }
+    }
+    return true;
+}
+
+/** \brief Drops the code points waiting to be typed
+ *
+ * The one being typed is finished so the host input method is left closed.
+ */
+void unicode_async_cancel(void) { queue_len = 0; }
+
+bool unicode_async_is_busy(void) { return batch_active || queue_len || held_count; }
+
+/** \brief Keeps a key event until the batch has been typed
+ *
+ * Called by keyboard_task() instead of action_exec() while busy, so a key
+ * pressed meanwhile is not sent with the modifiers of the input sequence.
+ * Returns false when there is no room, and the change stays in the matrix.
+ */
+bool unicode_async_hold_event(keyevent_t event) {
+    if (held_count == UNICODE_ASYNC_HELD_EVENTS) {
+        return false;
+    }
+    held_events[(held_head + held_count++) % UNICODE_ASYNC_HELD_EVENTS] = event;
+    return true;
+}
+
+/* Executes the held events in order, until one of them starts another batch */
+static void release_held_events(void) {
+    while (held_count && !batch_active && !queue_len) {
+        keyevent_t event = held_events[held_head];
+        held_head        = (held_head + 1) % UNICODE_ASYNC_HELD_EVENTS;
+        held_count--;
+        action_exec(event);
+    }
+}
+
+/** \brief Sends at most one report of the current batch
+ *
+ * Called from matrix_scan_quantum(), so typing never blocks scanning.
+ */
+void unicode_async_task(void) {
+    if (!batch_active && !queue_len) {
+        release_held_events();
+        return;
+    }
+    if (timer_elapsed(step_timer) < step_delay) {
+        return;
+    }
+
+    if (!batch_active) {
+        batch_active = true;
+        batch_mode   = get_unicode_input_mode();
+        held_mods    = 0;
+        held_key     = KC_NO;
+    }
+
+    if (step_index == step_count && !load_next()) {
+        // Back to the keys and modifiers the user held when the batch started
+        clear_override_report();
+        send_keyboard_report();
+        batch_active = false;
+        step_delay   = 0;
+        release_held_events();
+        return;
+    }
+
+    unicode_step_t *step = &steps[step_index++];
+    held_key             = step->key;
+    held_mods            = step->mods;
+    set_override_report(held_mods, held_key);
+    send_keyboard_report();
+
+    step_timer = timer_read();
+    step_delay = step->delay > UNICODE_ASYNC_STEP_INTERVAL ? step->delay : UNICODE_ASYNC_STEP_INTERVAL;
+}
@@ -0,0 +1,44 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "keyboard.h"
+
+// Number of code points that can be waiting to be typed
+#ifndef UNICODE_ASYNC_QUEUE_SIZE
+#    define UNICODE_ASYNC_QUEUE_SIZE 16
+#endif
+
+// Number of key events that can wait for a batch to be typed
+#ifndef UNICODE_ASYNC_HELD_EVENTS
+#    define UNICODE_ASYNC_HELD_EVENTS 8
+#endif
+
+// Minimum time between two reports, in ms
+#ifndef UNICODE_ASYNC_STEP_INTERVAL
+#    define UNICODE_ASYNC_STEP_INTERVAL 1
+#endif
+
+bool register_unicode_async(uint32_t code_point);
+bool send_unicode_string_async(const char *str);
+void unicode_async_cancel(void);
+bool unicode_async_is_busy(void);
+bool unicode_async_hold_event(keyevent_t event);
+
+void unicode_async_task(void);
@@ -87,6 +87,9 @@ void unicode_input_start(void);
 void unicode_input_finish(void);
 void unicode_input_cancel(void);
 
+uint16_t    hex_to_keycode(uint8_t hex);
+const char *decode_utf8(const char *str, int32_t *code_point);
+
 void register_hex(uint16_t hex);
 void register_hex32(uint32_t hex);
 void send_unicode_hex_string(const char *str);
@@ -94,6 +97,10 @@ void send_unicode_string(const char *str);
 
 bool process_unicode_common(uint16_t keycode, keyrecord_t *record);
 
+#ifdef UNICODE_ASYNC_ENABLE
+#    include "process_unicode_async.h"
+#endif
+
 #define UC_BSPC UC(0x0008)
 #define UC_SPC UC(0x0020)
 
@@ -36,6 +36,11 @@ __attribute__((weak)) uint16_t unicodemap_index(uint16_t keycode) {
 
 bool process_unicodemap(uint16_t keycode, keyrecord_t *record) {
     if (keycode >= QK_UNICODEMAP && keycode <= QK_UNICODEMAP_PAIR_MAX && record->event.pressed) {
+#ifdef UNICODE_ASYNC_ENABLE
+        // The engine checks the range supported by the input mode when it types the code point
+        unicode_saved_mods = get_mods();
+        register_unicode_async(pgm_read_dword(unicode_map + unicodemap_index(keycode)));
+#else
         unicode_input_start();
 
         uint32_t code       = pgm_read_dword(unicode_map + unicodemap_index(keycode));
@@ -55,6 +60,7 @@ bool process_unicodemap(uint16_t keycode, keyrecord_t *record) {
             register_hex32(code);
             unicode_input_finish();
         }
+#endif
     }
     return true;
 }
@@ -0,0 +1,277 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "steno_dictionary.h"
+#include <string.h>
+#include "quantum.h"
+
+#define HEADER_SIZE 8
+#define EDGE_SIZE 9
+
+// Keys that go between the left and the right hand, a stroke without them needs a hyphen
+#define STENO_KEYS_MIDDLE 0x1F00UL
+#define STENO_FIRST_RIGHT_KEY 13
+
+// Output state after the last translation
+#define STATE_ATTACH (1 << 0)
+#define STATE_CAPITALIZE (1 << 1)
+#define STATE_GLUE (1 << 2)
+
+typedef struct {
+    uint32_t text;     // offset of the translation, 0 when the stroke was typed as steno
+    uint16_t typed;    // characters typed for it, with the space before
+    uint8_t  strokes;  // strokes it was made of
+    uint8_t  state;    // output state before it was typed
+} steno_translation_t;
+
+__attribute__((weak)) const uint8_t steno_dictionary[] PROGMEM = {0};
+
+static const char steno_key_names[] PROGMEM = "#STKPWHRAO*EUFRPBLGTSDZ";
+
+static bool     header_loaded = false;
+static uint8_t  longest       = 0;  // 0 when there is no valid dictionary
+static uint32_t root          = 0;
+
+static steno_translation_t history[STENO_HISTORY_LENGTH];
+static uint8_t             history_count = 0;
+static uint32_t            strokes[STENO_STROKE_HISTORY_LENGTH];
+static uint8_t             stroke_count = 0;
+static uint8_t             state        = STATE_ATTACH;
+static bool                capitalize   = false;
+
+__attribute__((weak)) void steno_dictionary_read(uint32_t offset, uint8_t *buffer, uint8_t length) { memcpy_P(buffer, steno_dictionary + offset, length); }
+
+static uint32_t u24(const uint8_t *bytes) { return bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16; }
+
+static uint32_t read_u24(uint32_t offset) {
+    uint8_t bytes[3];
+    steno_dictionary_read(offset, bytes, sizeof(bytes));
+    return u24(bytes);
+}
+
+static void load_header(void) {
+    uint8_t header[HEADER_SIZE];
+    steno_dictionary_read(0, header, sizeof(header));
+    if (header[0] == 'S' && header[1] == 'T' && header[2] == 'N' && header[3] == STENO_DICTIONARY_VERSION) {
+        longest = header[4];
+        root    = u24(header + 5);
+    }
+    header_loaded = true;
+}
+
+uint32_t steno_dictionary_lookup(const uint32_t *outline, uint8_t count) {
+    if (!header_loaded) {
+        load_header();
+    }
+    if (count == 0 || count > longest) {
+        return 0;
+    }
+
+    uint32_t node = root;
+    uint32_t text = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (node == 0) {
+            return 0;
+        }
+
+        // The edges of a node are sorted by stroke
+        uint32_t edges = node + 3;
+        uint32_t low   = 0;
+        uint32_t high  = read_u24(node);
+        uint32_t middle;
+        while (true) {
+            if (low >= high) {
+                return 0;
+            }
+            middle         = (low + high) / 2;
+            uint32_t found = read_u24(edges + middle * EDGE_SIZE);
+            if (found == outline[i]) {
+                break;
+            }
+            if (found < outline[i]) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+
+        uint8_t edge[6];
+        steno_dictionary_read(edges + middle * EDGE_SIZE + 3, edge, sizeof(edge));
+        node = u24(edge);
+        text = u24(edge + 3);
+    }
+    return text;
+}
+
+/* Types the space before a translation if it needs one, and works out the
+ * state after it. Returns the number of characters it is going to type. */
+static uint16_t begin_output(uint8_t flags, uint8_t length) {
+    uint16_t typed = length;
+    if (length > 0) {
+        bool glued = (state & STATE_GLUE) && (flags & STENO_TEXT_GLUE);
+        if (!(state & STATE_ATTACH) && !(flags & STENO_TEXT_ATTACH_BEFORE) && !glued) {
+            send_char(' ');
+            typed++;
+        }
+        capitalize = state & STATE_CAPITALIZE;
+        state      = 0;
+    } else {
+        // Only changes the state, like {^} or {-|}
+        state &= STATE_ATTACH | STATE_CAPITALIZE;
+    }
+
+    if (flags & STENO_TEXT_ATTACH_AFTER) {
+        state |= STATE_ATTACH;
+    }
+    if (flags & STENO_TEXT_CAPITALIZE_NEXT) {
+        state |= STATE_CAPITALIZE;
+    }
+    if ((flags & STENO_TEXT_GLUE) && length > 0) {
+        state |= STATE_GLUE;
+    }
+    return typed;
+}
+
+static void output(char c) {
+    if (capitalize && c >= 'a' && c <= 'z') {
+        c -= 'a' - 'A';
+    }
+    capitalize = false;
+    send_char(c);
+}
+
+static uint16_t type_translation(uint32_t text) {
+    uint8_t header[2];  // flags, length
+    steno_dictionary_read(text, header, sizeof(header));
+    uint16_t typed = begin_output(header[0], header[1]);
+
+    uint8_t chunk[16];
+    for (uint8_t done = 0; done < header[1];) {
+        uint8_t length = header[1] - done < sizeof(chunk) ? header[1] - done : sizeof(chunk);
+        steno_dictionary_read(text + 2 + done, chunk, length);
+        for (uint8_t i = 0; i < length; i++) {
+            output(chunk[i]);
+        }
+        done += length;
+    }
+    return typed;
+}
+
+// Types a stroke that has no translation the way Plover writes it, like "STKPW", "-PB" or "A*EU"
+static uint16_t type_stroke(uint32_t stroke) {
+    char    text[STENO_KEYS + 1];
+    uint8_t length = 0;
+    bool    hyphen = !(stroke & STENO_KEYS_MIDDLE);
+    for (uint8_t key = 0; key < STENO_KEYS; key++) {
+        if (!(stroke & (1UL << key))) {
+            continue;
+        }
+        if (key >= STENO_FIRST_RIGHT_KEY && hyphen) {
+            text[length++] = '-';
+            hyphen         = false;
+        }
+        text[length++] = pgm_read_byte(&steno_key_names[key]);
+    }
+
+    uint16_t typed = begin_output(0, length);
+    for (uint8_t i = 0; i < length; i++) {
+        output(text[i]);
+    }
+    return typed;
+}
+
+// Drops the oldest translation, with the strokes of any translation in progress
+static void forget_oldest(void) {
+    uint8_t count = history[0].strokes;
+    memmove(strokes, strokes + count, (STENO_STROKE_HISTORY_LENGTH - count) * sizeof(strokes[0]));
+    memmove(history, history + 1, (history_count - 1) * sizeof(history[0]));
+    stroke_count -= count;
+    history_count--;
+}
+
+// Deletes what the last translation typed. Its strokes stay after stroke_count.
+static steno_translation_t take_back(void) {
+    steno_translation_t last = history[--history_count];
+    for (uint16_t i = 0; i < last.typed; i++) {
+        tap_code(KC_BSPC);
+    }
+    stroke_count -= last.strokes;
+    state = last.state;
+    return last;
+}
+
+static void translate_stroke(uint32_t stroke) {
+    if (stroke_count == STENO_STROKE_HISTORY_LENGTH) {
+        forget_oldest();
+    }
+    strokes[stroke_count] = stroke;
+
+    // The longest outline wins, so start with as many earlier translations as can be part of one
+    uint8_t replaced = 0;
+    uint8_t count    = 1;
+    while (replaced < history_count && count + history[history_count - 1 - replaced].strokes <= longest) {
+        count += history[history_count - 1 - replaced].strokes;
+        replaced++;
+    }
+    uint32_t text;
+    while ((text = steno_dictionary_lookup(&strokes[stroke_count + 1 - count], count)) == 0 && replaced > 0) {
+        replaced--;
+        count -= history[history_count - 1 - replaced].strokes;
+    }
+
+    for (uint8_t i = 0; i < replaced; i++) {
+        take_back();
+    }
+
+    steno_translation_t translation = {.text = text, .strokes = count, .state = state};
+    translation.typed               = text ? type_translation(text) : type_stroke(stroke);
+
+    stroke_count += count;
+    if (history_count == STENO_HISTORY_LENGTH) {
+        forget_oldest();
+    }
+    history[history_count++] = translation;
+}
+
+static void undo(void) {
+    if (history_count == 0) {
+        return;
+    }
+    // Plover translates the strokes of the last translation again, without the last one
+    steno_translation_t last = take_back();
+    for (uint8_t i = 1; i < last.strokes; i++) {
+        translate_stroke(strokes[stroke_count]);
+    }
+}
+
+void steno_translate(uint32_t stroke) {
+    uint32_t text = steno_dictionary_lookup(&stroke, 1);
+    uint8_t  flags = 0;
+    if (text) {
+        steno_dictionary_read(text, &flags, 1);
+    }
+    if (text ? flags & STENO_TEXT_UNDO : stroke == STENO_KEY_STAR) {
+        undo();
+    } else {
+        translate_stroke(stroke);
+    }
+}
+
+void steno_translate_clear(void) {
+    history_count = 0;
+    stroke_count  = 0;
+    state         = STATE_ATTACH;
+}
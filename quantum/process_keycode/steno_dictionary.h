@@ -0,0 +1,73 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "progmem.h"
+
+/* Translates steno strokes to text on the keyboard, with a dictionary made by
+ * `qmk steno2c` from a Plover dictionary.
+ *
+ * A stroke has one bit per steno key, in steno order: # S- T- K- P- W- H- R-
+ * A- O- * -E -U -F -R -P -B -L -G -T -S -D -Z, with # as bit 0. The format of
+ * the dictionary is described in lib/python/qmk/steno.py.
+ */
+
+// Translations that can be taken back with undo
+#ifndef STENO_HISTORY_LENGTH
+#    define STENO_HISTORY_LENGTH 16
+#endif
+
+// Strokes kept for those translations, the oldest translations are forgotten when they don't fit
+#ifndef STENO_STROKE_HISTORY_LENGTH
+#    define STENO_STROKE_HISTORY_LENGTH 32
+#endif
+
+#define STENO_DICTIONARY_VERSION 1
+
+#define STENO_KEY_NUMBER (1UL << 0)
+#define STENO_KEY_STAR (1UL << 10)
+#define STENO_KEYS 23
+
+// Flags of a translation, as written by lib/python/qmk/steno.py
+#define STENO_TEXT_ATTACH_BEFORE (1 << 0)
+#define STENO_TEXT_ATTACH_AFTER (1 << 1)
+#define STENO_TEXT_CAPITALIZE_NEXT (1 << 2)
+#define STENO_TEXT_GLUE (1 << 3)
+#define STENO_TEXT_UNDO (1 << 4)
+
+/* The dictionary in flash, usually from a file generated by `qmk steno2c`.
+ * Keyboards that keep it somewhere else override steno_dictionary_read()
+ * instead. */
+extern const uint8_t steno_dictionary[] PROGMEM;
+
+/** \brief Copies length bytes of the dictionary at offset into buffer
+ *
+ * Reads steno_dictionary by default. Override it to read the dictionary from
+ * external flash, for example one written with `qmk steno2c -o steno.bin`.
+ */
+void steno_dictionary_read(uint32_t offset, uint8_t *buffer, uint8_t length);
+
+/** \brief Returns the offset of the translation of strokes, 0 when there is none */
+uint32_t steno_dictionary_lookup(const uint32_t *strokes, uint8_t count);
+
+/** \brief Translates a stroke and types the difference it makes to the text */
+void steno_translate(uint32_t stroke);
+
+/** \brief Forgets the translations typed so far, the next one starts without a space */
+void steno_translate_clear(void);
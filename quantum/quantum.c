@@ -109,6 +109,7 @@ void unregister_code16(uint16_t code) {
 void tap_code16(uint16_t code) {
     register_code16(code);
 #if TAP_CODE_DELAY > 0
+    host_keyboard_flush();
     wait_ms(TAP_CODE_DELAY);
 #endif
     unregister_code16(code);
@@ -148,8 +149,47 @@ void reset_keyboard(void) {
     bootloader_jump();
 }
 
-/* Convert record into usable keycode via the contained event. */
-uint16_t get_record_keycode(keyrecord_t *record, bool update_layer_cache) { return get_event_keycode(record->event, update_layer_cache); }
+/* Finds the layer the key resolves on, like layer_switch_get_layer(), and
+ * returns the keycode found there without reading the keymap again.
+ */
+static uint16_t layer_switch_get_keycode(keypos_t key, uint8_t *layer) {
+#ifndef NO_ACTION_LAYER
+    layer_state_t layers = layer_state | default_layer_state;
+    /* check top layer first */
+    for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
+        if (layers & (1UL << i)) {
+            uint16_t keycode = keymap_key_to_keycode(i, key);
+            if (action_for_keycode(keycode).code != ACTION_TRANSPARENT) {
+                *layer = i;
+                return keycode;
+            }
+        }
+    }
+    /* fall back to layer 0 */
+    *layer = 0;
+#else
+    *layer = get_highest_layer(default_layer_state);
+#endif
+    return keymap_key_to_keycode(*layer, key);
+}
+
+/* Convert record into usable keycode via the contained event.
+ *
+ * The keycode is resolved once, when the record is processed, and kept in the
+ * record for the handlers, the action and the tapping code that look at it
+ * afterwards. Lookups that don't update the layer cache happen before a press
+ * is processed, so their result is not kept.
+ */
+uint16_t get_record_keycode(keyrecord_t *record, bool update_layer_cache) {
+    if (record->keycode != KC_NO) {
+        return record->keycode;
+    }
+    uint16_t keycode = get_event_keycode(record->event, update_layer_cache);
+    if (update_layer_cache) {
+        record->keycode = keycode;
+    }
+    return keycode;
+}
 
 /* Convert event into usable keycode. Checks the layer cache to ensure that it
  * retains the correct keycode after a layer change, if the key is still pressed.
@@ -158,21 +198,18 @@ uint16_t get_record_keycode(keyrecord_t *record, bool update_layer_cache) { retu
  * from triggering properly.
  */
 uint16_t get_event_keycode(keyevent_t event, bool update_layer_cache) {
+    uint8_t layer;
 #if !defined(NO_ACTION_LAYER) && !defined(STRICT_LAYER_RELEASE)
-    /* TODO: Use store_or_get_action() or a similar function. */
     if (!disable_action_cache) {
-        uint8_t layer;
-
         if (event.pressed && update_layer_cache) {
-            layer = layer_switch_get_layer(event.key);
+            uint16_t keycode = layer_switch_get_keycode(event.key, &layer);
             update_source_layers_cache(event.key, layer);
-        } else {
-            layer = read_source_layers_cache(event.key);
+            return keycode;
         }
-        return keymap_key_to_keycode(layer, event.key);
+        return keymap_key_to_keycode(read_source_layers_cache(event.key), event.key);
     } else
 #endif
-        return keymap_key_to_keycode(layer_switch_get_layer(event.key), event.key);
+        return layer_switch_get_keycode(event.key, &layer);
 }
 
 /* Get keycode, and then call keyboard function */
@@ -181,107 +218,133 @@ void post_process_record_quantum(keyrecord_t *record) {
     post_process_record_kb(keycode, record);
 }
 
-/* Core keycode function, hands off handling to other functions,
-    then processes internal quantum keycodes, and then processes
-    ACTIONs.                                                      */
-bool process_record_quantum(keyrecord_t *record) {
-    uint16_t keycode = get_record_keycode(record, true);
-
-    // This is how you use actions here
-    // if (keycode == KC_LEAD) {
-    //   action_t action;
-    //   action.code = ACTION_DEFAULT_LAYER_SET(0);
-    //   process_action(record, action);
-    //   return false;
-    // }
-
-#ifdef VELOCIKEY_ENABLE
-    if (velocikey_enabled() && record->event.pressed) {
-        velocikey_accelerate();
-    }
-#endif
-
-#ifdef WPM_ENABLE
-    if (record->event.pressed) {
-        update_wpm(keycode);
-    }
-#endif
-
-#ifdef TAP_DANCE_ENABLE
-    preprocess_tap_dance(keycode, record);
-#endif
+/* Handlers that only act on a range of keycodes are registered with it here,
+ * so they are skipped without a call for every other key. Handlers that have
+ * to see every event, to record or intercept typing, are called directly.
+ */
+#define PROCESS_KEYCODES(min, max, handler) (keycode < (min) || keycode > (max) || handler(keycode, record))
+#define PROCESS_PRESSED_KEYCODES(min, max, handler) (!record->event.pressed || PROCESS_KEYCODES(min, max, handler))
 
-    if (!(
-#if defined(KEY_LOCK_ENABLE)
-            // Must run first to be able to mask key_up events.
-            process_key_lock(&keycode, record) &&
-#endif
+/** \brief Runs the process_* handlers in order until one handles the event
+ *
+ * A plain key only pays for the handlers that need to see every key.
+ */
+bool process_record_handlers(uint16_t keycode, keyrecord_t *record) {
+    return (
 #if defined(DYNAMIC_MACRO_ENABLE) && !defined(DYNAMIC_MACRO_USER_CALL)
-            // Must run asap to ensure all keypresses are recorded.
-            process_dynamic_macro(keycode, record) &&
+        // Must run asap to ensure all keypresses are recorded.
+        process_dynamic_macro(keycode, record) &&
 #endif
 #if defined(AUDIO_ENABLE) && defined(AUDIO_CLICKY)
-            process_clicky(keycode, record) &&
+        process_clicky(keycode, record) &&
 #endif  // AUDIO_CLICKY
 #ifdef HAPTIC_ENABLE
-            process_haptic(keycode, record) &&
+        process_haptic(keycode, record) &&
 #endif  // HAPTIC_ENABLE
 #if defined(RGB_MATRIX_ENABLE)
-            process_rgb_matrix(keycode, record) &&
+        process_rgb_matrix(keycode, record) &&
 #endif
 #if defined(VIA_ENABLE)
-            process_record_via(keycode, record) &&
+        PROCESS_KEYCODES(FN_MO13, MACRO15, process_record_via) &&
 #endif
-            process_record_kb(keycode, record) &&
+        process_record_kb(keycode, record) &&
 #if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
-            process_midi(keycode, record) &&
+        PROCESS_KEYCODES(MIDI_TONE_MIN, MI_BENDU, process_midi) &&
 #endif
 #ifdef AUDIO_ENABLE
-            process_audio(keycode, record) &&
+        PROCESS_PRESSED_KEYCODES(AU_ON, MUV_DE, process_audio) &&
 #endif
 #ifdef BACKLIGHT_ENABLE
-            process_backlight(keycode, record) &&
+        PROCESS_PRESSED_KEYCODES(BL_ON, BL_BRTG, process_backlight) &&
 #endif
 #ifdef STENO_ENABLE
-            process_steno(keycode, record) &&
+        PROCESS_KEYCODES(QK_STENO, QK_STENO_MAX, process_steno) &&
 #endif
 #if (defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))) && !defined(NO_MUSIC_MODE)
-            process_music(keycode, record) &&
+        // Takes over every key while music mode is on
+        process_music(keycode, record) &&
 #endif
 #ifdef TAP_DANCE_ENABLE
-            process_tap_dance(keycode, record) &&
+        // Any other key interrupts a running tap dance
+        process_tap_dance(keycode, record) &&
 #endif
-#if defined(UNICODE_ENABLE) || defined(UNICODEMAP_ENABLE) || defined(UCIS_ENABLE)
-            process_unicode_common(keycode, record) &&
+#if defined(UCIS_ENABLE)
+        // Takes over every key while UCIS input is running
+        process_unicode_common(keycode, record) &&
+#elif defined(UNICODE_ENABLE) || defined(UNICODEMAP_ENABLE)
+        PROCESS_KEYCODES(UNICODE_MODE_FORWARD, UNICODE_MODE_WINC, process_unicode_common) &&
+        PROCESS_KEYCODES(QK_UNICODE, QK_UNICODE_MAX, process_unicode_common) &&
 #endif
 #ifdef LEADER_ENABLE
-            process_leader(keycode, record) &&
+        process_leader(keycode, record) &&
 #endif
 #ifdef COMBO_ENABLE
-            process_combo(keycode, record) &&
+        process_combo(keycode, record) &&
 #endif
 #ifdef PRINTING_ENABLE
-            process_printer(keycode, record) &&
+        process_printer(keycode, record) &&
 #endif
 #ifdef AUTO_SHIFT_ENABLE
-            process_auto_shift(keycode, record) &&
+        process_auto_shift(keycode, record) &&
 #endif
 #ifdef TERMINAL_ENABLE
-            process_terminal(keycode, record) &&
+        process_terminal(keycode, record) &&
 #endif
 #ifdef SPACE_CADET_ENABLE
-            process_space_cadet(keycode, record) &&
+        // Any other key cancels a pending Space Cadet tap
+        process_space_cadet(keycode, record) &&
 #endif
 #ifdef MAGIC_KEYCODE_ENABLE
-            process_magic(keycode, record) &&
+        PROCESS_PRESSED_KEYCODES(MAGIC_SWAP_CONTROL_CAPSLOCK, MAGIC_TOGGLE_ALT_GUI, process_magic) &&
+        PROCESS_PRESSED_KEYCODES(MAGIC_SWAP_LCTL_LGUI, MAGIC_EE_HANDS_RIGHT, process_magic) &&
 #endif
 #ifdef GRAVE_ESC_ENABLE
-            process_grave_esc(keycode, record) &&
+        PROCESS_KEYCODES(GRAVE_ESC, GRAVE_ESC, process_grave_esc) &&
 #endif
 #if defined(RGBLIGHT_ENABLE) || defined(RGB_MATRIX_ENABLE)
-            process_rgb(keycode, record) &&
+        PROCESS_KEYCODES(RGB_TOG, RGB_MODE_RGBTEST, process_rgb) &&
 #endif
-            true)) {
+        true);
+}
+
+/* Core keycode function, hands off handling to other functions,
+    then processes internal quantum keycodes, and then processes
+    ACTIONs.                                                      */
+bool process_record_quantum(keyrecord_t *record) {
+    uint16_t keycode = get_record_keycode(record, true);
+
+    // This is how you use actions here
+    // if (keycode == KC_LEAD) {
+    //   action_t action;
+    //   action.code = ACTION_DEFAULT_LAYER_SET(0);
+    //   process_action(record, action);
+    //   return false;
+    // }
+
+#ifdef VELOCIKEY_ENABLE
+    if (velocikey_enabled() && record->event.pressed) {
+        velocikey_accelerate();
+    }
+#endif
+
+#ifdef WPM_ENABLE
+    if (record->event.pressed) {
+        update_wpm(keycode);
+    }
+#endif
+
+#ifdef TAP_DANCE_ENABLE
+    preprocess_tap_dance(keycode, record);
+#endif
+
+#if defined(KEY_LOCK_ENABLE)
+    // Must run first to be able to mask key_up events.
+    if (!process_key_lock(&keycode, record)) {
+        return false;
+    }
+#endif
+
+    if (!process_record_handlers(keycode, record)) {
         return false;
     }
 
@@ -426,9 +489,6 @@ __attribute__((weak)) const uint8_t ascii_to_keycode_lut[128] PROGMEM = {
 
 // clang-format on
 
-// Note: we bit-pack in "reverse" order to optimize loading
-#define PGM_LOADBIT(mem, pos) ((pgm_read_byte(&((mem)[(pos) / 8])) >> ((pos) % 8)) & 0x01)
-
 void send_string(const char *str) { send_string_with_delay(str, 0); }
 
 void send_string_P(const char *str) { send_string_with_delay_P(str, 0); }
@@ -461,6 +521,7 @@ void send_string_with_delay(const char *str, uint8_t interval) {
                     ms += keycode - '0';
                     keycode = *(++str);
                 }
+                host_keyboard_flush();
                 while (ms--) wait_ms(1);
             }
         } else {
@@ -468,7 +529,8 @@ void send_string_with_delay(const char *str, uint8_t interval) {
         }
         ++str;
         // interval
-        {
+        if (interval) {
+            host_keyboard_flush();
             uint8_t ms = interval;
             while (ms--) wait_ms(1);
         }
@@ -503,6 +565,7 @@ void send_string_with_delay_P(const char *str, uint8_t interval) {
                     ms += keycode - '0';
                     keycode = pgm_read_byte(++str);
                 }
+                host_keyboard_flush();
                 while (ms--) wait_ms(1);
             }
         } else {
@@ -510,7 +573,8 @@ void send_string_with_delay_P(const char *str, uint8_t interval) {
         }
         ++str;
         // interval
-        {
+        if (interval) {
+            host_keyboard_flush();
             uint8_t ms = interval;
             while (ms--) wait_ms(1);
         }
@@ -544,6 +608,161 @@ void send_char(char ascii_code) {
     }
 }
 
+typedef struct {
+    uint8_t *out;
+    uint16_t size;
+    uint16_t len;
+    uint8_t  mods;
+    uint8_t  run_code;
+    uint8_t  run_count;
+} ss_compiler_t;
+
+static bool ss_emit(ss_compiler_t *c, uint8_t byte) {
+    if (c->len >= c->size) {
+        return false;
+    }
+    c->out[c->len++] = byte;
+    return true;
+}
+
+static bool ss_flush_run(ss_compiler_t *c) {
+    bool ok = true;
+    if (c->run_count > 2) {
+        ok = ss_emit(c, SS_BC_REPEAT) && ss_emit(c, c->run_count) && ss_emit(c, c->run_code);
+    } else {
+        while (ok && c->run_count--) {
+            ok = ss_emit(c, c->run_code);
+        }
+    }
+    c->run_count = 0;
+    return ok;
+}
+
+static bool ss_emit_mods(ss_compiler_t *c, uint8_t mods) {
+    if (c->mods == mods) {
+        return true;
+    }
+    c->mods = mods;
+    return ss_flush_run(c) && ss_emit(c, SS_BC_MODS) && ss_emit(c, mods);
+}
+
+static bool ss_emit_tap(ss_compiler_t *c, uint8_t keycode) {
+    if (keycode == KC_NO) {
+        return true;
+    }
+    if (keycode <= SS_BC_UP || keycode == SS_BC_REPEAT || keycode == SS_BC_DELAY) {
+        // Keycodes that collide with opcodes are spelled out
+        return ss_flush_run(c) && ss_emit(c, SS_BC_DOWN) && ss_emit(c, keycode) && ss_emit(c, SS_BC_UP) && ss_emit(c, keycode);
+    }
+    if (c->run_count && (c->run_code != keycode || c->run_count == UINT8_MAX)) {
+        if (!ss_flush_run(c)) {
+            return false;
+        }
+    }
+    c->run_code = keycode;
+    c->run_count++;
+    return true;
+}
+
+/** \brief Compiles a send_string() string into bytecode
+ *
+ * Modifiers needed by consecutive characters are held across them instead of
+ * being pressed and released around every character, and repeated taps are
+ * run-length encoded. Strings typed often can be compiled once and replayed
+ * with send_bytecode(). Returns the bytecode length including SS_BC_END, or 0
+ * if it does not fit in size bytes.
+ */
+static uint16_t send_string_compile_impl(const char *str, bool progmem, uint8_t *bytecode, uint16_t size) {
+    ss_compiler_t c  = {.out = bytecode, .size = size};
+    bool          ok = true;
+
+#define SS_READ(p) (progmem ? pgm_read_byte(p) : *(p))
+    while (ok && SS_READ(str)) {
+        char ascii_code = SS_READ(str);
+        if (ascii_code == SS_QMK_PREFIX) {
+            // Raw key codes are typed without the hoisted modifiers, like send_char() leaves them
+            ok         = ss_emit_mods(&c, 0);
+            ascii_code = SS_READ(++str);
+            if (ascii_code == SS_TAP_CODE) {
+                ok = ok && ss_emit_tap(&c, SS_READ(++str));
+            } else if (ascii_code == SS_DOWN_CODE) {
+                ok = ok && ss_flush_run(&c) && ss_emit(&c, SS_BC_DOWN) && ss_emit(&c, SS_READ(++str));
+            } else if (ascii_code == SS_UP_CODE) {
+                ok = ok && ss_flush_run(&c) && ss_emit(&c, SS_BC_UP) && ss_emit(&c, SS_READ(++str));
+            } else if (ascii_code == SS_DELAY_CODE) {
+                uint16_t ms = 0;
+                while (isdigit(SS_READ(++str))) {
+                    ms = ms * 10 + SS_READ(str) - '0';
+                }
+                ok = ok && ss_flush_run(&c) && ss_emit(&c, SS_BC_DELAY) && ss_emit(&c, ms & 0xFF) && ss_emit(&c, ms >> 8);
+            }
+        } else {
+            uint8_t keycode = pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)ascii_code]);
+            uint8_t mods    = (PGM_LOADBIT(ascii_to_shift_lut, (uint8_t)ascii_code) ? MOD_BIT(KC_LSFT) : 0) | (PGM_LOADBIT(ascii_to_altgr_lut, (uint8_t)ascii_code) ? MOD_BIT(KC_RALT) : 0);
+            ok              = ss_emit_mods(&c, mods) && ss_emit_tap(&c, keycode);
+        }
+        ++str;
+    }
+#undef SS_READ
+
+    ok = ok && ss_emit_mods(&c, 0) && ss_flush_run(&c) && ss_emit(&c, SS_BC_END);
+    return ok ? c.len : 0;
+}
+
+uint16_t send_string_compile(const char *str, uint8_t *bytecode, uint16_t size) { return send_string_compile_impl(str, false, bytecode, size); }
+
+uint16_t send_string_compile_P(const char *str, uint8_t *bytecode, uint16_t size) { return send_string_compile_impl(str, true, bytecode, size); }
+
+static void send_bytecode_impl(const uint8_t *bytecode, bool progmem) {
+#define SS_READ() (progmem ? pgm_read_byte(bytecode++) : *bytecode++)
+    while (true) {
+        uint8_t op = SS_READ();
+        switch (op) {
+            case SS_BC_END:
+                if (get_macro_mods()) {
+                    clear_macro_mods();
+                    send_keyboard_report();
+                }
+                return;
+            case SS_BC_MODS:
+                set_macro_mods(SS_READ());
+                send_keyboard_report();
+                break;
+            case SS_BC_DOWN:
+                register_code(SS_READ());
+                break;
+            case SS_BC_UP:
+                unregister_code(SS_READ());
+                break;
+            case SS_BC_REPEAT: {
+                uint8_t count   = SS_READ();
+                uint8_t keycode = SS_READ();
+                while (count--) {
+                    tap_code(keycode);
+                }
+                break;
+            }
+            case SS_BC_DELAY: {
+                uint16_t ms = SS_READ();
+                ms |= SS_READ() << 8;
+                host_keyboard_flush();
+                while (ms--) wait_ms(1);
+                break;
+            }
+            default:
+                tap_code(op);
+                break;
+        }
+    }
+#undef SS_READ
+}
+
+/** \brief Types bytecode produced by send_string_compile()
+ */
+void send_bytecode(const uint8_t *bytecode) { send_bytecode_impl(bytecode, false); }
+
+void send_bytecode_P(const uint8_t *bytecode) { send_bytecode_impl(bytecode, true); }
+
 void set_single_persistent_default_layer(uint8_t default_layer) {
 #if defined(AUDIO_ENABLE) && defined(DEFAULT_LAYER_SONGS)
     PLAY_SONG(default_layer_songs[default_layer]);
@@ -633,6 +852,9 @@ void matrix_init_quantum() {
 #ifdef DIP_SWITCH_ENABLE
     dip_switch_init();
 #endif
+#ifdef DYNAMIC_MACRO_ENABLE
+    dynamic_macro_init();
+#endif
 
     matrix_init_kb();
 }
@@ -650,6 +872,10 @@ void matrix_scan_quantum() {
     matrix_scan_combo();
 #endif
 
+#ifdef LEADER_ENABLE
+    matrix_scan_leader();
+#endif
+
 #ifdef LED_MATRIX_ENABLE
     led_matrix_task();
 #endif
@@ -674,6 +900,18 @@ void matrix_scan_quantum() {
     dip_switch_read(false);
 #endif
 
+#ifdef SEND_STRING_ASYNC_ENABLE
+    send_string_async_task();
+#endif
+
+#ifdef UNICODE_ASYNC_ENABLE
+    unicode_async_task();
+#endif
+
+#ifdef DYNAMIC_MACRO_ENABLE
+    dynamic_macro_task();
+#endif
+
     matrix_scan_kb();
 }
 
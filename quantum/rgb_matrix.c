@@ -127,6 +127,21 @@ last_hit_t        g_last_hit_tracker;
 static last_hit_t last_hit_buffer;
 #endif  // RGB_MATRIX_KEYREACTIVE_ENABLED
 
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+// The chunks are sized from timer_read_us(), which only counts whole milliseconds there
+#    ifdef PROTOCOL_ARM_ATSAM
+#        error "RGB_MATRIX_ADAPTIVE_RENDER needs a microsecond timer, use RGB_MATRIX_LED_PROCESS_LIMIT instead"
+#    endif
+#    define RGB_MATRIX_FRAME_US (1000000 / RGB_MATRIX_TARGET_FPS)
+
+static rgb_matrix_render_stats_t rgb_render_stats = {.chunk_min = UINT8_MAX};
+static uint32_t                  rgb_frame_start;     // in us
+static uint32_t                  rgb_fps_window;      // in ms
+static uint32_t                  rgb_fps_window_frames;
+static uint32_t                  rgb_last_key_event;  // in ms
+static bool                      rgb_key_seen = false;
+#endif  // RGB_MATRIX_ADAPTIVE_RENDER
+
 void eeconfig_read_rgb_matrix(void) { eeprom_read_block(&rgb_matrix_config, EECONFIG_RGB_MATRIX, sizeof(rgb_matrix_config)); }
 
 void eeconfig_update_rgb_matrix(void) { eeprom_update_block(&rgb_matrix_config, EECONFIG_RGB_MATRIX, sizeof(rgb_matrix_config)); }
@@ -154,6 +169,10 @@ __attribute__((weak)) uint8_t rgb_matrix_map_row_column_to_led_kb(uint8_t row, u
 
 uint8_t rgb_matrix_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *led_i) {
     uint8_t led_count = rgb_matrix_map_row_column_to_led_kb(row, column, led_i);
+    // Events from outside the matrix, like played back dynamic macros without a key, light nothing
+    if (row >= MATRIX_ROWS || column >= MATRIX_COLS) {
+        return led_count;
+    }
     uint8_t led_index = g_led_config.matrix_co[row][column];
     if (led_index != NO_LED) {
         led_i[led_count] = led_index;
@@ -169,6 +188,10 @@ void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
 void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue) { rgb_matrix_driver.set_color_all(red, green, blue); }
 
 bool process_rgb_matrix(uint16_t keycode, keyrecord_t *record) {
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+    rgb_last_key_event = timer_read32();
+    rgb_key_seen       = true;
+#endif
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
     uint8_t led[LED_HITS_TO_REMEMBER];
     uint8_t led_count = 0;
@@ -204,7 +227,7 @@ bool process_rgb_matrix(uint16_t keycode, keyrecord_t *record) {
 #endif  // RGB_MATRIX_KEYREACTIVE_ENABLED
 
 #if defined(RGB_MATRIX_FRAMEBUFFER_EFFECTS) && !defined(DISABLE_RGB_MATRIX_TYPING_HEATMAP)
-    if (rgb_matrix_config.mode == RGB_MATRIX_TYPING_HEATMAP) {
+    if (rgb_matrix_config.mode == RGB_MATRIX_TYPING_HEATMAP && record->event.key.row < MATRIX_ROWS && record->event.key.col < MATRIX_COLS) {
         process_rgb_matrix_typing_heatmap(record);
     }
 #endif  // defined(RGB_MATRIX_FRAMEBUFFER_EFFECTS) && !defined(DISABLE_RGB_MATRIX_TYPING_HEATMAP)
@@ -253,6 +276,57 @@ static uint8_t         rgb_last_effect   = UINT8_MAX;
 static effect_params_t rgb_effect_params = {0, 0xFF};
 static rgb_task_states rgb_task_state    = SYNCING;
 
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+rgb_matrix_render_stats_t rgb_matrix_render_stats(void) { return rgb_render_stats; }
+
+void rgb_matrix_render_stats_clear(void) {
+    rgb_render_stats.frames    = 0;
+    rgb_render_stats.overruns  = 0;
+    rgb_render_stats.chunk_min = UINT8_MAX;
+    rgb_render_stats.chunk_max = 0;
+}
+
+static uint16_t rgb_render_budget(void) {
+    bool typing = rgb_key_seen && timer_elapsed32(rgb_last_key_event) < RGB_MATRIX_TYPING_TIMEOUT;
+    return typing ? RGB_MATRIX_TYPING_RENDER_BUDGET_US : RGB_MATRIX_RENDER_BUDGET_US;
+}
+
+/* How many LEDs fit in the budget at the estimated cost per LED. Until
+ * something has been measured, or when the timer is too coarse to see a
+ * chunk, that is all of them.
+ */
+static uint8_t rgb_render_chunk(uint16_t budget) {
+    uint32_t chunk = rgb_render_stats.led_cost ? (uint32_t)budget * 16 / rgb_render_stats.led_cost : DRIVER_LED_TOTAL;
+    if (chunk < 1) chunk = 1;
+    if (chunk > DRIVER_LED_TOTAL) chunk = DRIVER_LED_TOTAL;
+    return chunk;
+}
+
+/* Folds the time a chunk took into the cost per LED. A dearer chunk is
+ * taken at once, so the next one is cut back before it costs latency, and
+ * a cheaper one only pulls the estimate down by an eighth of the gap.
+ */
+static void rgb_render_measure(uint8_t chunk, uint32_t elapsed, uint16_t budget) {
+    // The last chunk of a frame can have fewer LEDs than it asked for
+    uint8_t leds = chunk;
+    if (rgb_effect_params.led_min < DRIVER_LED_TOTAL && DRIVER_LED_TOTAL - rgb_effect_params.led_min < chunk) leds = DRIVER_LED_TOTAL - rgb_effect_params.led_min;
+
+    uint32_t cost = elapsed * 16 / leds;
+    if (cost > UINT16_MAX) cost = UINT16_MAX;
+
+    if (cost >= rgb_render_stats.led_cost) {
+        rgb_render_stats.led_cost = cost;
+    } else {
+        rgb_render_stats.led_cost -= (rgb_render_stats.led_cost - cost + 7) / 8;
+    }
+
+    if (elapsed > budget) rgb_render_stats.overruns++;
+    rgb_render_stats.chunk = chunk;
+    if (chunk < rgb_render_stats.chunk_min) rgb_render_stats.chunk_min = chunk;
+    if (chunk > rgb_render_stats.chunk_max) rgb_render_stats.chunk_max = chunk;
+}
+#endif  // RGB_MATRIX_ADAPTIVE_RENDER
+
 static void rgb_task_timers(void) {
     // Update double buffer timers
     uint16_t deltaTime  = timer_elapsed32(rgb_counters_buffer);
@@ -279,13 +353,34 @@ static void rgb_task_timers(void) {
 }
 
 static void rgb_task_sync(void) {
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+    if (timer_elapsed32(rgb_fps_window) >= 1000) {
+        rgb_render_stats.fps  = rgb_render_stats.frames - rgb_fps_window_frames;
+        rgb_fps_window        = timer_read32();
+        rgb_fps_window_frames = rgb_render_stats.frames;
+    }
+#endif
+
     // next task
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+    if (timer_elapsed_us(rgb_frame_start) >= RGB_MATRIX_FRAME_US) rgb_task_state = STARTING;
+#else
     if (timer_elapsed32(g_rgb_counters.tick) >= RGB_MATRIX_LED_FLUSH_LIMIT) rgb_task_state = STARTING;
+#endif
 }
 
 static void rgb_task_start(void) {
     // reset iter
     rgb_effect_params.iter = 0;
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+    rgb_effect_params.led_min = 0;
+    // Frames are due on a fixed grid, so starting on a later scan does not lower the frame rate, unless a whole frame was missed
+    if (timer_elapsed_us(rgb_frame_start) < 2 * RGB_MATRIX_FRAME_US) {
+        rgb_frame_start += RGB_MATRIX_FRAME_US;
+    } else {
+        rgb_frame_start = timer_read_us();
+    }
+#endif
 
     // update double buffers
     g_rgb_counters.tick = rgb_counters_buffer;
@@ -300,6 +395,12 @@ static void rgb_task_start(void) {
 static void rgb_task_render(uint8_t effect) {
     bool rendering         = false;
     rgb_effect_params.init = (effect != rgb_last_effect) || (rgb_matrix_config.enable != rgb_last_enable);
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+    uint16_t budget           = rgb_render_budget();
+    uint8_t  chunk            = rgb_render_chunk(budget);
+    rgb_effect_params.led_max = rgb_effect_params.led_min + chunk > UINT8_MAX ? UINT8_MAX : rgb_effect_params.led_min + chunk;
+    uint32_t start            = timer_read_us();
+#endif
 
     // each effect can opt to do calculations
     // and/or request PWM buffer updates.
@@ -342,6 +443,10 @@ static void rgb_task_render(uint8_t effect) {
     }
 
     rgb_effect_params.iter++;
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+    rgb_render_measure(chunk, timer_elapsed_us(start), budget);
+    rgb_effect_params.led_min = rgb_effect_params.led_max;
+#endif
 
     // next task
     if (!rendering) {
@@ -361,6 +466,10 @@ static void rgb_task_flush(uint8_t effect) {
     // update pwm buffers
     rgb_matrix_update_pwm_buffers();
 
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+    rgb_render_stats.frames++;
+#endif
+
     // next task
     rgb_task_state = SYNCING;
 }
@@ -44,7 +44,29 @@
 #    define RGB_MATRIX_LED_PROCESS_LIMIT (DRIVER_LED_TOTAL + 4) / 5
 #endif
 
-#if defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+// Render time one keyboard_task() iteration may spend on an effect, and the smaller one while typing
+#    ifndef RGB_MATRIX_RENDER_BUDGET_US
+#        define RGB_MATRIX_RENDER_BUDGET_US 500
+#    endif
+#    ifndef RGB_MATRIX_TYPING_RENDER_BUDGET_US
+#        define RGB_MATRIX_TYPING_RENDER_BUDGET_US (RGB_MATRIX_RENDER_BUDGET_US / 4)
+#    endif
+// Milliseconds after the last key event that still count as typing
+#    ifndef RGB_MATRIX_TYPING_TIMEOUT
+#        define RGB_MATRIX_TYPING_TIMEOUT 500
+#    endif
+#    ifndef RGB_MATRIX_TARGET_FPS
+#        define RGB_MATRIX_TARGET_FPS 60
+#    endif
+#endif
+
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+#    define RGB_MATRIX_USE_LIMITS(min, max) \
+        uint8_t min = params->led_min;      \
+        uint8_t max = params->led_max;      \
+        if (max > DRIVER_LED_TOTAL) max = DRIVER_LED_TOTAL;
+#elif defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
 #    define RGB_MATRIX_USE_LIMITS(min, max)                        \
         uint8_t min = RGB_MATRIX_LED_PROCESS_LIMIT * params->iter; \
         uint8_t max = min + RGB_MATRIX_LED_PROCESS_LIMIT;          \
@@ -134,6 +156,11 @@ uint8_t     rgb_matrix_get_hue(void);
 uint8_t     rgb_matrix_get_sat(void);
 uint8_t     rgb_matrix_get_val(void);
 
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+rgb_matrix_render_stats_t rgb_matrix_render_stats(void);
+void                      rgb_matrix_render_stats_clear(void);
+#endif
+
 #ifndef RGBLIGHT_ENABLE
 #    define rgblight_toggle rgb_matrix_toggle
 #    define rgblight_enable rgb_matrix_enable
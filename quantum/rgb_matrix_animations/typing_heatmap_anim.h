@@ -29,8 +29,13 @@ void process_rgb_matrix_typing_heatmap(keyrecord_t* record) {
 
 bool TYPING_HEATMAP(effect_params_t* params) {
     // Modified version of RGB_MATRIX_USE_LIMITS to work off of matrix row / col size
+#        ifdef RGB_MATRIX_ADAPTIVE_RENDER
+    uint8_t led_min = params->led_min;
+    uint8_t led_max = params->led_max;
+#        else
     uint8_t led_min = RGB_MATRIX_LED_PROCESS_LIMIT * params->iter;
     uint8_t led_max = led_min + RGB_MATRIX_LED_PROCESS_LIMIT;
+#        endif
     if (led_max > sizeof(rgb_frame_buffer)) led_max = sizeof(rgb_frame_buffer);
 
     if (params->init) {
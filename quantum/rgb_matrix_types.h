@@ -41,8 +41,26 @@ typedef struct PACKED {
     uint8_t     iter;
     led_flags_t flags;
     bool        init;
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+    // The LEDs to render this iteration, sized by the renderer to its time budget
+    uint8_t led_min;
+    uint8_t led_max;
+#endif
 } effect_params_t;
 
+#ifdef RGB_MATRIX_ADAPTIVE_RENDER
+// Adaptive renderer counters, for profiling
+typedef struct {
+    uint32_t frames;    // frames flushed to the driver
+    uint32_t overruns;  // render iterations that took longer than the budget
+    uint16_t fps;       // frames flushed in the last full second
+    uint16_t led_cost;  // estimated render time per LED, in 1/16 us
+    uint8_t  chunk;     // LEDs asked for in the last iteration
+    uint8_t  chunk_min;
+    uint8_t  chunk_max;
+} rgb_matrix_render_stats_t;
+#endif
+
 typedef struct PACKED {
     // Global tick at 20 Hz
     uint32_t tick;
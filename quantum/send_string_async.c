@@ -0,0 +1,240 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <ctype.h>
+#include <string.h>
+#include "quantum.h"
+#include "send_string_async.h"
+
+#ifndef TAP_CODE_DELAY
+#    define TAP_CODE_DELAY 0
+#endif
+#ifndef TAP_HOLD_CAPS_DELAY
+#    define TAP_HOLD_CAPS_DELAY 80
+#endif
+
+/* The longest character, a shifted AltGr key, is three presses and three releases */
+#define SS_ASYNC_MAX_STEPS 6
+
+typedef struct {
+    const char *str;
+    uint8_t     interval;
+    uint8_t     flags;
+    uint8_t     handle;
+} ss_async_entry_t;
+
+typedef struct {
+    uint8_t  code;
+    bool     pressed;
+    uint16_t delay;
+} ss_async_step_t;
+
+static ss_async_entry_t queue[SEND_STRING_ASYNC_QUEUE_SIZE];
+static uint8_t          queue_len   = 0;
+static uint8_t          next_handle = 0;
+
+static ss_async_step_t steps[SS_ASYNC_MAX_STEPS];
+static uint8_t         step_count = 0;
+static uint8_t         step_index = 0;
+static uint16_t        step_timer = 0;
+static uint16_t        step_delay = 0;
+
+/* Keys currently held by the player, released on cancellation */
+static uint8_t held[32];
+
+static inline uint16_t step_interval(uint16_t ms) { return ms > SEND_STRING_ASYNC_STEP_INTERVAL ? ms : SEND_STRING_ASYNC_STEP_INTERVAL; }
+
+static void add_step(uint8_t code, bool pressed, uint16_t delay) { steps[step_count++] = (ss_async_step_t){.code = code, .pressed = pressed, .delay = step_interval(delay)}; }
+
+static char read_char(ss_async_entry_t *entry) { return (entry->flags & SS_ASYNC_PROGMEM) ? pgm_read_byte(entry->str) : *entry->str; }
+
+/** \brief Expands the next character of the current string into steps
+ *
+ * The steps are the same register_code()/unregister_code() calls send_char()
+ * and send_string() make, so the host sees the same report sequence.
+ * Returns false at the end of the string.
+ */
+static bool load_next_char(ss_async_entry_t *entry) {
+    char     ascii_code = read_char(entry);
+    uint16_t delay      = 0;
+    if (!ascii_code) {
+        return false;
+    }
+    step_count = 0;
+    step_index = 0;
+
+    if (ascii_code == SS_QMK_PREFIX) {
+        entry->str++;
+        ascii_code = read_char(entry);
+        if (ascii_code == SS_TAP_CODE) {
+            entry->str++;
+            add_step(read_char(entry), true, 0);
+            add_step(read_char(entry), false, 0);
+        } else if (ascii_code == SS_DOWN_CODE) {
+            entry->str++;
+            add_step(read_char(entry), true, 0);
+        } else if (ascii_code == SS_UP_CODE) {
+            entry->str++;
+            add_step(read_char(entry), false, 0);
+        } else if (ascii_code == SS_DELAY_CODE) {
+            entry->str++;
+            while (isdigit(read_char(entry))) {
+                delay = delay * 10 + read_char(entry) - '0';
+                entry->str++;
+            }
+        }
+    } else {
+#if defined(AUDIO_ENABLE) && defined(SENDSTRING_BELL)
+        if (ascii_code == '\a') {
+            PLAY_SONG(bell_song);
+        } else
+#endif
+        {
+            uint8_t keycode    = pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)ascii_code]);
+            bool    is_shifted = PGM_LOADBIT(ascii_to_shift_lut, (uint8_t)ascii_code);
+            bool    is_altgred = PGM_LOADBIT(ascii_to_altgr_lut, (uint8_t)ascii_code);
+
+            if (is_shifted) {
+                add_step(KC_LSFT, true, 0);
+            }
+            if (is_altgred) {
+                add_step(KC_RALT, true, 0);
+            }
+            add_step(keycode, true, keycode == KC_CAPS ? TAP_HOLD_CAPS_DELAY : TAP_CODE_DELAY);
+            add_step(keycode, false, 0);
+            if (is_altgred) {
+                add_step(KC_RALT, false, 0);
+            }
+            if (is_shifted) {
+                add_step(KC_LSFT, false, 0);
+            }
+        }
+    }
+    entry->str++;
+    if (step_count) {
+        steps[step_count - 1].delay = step_interval(entry->interval);
+    } else {
+        step_timer = timer_read();
+        step_delay = delay + entry->interval;
+    }
+    return true;
+}
+
+static void release_held_keys(void) {
+    for (uint16_t code = 0; code < 256; code++) {
+        if (held[code >> 3] & (1 << (code & 7))) {
+            unregister_code(code);
+        }
+    }
+    memset(held, 0, sizeof(held));
+}
+
+static void queue_remove(uint8_t index) {
+    queue_len--;
+    memmove(&queue[index], &queue[index + 1], (queue_len - index) * sizeof(ss_async_entry_t));
+    if (index == 0) {
+        step_count = 0;
+        step_index = 0;
+        step_delay = 0;
+    }
+}
+
+/** \brief Queues a string to be typed from the main loop
+ *
+ * Returns a handle for send_string_async_cancel(), or SEND_STRING_ASYNC_NONE
+ * when the queue is full.
+ */
+uint8_t send_string_async_with_delay(const char *str, uint8_t interval, uint8_t flags) {
+    if (queue_len == SEND_STRING_ASYNC_QUEUE_SIZE) {
+        return SEND_STRING_ASYNC_NONE;
+    }
+    uint8_t index = queue_len;
+    if (flags & SS_ASYNC_PRIORITY) {
+        // Never interrupt the string being typed, but go ahead of normal ones
+        for (index = queue_len ? 1 : 0; index < queue_len && (queue[index].flags & SS_ASYNC_PRIORITY); index++)
+            ;
+        memmove(&queue[index + 1], &queue[index], (queue_len - index) * sizeof(ss_async_entry_t));
+    }
+    if (++next_handle == SEND_STRING_ASYNC_NONE) {
+        next_handle++;
+    }
+    queue[index] = (ss_async_entry_t){.str = str, .interval = interval, .flags = flags, .handle = next_handle};
+    queue_len++;
+    return next_handle;
+}
+
+uint8_t send_string_async(const char *str) { return send_string_async_with_delay(str, 0, 0); }
+
+uint8_t send_string_async_P(const char *str) { return send_string_async_with_delay(str, 0, SS_ASYNC_PROGMEM); }
+
+/** \brief Removes a string from the queue
+ *
+ * A string that is being typed stops at once and releases the keys it holds.
+ */
+bool send_string_async_cancel(uint8_t handle) {
+    for (uint8_t i = 0; i < queue_len; i++) {
+        if (queue[i].handle == handle) {
+            if (i == 0) {
+                release_held_keys();
+            }
+            queue_remove(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void send_string_async_cancel_all(void) {
+    if (queue_len) {
+        release_held_keys();
+        queue_len  = 0;
+        step_count = 0;
+        step_index = 0;
+        step_delay = 0;
+    }
+}
+
+bool send_string_async_is_busy(void) { return queue_len; }
+
+/** \brief Types at most one report of the current string
+ *
+ * Called from matrix_scan_quantum(), so typing never blocks scanning.
+ */
+void send_string_async_task(void) {
+    if (!queue_len || timer_elapsed(step_timer) < step_delay) {
+        return;
+    }
+    while (step_index == step_count) {
+        if (!load_next_char(&queue[0])) {
+            queue_remove(0);
+            return;
+        }
+        if (step_delay && timer_elapsed(step_timer) < step_delay) {
+            return;
+        }
+    }
+
+    ss_async_step_t *step = &steps[step_index++];
+    if (step->pressed) {
+        register_code(step->code);
+        held[step->code >> 3] |= 1 << (step->code & 7);
+    } else {
+        unregister_code(step->code);
+        held[step->code >> 3] &= ~(1 << (step->code & 7));
+    }
+    step_timer = timer_read();
+    step_delay = step->delay;
+}
@@ -0,0 +1,52 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Number of strings that can be waiting to be typed, including the current one */
+#ifndef SEND_STRING_ASYNC_QUEUE_SIZE
+#    define SEND_STRING_ASYNC_QUEUE_SIZE 4
+#endif
+
+/* Minimum time in milliseconds between two reports, one USB frame by default */
+#ifndef SEND_STRING_ASYNC_STEP_INTERVAL
+#    define SEND_STRING_ASYNC_STEP_INTERVAL 1
+#endif
+
+/* Handle returned when a string could not be queued */
+#define SEND_STRING_ASYNC_NONE 0
+
+enum send_string_async_flags {
+    SS_ASYNC_PROGMEM  = (1 << 0),  // string is stored in PROGMEM
+    SS_ASYNC_PRIORITY = (1 << 1),  // type before any normal string that has not started yet
+};
+
+#define SEND_STRING_ASYNC(string) send_string_async_P(PSTR(string))
+#define SEND_STRING_ASYNC_DELAY(string, interval) send_string_async_with_delay(PSTR(string), interval, SS_ASYNC_PROGMEM)
+
+/* Strings are typed from the main loop and are not copied, so they must stay valid until typed. */
+uint8_t send_string_async(const char *str);
+uint8_t send_string_async_P(const char *str);
+uint8_t send_string_async_with_delay(const char *str, uint8_t interval, uint8_t flags);
+
+bool send_string_async_cancel(uint8_t handle);
+void send_string_async_cancel_all(void);
+bool send_string_async_is_busy(void);
+
+void send_string_async_task(void);
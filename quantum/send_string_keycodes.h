@@ -391,6 +391,16 @@
 #define SS_UP_CODE 3
 #define SS_DELAY_CODE 4
 
+/* Bytecode produced by send_string_compile() and run by send_bytecode().
+ * Any other byte taps that keycode.
+ */
+#define SS_BC_END 0x00     // end of bytecode
+#define SS_BC_MODS 0x01    // <mods>: hold exactly these modifiers
+#define SS_BC_DOWN 0x02    // <keycode>: press
+#define SS_BC_UP 0x03      // <keycode>: release
+#define SS_BC_REPEAT 0xE8  // <count> <keycode>: tap count times
+#define SS_BC_DELAY 0xE9   // <ms low> <ms high>: wait
+
 #define SS_TAP(keycode) "\1\1" SYMBOL_STR(keycode)
 #define SS_DOWN(keycode) "\1\2" SYMBOL_STR(keycode)
 #define SS_UP(keycode) "\1\3" SYMBOL_STR(keycode)
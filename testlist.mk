@@ -1,5 +1,6 @@
 TEST_LIST = $(notdir $(patsubst %/rules.mk,%,$(wildcard $(ROOT_DIR)/tests/*/rules.mk)))
-FULL_TESTS := $(TEST_LIST)
+BENCH_LIST = $(notdir $(patsubst %/rules.mk,%,$(wildcard $(ROOT_DIR)/tests/bench/*/rules.mk)))
+FULL_TESTS := $(TEST_LIST) $(addprefix bench/,$(BENCH_LIST))
 
 include $(ROOT_DIR)/quantum/serial_link/tests/testlist.mk
 
@@ -14,4 +15,5 @@ define VALIDATE_TEST_LIST
 endef
 
 
-$(eval $(call VALIDATE_TEST_LIST,$(firstword $(TEST_LIST)),$(wordlist 2,9999,$(TEST_LIST))))
\ No newline at end of file
+$(eval $(call VALIDATE_TEST_LIST,$(firstword $(TEST_LIST)),$(wordlist 2,9999,$(TEST_LIST))))
+$(eval $(call VALIDATE_TEST_LIST,$(firstword $(BENCH_LIST)),$(wordlist 2,9999,$(BENCH_LIST))))
\ No newline at end of file
@@ -0,0 +1,205 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+extern "C" {
+#include "mixer.h"
+}
+
+namespace {
+const uint16_t HIGH     = 4095;
+const uint16_t PER_TICK = SYNTH_SAMPLE_RATE / SYNTH_TICK_RATE;
+
+// Amplitude of one frequency in the samples, from 0 to 1 of full scale, through a Hann window so that nearby notes do not leak in
+double amplitude(const std::vector<uint16_t>& samples, double frequency) {
+    double re = 0, im = 0, gain = 0;
+    for (size_t i = 0; i < samples.size(); i++) {
+        double window = 0.5 - 0.5 * std::cos(2 * M_PI * i / samples.size());
+        double value  = (samples[i] - HIGH / 2.0) / (HIGH / 2.0) * window;
+        double angle  = 2 * M_PI * frequency * i / SYNTH_SAMPLE_RATE;
+        re += value * std::cos(angle);
+        im += value * std::sin(angle);
+        gain += window;
+    }
+    return 2 * std::sqrt(re * re + im * im) / gain;
+}
+}  // namespace
+
+class AudioMixer : public testing::Test {
+   protected:
+    void SetUp() override {
+        mixer_stop_all();
+        mixer_set_waveform(MIXER_SINE);
+        mixer_envelope_t envelope = {.attack = 2, .decay = 0, .sustain = 65535, .release = 10};
+        mixer_set_envelope(&envelope);
+    }
+
+    std::vector<uint16_t> render(uint32_t ticks) {
+        std::vector<uint16_t> samples(ticks * PER_TICK);
+        mixer_render(samples.data(), samples.size(), HIGH);
+        return samples;
+    }
+};
+
+TEST_F(AudioMixer, SilenceIsHalfScale) {
+    for (uint16_t sample : render(10)) {
+        EXPECT_EQ(sample, SYNTH_SILENCE(HIGH));
+    }
+    EXPECT_FALSE(mixer_is_active());
+}
+
+TEST_F(AudioMixer, ChordSoundsAllNotesAtOnce) {
+    const double chord[] = {261.63, 329.63, 392.00};
+    for (double frequency : chord) {
+        mixer_note_on(SYNTH_HZ(frequency), 15);
+    }
+    render(10);
+
+    // Every window holds all three notes at full volume, rather than one after the other
+    for (int window = 0; window < 3; window++) {
+        std::vector<uint16_t> samples = render(100);
+        for (double frequency : chord) {
+            EXPECT_NEAR(amplitude(samples, frequency), 1.0 / MIXER_HEADROOM, 0.03) << frequency << " Hz in window " << window;
+        }
+        EXPECT_LT(amplitude(samples, 440), 0.03);
+    }
+}
+
+TEST_F(AudioMixer, WaveformsHaveTheirShape) {
+    mixer_envelope_t envelope = {.attack = 0, .decay = 0, .sustain = 65535, .release = 0};
+    mixer_set_envelope(&envelope);
+    const double full = 1.0 / MIXER_HEADROOM;
+
+    struct {
+        mixer_waveform_t waveform;
+        double           fundamental;
+        double           third_harmonic;
+    } shapes[] = {
+        {MIXER_SINE, full, 0},
+        {MIXER_SQUARE, full * 4 / M_PI, full * 4 / M_PI / 3},
+        {MIXER_TRIANGLE, full * 8 / (M_PI * M_PI), full * 8 / (M_PI * M_PI) / 9},
+    };
+    for (auto& shape : shapes) {
+        mixer_stop_all();
+        mixer_set_waveform(shape.waveform);
+        mixer_note_on(SYNTH_HZ(500), 15);
+        std::vector<uint16_t> samples = render(100);
+        EXPECT_NEAR(amplitude(samples, 500), shape.fundamental, 0.01) << shape.waveform;
+        EXPECT_NEAR(amplitude(samples, 1500), shape.third_harmonic, 0.01) << shape.waveform;
+    }
+}
+
+TEST_F(AudioMixer, EnvelopeRisesDecaysAndReleases) {
+    mixer_envelope_t envelope = {.attack = 10, .decay = 20, .sustain = 32768, .release = 40};
+    mixer_set_envelope(&envelope);
+    const double peak = 1.0 / MIXER_HEADROOM;
+
+    mixer_note_on(SYNTH_HZ(1000), 15);
+    EXPECT_NEAR(amplitude(render(5), 1000), peak * 0.25, 0.02);
+    EXPECT_NEAR(amplitude(render(5), 1000), peak * 0.75, 0.02);
+    render(20);
+    EXPECT_NEAR(amplitude(render(10), 1000), peak / 2, 0.01);
+
+    mixer_note_off(SYNTH_HZ(1000));
+    EXPECT_TRUE(mixer_is_active());
+    EXPECT_NEAR(amplitude(render(20), 1000), peak * 3 / 8, 0.02);
+    render(21);
+    EXPECT_FALSE(mixer_is_active());
+    for (uint16_t sample : render(1)) {
+        EXPECT_EQ(sample, SYNTH_SILENCE(HIGH));
+    }
+}
+
+TEST_F(AudioMixer, VolumeScalesThePeak) {
+    mixer_note_on(SYNTH_HZ(1000), 5);
+    render(5);
+    EXPECT_NEAR(amplitude(render(20), 1000), 1.0 / MIXER_HEADROOM / 3, 0.01);
+}
+
+TEST_F(AudioMixer, ReleasedVoicesAreStolenFirst) {
+    for (int i = 0; i < MIXER_VOICES; i++) {
+        mixer_note_on(SYNTH_HZ(200 + 100 * i), 15);
+        render(1);
+    }
+    mixer_note_off(SYNTH_HZ(300));
+    render(1);
+
+    mixer_note_on(SYNTH_HZ(1000), 15);
+    EXPECT_TRUE(mixer_is_playing(SYNTH_HZ(200)));
+    EXPECT_FALSE(mixer_is_playing(SYNTH_HZ(300)));
+    EXPECT_TRUE(mixer_is_playing(SYNTH_HZ(1000)));
+}
+
+TEST_F(AudioMixer, OldestVoiceIsStolenWhenAllAreHeld) {
+    for (int i = 0; i < MIXER_VOICES; i++) {
+        mixer_note_on(SYNTH_HZ(200 + 100 * i), 15);
+    }
+    // Playing a held note again makes it the newest
+    mixer_note_on(SYNTH_HZ(200), 15);
+
+    mixer_note_on(SYNTH_HZ(1000), 15);
+    EXPECT_TRUE(mixer_is_playing(SYNTH_HZ(200)));
+    EXPECT_FALSE(mixer_is_playing(SYNTH_HZ(300)));
+    EXPECT_TRUE(mixer_is_playing(SYNTH_HZ(1000)));
+}
+
+TEST_F(AudioMixer, FullChordIsClippedNotWrapped) {
+    mixer_set_waveform(MIXER_SQUARE);
+    for (int i = 0; i < MIXER_VOICES; i++) {
+        mixer_note_on(SYNTH_HZ(100), 15);
+        mixer_note_on(SYNTH_HZ(100 + i), 15);
+    }
+    bool clipped = false;
+    for (uint16_t sample : render(50)) {
+        ASSERT_LE(sample, HIGH);
+        clipped |= sample == HIGH - 1 || sample == 0;
+    }
+    EXPECT_TRUE(clipped);
+}
+
+TEST_F(AudioMixer, DacSamplesStayWithin12Bits) {
+    // The ARM driver renders for the DACs with the default DAC_SAMPLE_MAX capped like this
+    const uint16_t high = SYNTH_DAC_HIGH(65535U);
+    EXPECT_EQ(SYNTH_DAC_HIGH(2000U), 2000);
+
+    mixer_set_waveform(MIXER_SQUARE);
+    for (int i = 0; i < MIXER_VOICES; i++) {
+        mixer_note_on(SYNTH_HZ(100 + 50 * i), 15);
+    }
+    std::vector<uint16_t> samples(50 * PER_TICK);
+    mixer_render(samples.data(), samples.size(), high);
+    for (uint16_t sample : samples) {
+        ASSERT_LT(sample, 1 << 12);
+        ASSERT_LT(high - sample, 1 << 12);
+    }
+}
+
+TEST_F(AudioMixer, RenderCost) {
+    for (int i = 0; i < MIXER_VOICES; i++) {
+        mixer_note_on(SYNTH_HZ(200 + 100 * i), 15);
+    }
+    std::vector<uint16_t> samples(SYNTH_SAMPLE_RATE);
+    auto                  start = std::chrono::steady_clock::now();
+    mixer_render(samples.data(), samples.size(), HIGH);
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << MIXER_VOICES << " voices: " << elapsed.count() / samples.size() << " ns per sample" << std::endl;
+    EXPECT_TRUE(mixer_is_active());
+}
@@ -0,0 +1,19 @@
+# Copyright 2017 Fred Sundvik
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+CUSTOM_MATRIX=yes
+OPT_DEFS += -DAUDIO_SYNTH_ENABLE
+# The synth without a driver, rendering to memory
+SRC += $(QUANTUM_DIR)/audio/synth.c $(QUANTUM_DIR)/audio/voices_synth.c $(QUANTUM_DIR)/audio/luts.c
@@ -0,0 +1,213 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+extern "C" {
+#include "audio.h"
+#include "synth.h"
+}
+
+namespace {
+const uint16_t HIGH = 4095;
+
+struct Song {
+    const char*        name;
+    std::vector<std::array<float, 2>> notes;
+};
+
+#define SONG_CASE(song) \
+    { #song, SONG(song) }
+
+// Every song in song_list.h that still has notes
+const std::vector<Song> songs = {
+    SONG_CASE(STARTUP_SOUND),      SONG_CASE(GOODBYE_SOUND),     SONG_CASE(PLANCK_SOUND),       SONG_CASE(PREONIC_SOUND),       SONG_CASE(QWERTY_SOUND),         SONG_CASE(COLEMAK_SOUND),       SONG_CASE(DVORAK_SOUND),      SONG_CASE(WORKMAN_SOUND),         SONG_CASE(PLOVER_SOUND),          SONG_CASE(PLOVER_GOODBYE_SOUND), SONG_CASE(MUSIC_ON_SOUND),       SONG_CASE(AUDIO_ON_SOUND),
+    SONG_CASE(AUDIO_OFF_SOUND),    SONG_CASE(MUSIC_OFF_SOUND),   SONG_CASE(VOICE_CHANGE_SOUND), SONG_CASE(CHROMATIC_SOUND),     SONG_CASE(MAJOR_SOUND),          SONG_CASE(MINOR_SOUND),         SONG_CASE(GUITAR_SOUND),      SONG_CASE(VIOLIN_SOUND),          SONG_CASE(CAPS_LOCK_ON_SOUND),    SONG_CASE(CAPS_LOCK_OFF_SOUND),  SONG_CASE(SCROLL_LOCK_ON_SOUND), SONG_CASE(SCROLL_LOCK_OFF_SOUND),
+    SONG_CASE(NUM_LOCK_ON_SOUND),  SONG_CASE(NUM_LOCK_OFF_SOUND), SONG_CASE(AG_NORM_SOUND),     SONG_CASE(AG_SWAP_SOUND),       SONG_CASE(CLUEBOARD_SOUND),      SONG_CASE(TERMINAL_SOUND),      SONG_CASE(CAMPANELLA),        SONG_CASE(FANTASIE_IMPROMPTU),    SONG_CASE(NOCTURNE_OP_9_NO_1),    SONG_CASE(USSR_ANTHEM),
+};
+
+/* What the synth is meant to play, in double precision: the frequency of
+ * channel 1 for each tick, and the square wave of that at SYNTH_SAMPLE_RATE. */
+std::vector<double> reference_ticks(const std::vector<std::array<float, 2>>& notes, uint8_t tempo) {
+    std::vector<double> ticks;
+    for (size_t i = 0; i < notes.size(); i++) {
+        double frequency = notes[i][0] < 30.52 ? 0 : notes[i][0];
+        double length    = notes[i][1] * 8.0 * tempo / 100 * SYNTH_TICK_RATE / 1000;
+        ticks.insert(ticks.end(), (size_t)length, frequency);
+        if (i + 1 < notes.size()) {
+            double next = notes[i + 1][0] < 30.52 ? 0 : notes[i + 1][0];
+            ticks.insert(ticks.end(), SYNTH_REST_TICKS, next == frequency ? 0 : frequency);
+        }
+    }
+    return ticks;
+}
+
+std::vector<uint16_t> reference_samples(const std::vector<double>& ticks) {
+    const size_t          per_tick = SYNTH_SAMPLE_RATE / SYNTH_TICK_RATE;
+    std::vector<uint16_t> samples;
+    double                phase = 0;
+    for (double frequency : ticks) {
+        for (size_t i = 0; i < per_tick; i++) {
+            phase += frequency / SYNTH_SAMPLE_RATE;
+            phase -= std::floor(phase);
+            samples.push_back(frequency == 0 ? SYNTH_SILENCE(HIGH) : phase < TIMBRE_50 ? HIGH : 0);
+        }
+    }
+    return samples;
+}
+
+void play(const Song& song) {
+    synth_stop_all();
+    synth_play_notes(reinterpret_cast<float(*)[][2]>(const_cast<std::array<float, 2>*>(song.notes.data())), song.notes.size(), false);
+}
+
+// Renders one tick at a time until the song is over, keeping the frequency of channel 1 for each tick
+void render_song(const Song& song, std::vector<double>& ticks, std::vector<uint16_t>& channel_1, std::vector<uint16_t>& channel_2) {
+    const uint16_t per_tick = SYNTH_SAMPLE_RATE / SYNTH_TICK_RATE;
+    play(song);
+    while (synth_is_active()) {
+        channel_1.resize(channel_1.size() + per_tick);
+        channel_2.resize(channel_2.size() + per_tick);
+        synth_render(&channel_1[channel_1.size() - per_tick], &channel_2[channel_2.size() - per_tick], per_tick, HIGH);
+        ticks.push_back(synth_channels[0].frequency / 65536.0);
+    }
+}
+void expect_timeline(const std::vector<double>& ticks, const std::vector<double>& expected, const char* name) {
+    ASSERT_EQ(ticks.size(), expected.size()) << name;
+    for (size_t i = 0; i < ticks.size(); i++) {
+        ASSERT_NEAR(ticks[i], expected[i], expected[i] * 0.001) << name << " tick " << i;
+    }
+}
+}  // namespace
+
+class AudioSynth : public testing::Test {
+   protected:
+    void SetUp() override {
+        set_voice(default_voice);
+        set_tempo(TEMPO_DEFAULT);
+        synth_stop_all();
+    }
+
+    // Channel frequencies in Hz after one more tick
+    std::pair<double, double> tick(void) {
+        synth_tick();
+        return {synth_channels[0].frequency / 65536.0, synth_channels[1].frequency / 65536.0};
+    }
+};
+
+TEST_F(AudioSynth, SongsMatchReference) {
+    for (const Song& song : songs) {
+        std::vector<double>   ticks;
+        std::vector<uint16_t> channel_1, channel_2;
+        render_song(song, ticks, channel_1, channel_2);
+
+        std::vector<double>   expected_ticks   = reference_ticks(song.notes, TEMPO_DEFAULT);
+        std::vector<uint16_t> expected_samples = reference_samples(expected_ticks);
+
+        expect_timeline(ticks, expected_ticks, song.name);
+
+        // The edges of the square waves may only be a sample apart
+        size_t mismatches = 0;
+        for (size_t i = 0; i < channel_1.size(); i++) {
+            if (channel_1[i] != expected_samples[i]) {
+                mismatches++;
+                bool near_edge = (i > 0 && expected_samples[i - 1] != expected_samples[i]) || (i + 1 < channel_1.size() && expected_samples[i + 1] != expected_samples[i]);
+                ASSERT_TRUE(near_edge) << song.name << " sample " << i;
+            }
+            // Nothing else plays, so the second output is the other end of the speaker
+            uint16_t other_end = ticks[i / (SYNTH_SAMPLE_RATE / SYNTH_TICK_RATE)] > 0 ? HIGH - channel_1[i] : SYNTH_SILENCE(HIGH);
+            ASSERT_EQ(channel_2[i], other_end) << song.name << " sample " << i;
+        }
+        EXPECT_LT(mismatches, channel_1.size() / 100) << song.name;
+    }
+}
+
+TEST_F(AudioSynth, TempoScalesTheTimeline) {
+    const Song& song = songs[0];
+    set_tempo(TEMPO_DEFAULT * 2);
+
+    std::vector<double>   ticks;
+    std::vector<uint16_t> channel_1, channel_2;
+    render_song(song, ticks, channel_1, channel_2);
+    expect_timeline(ticks, reference_ticks(song.notes, TEMPO_DEFAULT * 2), song.name);
+}
+
+TEST_F(AudioSynth, HeldNotesGoToBothChannels) {
+    synth_play_note(440, 0xF);
+    EXPECT_EQ(tick(), std::make_pair(440.0, 0.0));
+
+    synth_play_note(880, 0xF);
+    EXPECT_EQ(tick(), std::make_pair(880.0, 440.0));
+
+    synth_stop_note(880);
+    EXPECT_EQ(tick(), std::make_pair(440.0, 0.0));
+
+    synth_stop_note(440);
+    EXPECT_FALSE(synth_is_active());
+    EXPECT_EQ(tick(), std::make_pair(0.0, 0.0));
+}
+
+TEST_F(AudioSynth, SilentChannelsRestAtTheMixerSilence) {
+    std::vector<uint16_t> channel_1(10), channel_2(10);
+    synth_render(channel_1.data(), channel_2.data(), channel_1.size(), HIGH);
+    EXPECT_EQ(channel_1, std::vector<uint16_t>(10, SYNTH_SILENCE(HIGH)));
+    EXPECT_EQ(channel_2, std::vector<uint16_t>(10, SYNTH_SILENCE(HIGH)));
+}
+
+TEST_F(AudioSynth, StoppingAnUnknownNoteKeepsTheOthers) {
+    synth_play_note(440, 0xF);
+    synth_stop_note(500);
+    EXPECT_TRUE(synth_is_active());
+    EXPECT_EQ(tick(), std::make_pair(440.0, 0.0));
+}
+
+TEST_F(AudioSynth, GlissandoMatchesReference) {
+    // This voice slides between notes and adds vibrato only after a while
+    set_voice(delayed_vibrato);
+    synth_play_note(220, 0xF);
+    tick();
+    synth_play_note(880, 0xF);
+
+    double expected = 220;
+    for (int i = 0; i < 100; i++) {
+        if (expected < 880 * pow(2, -440 / 880.0 / 24)) {
+            expected *= pow(2, 440 / expected / 24);
+        } else {
+            expected = 880;
+        }
+        ASSERT_NEAR(tick().first, expected, expected * 0.002) << "tick " << i;
+    }
+    EXPECT_EQ(synth_channels[0].frequency, SYNTH_HZ(880));
+}
+
+TEST_F(AudioSynth, RenderCost) {
+    const uint16_t        samples = 256;
+    std::vector<uint16_t> channel_1(samples), channel_2(samples);
+    synth_play_notes(reinterpret_cast<float(*)[][2]>(const_cast<std::array<float, 2>*>(songs[0].notes.data())), songs[0].notes.size(), true);
+
+    const int blocks = 20000;
+    auto      start  = std::chrono::steady_clock::now();
+    for (int i = 0; i < blocks; i++) {
+        synth_render(channel_1.data(), channel_2.data(), samples, HIGH);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Rendering: " << elapsed.count() / blocks / samples << " ns per sample, " << elapsed.count() / blocks << " ns per " << samples << " samples" << std::endl;
+}
@@ -169,13 +169,14 @@ TEST_F(KeyPress, PressPlusEqualDontReleaseBeforePress) {
 
     release_key(1, 1);  // KC_PLS
     // BUG: Should really still return KC_EQL, but this is fine too
-    // It's also called twice for some reason
-    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(2);
+    // The duplicate empty report is dropped by the host
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
     run_one_scan_loop();
     testing::Mock::VerifyAndClearExpectations(&driver);
 
     release_key(0, 1);  // KC_EQL
-    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    // The report is already empty
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
     run_one_scan_loop();
     testing::Mock::VerifyAndClearExpectations(&driver);
 }
@@ -232,8 +233,7 @@ TEST_F(KeyPress, PressEqualPlusDontReleaseBeforePress) {
     testing::Mock::VerifyAndClearExpectations(&driver);
 
     release_key(1, 1);  // KC_PLUS
-    // This report is not needed
-    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    // The unneeded KC_LSFT report is dropped as a duplicate
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
     run_one_scan_loop();
     testing::Mock::VerifyAndClearExpectations(&driver);
@@ -0,0 +1,87 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::ElementsAre;
+
+namespace {
+std::vector<uint8_t> encoded_keys(const report_keys_t& keys) {
+    report_keyboard_t report = {};
+    report_keys_encode(&keys, &report);
+    return std::vector<uint8_t>(report.keys, report.keys + KEYBOARD_REPORT_KEYS);
+}
+}  // namespace
+
+TEST(ReportKeys, AddedKeysArePresent) {
+    report_keys_t keys = {};
+    report_keys_add(&keys, KC_A);
+    report_keys_add(&keys, KC_Z);
+    EXPECT_TRUE(report_keys_has(&keys, KC_A));
+    EXPECT_TRUE(report_keys_has(&keys, KC_Z));
+    EXPECT_FALSE(report_keys_has(&keys, KC_B));
+    EXPECT_EQ(report_keys_count(&keys), 2);
+}
+
+TEST(ReportKeys, AddingAKeyTwiceKeepsOneEntry) {
+    report_keys_t keys = {};
+    report_keys_add(&keys, KC_A);
+    report_keys_add(&keys, KC_A);
+    EXPECT_EQ(report_keys_count(&keys), 1);
+    EXPECT_THAT(encoded_keys(keys), ElementsAre(KC_A, 0, 0, 0, 0, 0));
+}
+
+TEST(ReportKeys, DeletingAKeyThatIsNotPressedDoesNothing) {
+    report_keys_t keys = {};
+    report_keys_add(&keys, KC_A);
+    report_keys_del(&keys, KC_B);
+    EXPECT_EQ(report_keys_count(&keys), 1);
+    EXPECT_THAT(encoded_keys(keys), ElementsAre(KC_A, 0, 0, 0, 0, 0));
+}
+
+TEST(ReportKeys, ReleasedSlotIsReusedByTheNextKey) {
+    report_keys_t keys = {};
+    report_keys_add(&keys, KC_A);
+    report_keys_add(&keys, KC_B);
+    report_keys_add(&keys, KC_C);
+    report_keys_del(&keys, KC_B);
+    EXPECT_THAT(encoded_keys(keys), ElementsAre(KC_A, 0, KC_C, 0, 0, 0));
+    report_keys_add(&keys, KC_D);
+    EXPECT_THAT(encoded_keys(keys), ElementsAre(KC_A, KC_D, KC_C, 0, 0, 0));
+}
+
+TEST(ReportKeys, SeventhKeyIsTrackedButNotReported) {
+    report_keys_t keys = {};
+    for (uint8_t k = KC_A; k <= KC_G; k++) {
+        report_keys_add(&keys, k);
+    }
+    EXPECT_EQ(report_keys_count(&keys), 7);
+    EXPECT_TRUE(report_keys_has(&keys, KC_G));
+    EXPECT_THAT(encoded_keys(keys), ElementsAre(KC_A, KC_B, KC_C, KC_D, KC_E, KC_F));
+    report_keys_del(&keys, KC_G);
+    EXPECT_EQ(report_keys_count(&keys), 6);
+    EXPECT_THAT(encoded_keys(keys), ElementsAre(KC_A, KC_B, KC_C, KC_D, KC_E, KC_F));
+}
+
+TEST(ReportKeys, ClearRemovesEverything) {
+    report_keys_t keys = {};
+    report_keys_add(&keys, KC_A);
+    report_keys_add(&keys, KC_NONUS_BSLASH);
+    report_keys_clear(&keys);
+    EXPECT_EQ(report_keys_count(&keys), 0);
+    EXPECT_FALSE(report_keys_has(&keys, KC_A));
+    EXPECT_THAT(encoded_keys(keys), ElementsAre(0, 0, 0, 0, 0, 0));
+}
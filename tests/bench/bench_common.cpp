@@ -0,0 +1,132 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bench_common.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <regex>
+
+extern "C" {
+#include "action_tapping.h"
+#include "host.h"
+}
+
+namespace {
+uint32_t reports = 0;
+
+uint8_t keyboard_leds(void) { return 0; }
+void    send_keyboard(report_keyboard_t* report) { reports++; }
+void    send_mouse(report_mouse_t* report) { reports++; }
+void    send_system(uint16_t data) { reports++; }
+void    send_consumer(uint16_t data) { reports++; }
+
+host_driver_t counting_driver = {keyboard_leds, send_keyboard, send_mouse, send_system, send_consumer};
+
+uint32_t env_number(const char* name, uint32_t fallback) {
+    const char* value = getenv(name);
+    return value && *value ? strtoul(value, nullptr, 10) : fallback;
+}
+
+std::string bench_name(void) {
+    const char* name = getenv("BENCH_NAME");
+    return name ? name : "bench";
+}
+
+// Case name to ns per iteration, from the JSON lines of an earlier run of this benchmark
+std::map<std::string, double> load_baseline(void) {
+    std::map<std::string, double> baseline;
+    const char*                   path = getenv("BENCH_BASELINE");
+    if (!path) {
+        return baseline;
+    }
+    std::ifstream file(path);
+    std::string   line;
+    std::regex    pattern("\"bench\":\"([^\"]*)\",\"case\":\"([^\"]*)\".*\"ns_per_iteration\":([0-9.]+)");
+    std::smatch   match;
+    while (std::getline(file, line)) {
+        if (std::regex_search(line, match, pattern) && match[1] == bench_name()) {
+            baseline[match[2]] = std::stod(match[3]);
+        }
+    }
+    return baseline;
+}
+
+void record(const BenchResult& result) {
+    static std::map<std::string, double> baseline = load_baseline();
+
+    std::cout << result.name << ": " << result.ns_per_iteration << " ns, " << (uint64_t)(1e9 / result.ns_per_iteration) << "/s, " << result.reports_per_1000 << " reports per 1000" << std::endl;
+
+    if (const char* path = getenv("BENCH_OUTPUT")) {
+        std::ofstream out(path, std::ios::app);
+        out << "{\"bench\":\"" << bench_name() << "\",\"case\":\"" << result.name << "\",\"iterations\":" << result.iterations << ",\"ns_per_iteration\":" << result.ns_per_iteration << ",\"per_second\":" << (uint64_t)(1e9 / result.ns_per_iteration) << ",\"reports_per_1000\":" << result.reports_per_1000 << "}" << std::endl;
+    }
+
+    auto previous = baseline.find(result.name);
+    if (previous != baseline.end()) {
+        double limit = previous->second * (100 + env_number("BENCH_TOLERANCE", 10)) / 100;
+        EXPECT_LE(result.ns_per_iteration, limit) << result.name << " was " << previous->second << " ns in the baseline";
+    }
+}
+}  // namespace
+
+void BenchFixture::SetUpTestCase() {
+    host_set_driver(&counting_driver);
+    keyboard_init();
+}
+
+BenchFixture::~BenchFixture() {
+    clear_all_keys();
+    layer_clear();
+    for (uint16_t i = 0; i < TAPPING_TERM + 10; i++) {
+        scan();
+    }
+}
+
+BenchResult BenchFixture::measure(const std::string& name, const std::function<void(uint32_t)>& body) {
+    const std::chrono::duration<double, std::milli> min_time(env_number("BENCH_MIN_TIME", 200));
+    std::chrono::duration<double, std::nano>        elapsed(0);
+    uint32_t                                        counter    = 0;
+    uint64_t                                        iterations = 16;
+
+    // Grow the batch until one takes long enough to time
+    while (true) {
+        reports    = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; i++) {
+            body(counter++);
+        }
+        elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed >= min_time) {
+            break;
+        }
+        iterations = std::max<uint64_t>(iterations * 2, iterations * 1.2 * min_time / elapsed);
+    }
+
+    BenchResult result = {name, iterations, elapsed.count() / iterations, reports * 1000.0 / iterations};
+    record(result);
+    return result;
+}
+
+BenchResult BenchFixture::measure_scans(const std::string& name, const std::function<void(uint32_t)>& body) {
+    return measure(name, [&body](uint32_t i) {
+        body(i);
+        scan();
+    });
+}
@@ -0,0 +1,77 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "quantum.h"
+#include "action_tapping.h"
+#include "test_matrix.h"
+void advance_time(uint32_t ms);
+}
+
+struct BenchResult {
+    std::string name;
+    uint64_t    iterations;
+    double      ns_per_iteration;
+    // Reports sent to the host per 1000 iterations
+    double reports_per_1000;
+};
+
+/* Runs the code under test on the native build and records how long one
+ * iteration takes. Reports go to a host driver that only counts them, so
+ * the numbers are not dominated by the mocks the tests use.
+ *
+ * Each result is printed and appended as a JSON line to $BENCH_OUTPUT. With
+ * $BENCH_BASELINE pointing at the output of an earlier run, a case that got
+ * more than $BENCH_TOLERANCE percent (default 10) slower fails.
+ */
+class BenchFixture : public testing::Test {
+   public:
+    static void SetUpTestCase();
+
+   protected:
+    ~BenchFixture();
+
+    // One scan loop at 1 ms per scan, like TestFixture::run_one_scan_loop()
+    static void scan(void) {
+        keyboard_task();
+        advance_time(1);
+    }
+
+    // Presses and releases the keys on `rows` rows from `first_row` in turn, one edge per call
+    static void toggle_in_turn(uint32_t i, uint8_t first_row = 0, uint8_t rows = MATRIX_ROWS) {
+        uint16_t key = (i / 2) % (rows * MATRIX_COLS);
+        uint8_t  row = first_row + key / MATRIX_COLS;
+        if (i & 1) {
+            release_key(key % MATRIX_COLS, row);
+        } else {
+            press_key(key % MATRIX_COLS, row);
+        }
+    }
+
+    /* Calls body with the iteration number until it has run for at least
+     * $BENCH_MIN_TIME ms (default 200) of wall time. */
+    BenchResult measure(const std::string& name, const std::function<void(uint32_t)>& body);
+
+    // Measures scan loops while body toggles keys before each one
+    BenchResult measure_scans(const std::string& name, const std::function<void(uint32_t)>& body = [](uint32_t) {});
+};
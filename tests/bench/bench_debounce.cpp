@@ -0,0 +1,68 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bench_common.hpp"
+#include <random>
+
+extern "C" {
+#include "debounce.h"
+}
+
+namespace {
+matrix_row_t raw[MATRIX_ROWS];
+matrix_row_t cooked[MATRIX_ROWS];
+
+void debounce_scan(bool changed) {
+    debounce(raw, cooked, MATRIX_ROWS, changed);
+    advance_time(1);
+}
+}  // namespace
+
+/* Calls the algorithm picked by DEBOUNCE_TYPE directly, the way the matrix
+ * scanning code of a keyboard does, with different kinds of raw input. */
+class Debounce : public BenchFixture {
+   public:
+    static void SetUpTestCase() {
+        BenchFixture::SetUpTestCase();
+        debounce_init(MATRIX_ROWS);
+    }
+};
+
+TEST_F(Debounce, NothingChanges) { measure("quiet", [](uint32_t i) { debounce_scan(false); }); }
+
+TEST_F(Debounce, CleanKeyPresses) {
+    // A key goes down or up every 10 ms, without bouncing
+    measure("typing", [](uint32_t i) {
+        bool changed = i % 10 == 0;
+        if (changed) {
+            uint16_t key = (i / 10) % (MATRIX_ROWS * MATRIX_COLS);
+            raw[key / MATRIX_COLS] ^= (matrix_row_t)1 << (key % MATRIX_COLS);
+        }
+        debounce_scan(changed);
+    });
+}
+
+TEST_F(Debounce, Chatter) {
+    // Eight keys picked at random flip on every scan
+    std::minstd_rand random(1);
+    measure("chatter", [&random](uint32_t i) {
+        for (uint8_t n = 0; n < 8; n++) {
+            uint16_t key = random() % (MATRIX_ROWS * MATRIX_COLS);
+            raw[key / MATRIX_COLS] ^= (matrix_row_t)1 << (key % MATRIX_COLS);
+        }
+        debounce_scan(true);
+    });
+}
@@ -0,0 +1,44 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bench_common.hpp"
+
+namespace {
+const uint8_t layer_counts[] = {1, 4, 16, 32};
+
+std::string case_name(const char* what, uint8_t layers) { return std::to_string(MATRIX_ROWS) + "x" + std::to_string(MATRIX_COLS) + "/" + what + "/layers:" + std::to_string(layers); }
+
+// The lowest `layers` layers on, so every lookup falls through the transparent ones down to the base layer
+void enable_layers(uint8_t layers) { layer_state_set((layer_state_t)(((uint64_t)1 << layers) - 1)); }
+}  // namespace
+
+class Matrix : public BenchFixture {};
+
+TEST_F(Matrix, IdleScan) {
+    for (auto layers : layer_counts) {
+        enable_layers(layers);
+        measure_scans(case_name("idle", layers));
+    }
+}
+
+TEST_F(Matrix, TypingEveryKey) {
+    for (auto layers : layer_counts) {
+        enable_layers(layers);
+        measure_scans(case_name("typing", layers), [](uint32_t i) { toggle_in_turn(i); });
+        clear_all_keys();
+        scan();
+    }
+}
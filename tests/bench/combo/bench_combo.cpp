@@ -0,0 +1,41 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bench_common.hpp"
+
+class Combo : public BenchFixture {};
+
+TEST_F(Combo, KeysOutsideAnyCombo) { measure_scans("plain", [](uint32_t i) { toggle_in_turn(i, 2, 2); }); }
+
+TEST_F(Combo, ComboKeysTypedAlone) {
+    // Each key is held back until its release shows it was not part of a combo
+    measure_scans("alone", [](uint32_t i) { toggle_in_turn(i, 0, 2); });
+}
+
+TEST_F(Combo, Chords) {
+    // Both keys of a combo go down in one scan and up in the next
+    measure_scans("chord", [](uint32_t i) {
+        uint8_t first  = (i / 2) % 24;
+        uint8_t second = (first + 1) % 24;
+        if (i & 1) {
+            release_key(first % MATRIX_COLS, first / MATRIX_COLS);
+            release_key(second % MATRIX_COLS, second / MATRIX_COLS);
+        } else {
+            press_key(first % MATRIX_COLS, first / MATRIX_COLS);
+            press_key(second % MATRIX_COLS, second / MATRIX_COLS);
+        }
+    });
+}
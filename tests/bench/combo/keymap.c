@@ -0,0 +1,62 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] =
+        {
+            // 0     1     2     3     4     5     6     7     8     9     10    11
+            {KC_A, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G, KC_H, KC_I, KC_J, KC_K, KC_L},
+            {KC_M, KC_N, KC_O, KC_P, KC_Q, KC_R, KC_S, KC_T, KC_U, KC_V, KC_W, KC_X},
+            {KC_1, KC_2, KC_3, KC_4, KC_5, KC_6, KC_7, KC_8, KC_9, KC_0, KC_MINS, KC_EQL},
+            {KC_F1, KC_F2, KC_F3, KC_F4, KC_F5, KC_F6, KC_F7, KC_F8, KC_F9, KC_F10, KC_F11, KC_F12},
+        },
+};
+
+// Every pair of neighbouring letters on the top two rows is a combo
+#define PAIR(a, b) const uint16_t PROGMEM a##b##_combo[] = {KC_##a, KC_##b, COMBO_END}
+
+PAIR(A, B);
+PAIR(B, C);
+PAIR(C, D);
+PAIR(D, E);
+PAIR(E, F);
+PAIR(F, G);
+PAIR(G, H);
+PAIR(H, I);
+PAIR(I, J);
+PAIR(J, K);
+PAIR(K, L);
+PAIR(L, M);
+PAIR(M, N);
+PAIR(N, O);
+PAIR(O, P);
+PAIR(P, Q);
+PAIR(Q, R);
+PAIR(R, S);
+PAIR(S, T);
+PAIR(T, U);
+PAIR(U, V);
+PAIR(V, W);
+PAIR(W, X);
+PAIR(X, A);
+
+combo_t key_combos[COMBO_COUNT] = {
+    COMBO(AB_combo, KC_F13), COMBO(BC_combo, KC_F13), COMBO(CD_combo, KC_F13), COMBO(DE_combo, KC_F13), COMBO(EF_combo, KC_F13), COMBO(FG_combo, KC_F13), COMBO(GH_combo, KC_F13), COMBO(HI_combo, KC_F13),
+    COMBO(IJ_combo, KC_F13), COMBO(JK_combo, KC_F13), COMBO(KL_combo, KC_F13), COMBO(LM_combo, KC_F13), COMBO(MN_combo, KC_F13), COMBO(NO_combo, KC_F13), COMBO(OP_combo, KC_F13), COMBO(PQ_combo, KC_F13),
+    COMBO(QR_combo, KC_F13), COMBO(RS_combo, KC_F13), COMBO(ST_combo, KC_F13), COMBO(TU_combo, KC_F13), COMBO(UV_combo, KC_F13), COMBO(VW_combo, KC_F13), COMBO(WX_combo, KC_F13), COMBO(XA_combo, KC_F13),
+};
@@ -0,0 +1,76 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bench_common.hpp"
+
+extern "C" uint32_t frames_flushed;
+
+namespace {
+const char* const effect_names[] = {
+    "NONE",
+#define RGB_MATRIX_EFFECT(name, ...) #name,
+#include "rgb_matrix_animations/rgb_matrix_effects.inc"
+#undef RGB_MATRIX_EFFECT
+};
+}  // namespace
+
+class RgbMatrix : public BenchFixture {};
+
+TEST_F(RgbMatrix, Disabled) {
+    rgb_matrix_disable_noeeprom();
+    measure_scans("off", [](uint32_t i) { toggle_in_turn(i); });
+    rgb_matrix_enable_noeeprom();
+}
+
+TEST_F(RgbMatrix, EveryEffectWhileTyping) {
+    for (uint8_t mode = 1; mode < RGB_MATRIX_EFFECT_MAX; mode++) {
+        rgb_matrix_mode_noeeprom(mode);
+        measure_scans(effect_names[mode], [](uint32_t i) { toggle_in_turn(i); });
+    }
+}
+
+TEST_F(RgbMatrix, RenderTimePerFrame) {
+    // One iteration renders every LED of g_led_config once, however many task runs that takes
+    for (uint8_t mode = 1; mode < RGB_MATRIX_EFFECT_MAX; mode++) {
+        rgb_matrix_mode_noeeprom(mode);
+        BenchResult result = measure(std::string(effect_names[mode]) + " frame", [](uint32_t i) {
+            uint32_t frame = frames_flushed;
+            while (frames_flushed == frame) {
+                rgb_matrix_task();
+                advance_time(1);
+            }
+        });
+// Host timings vary from run to run, so the budget is only checked when asked for, e.g. make bench:rgb_matrix EXTRAFLAGS=-DRGB_MATRIX_FRAME_BUDGET_US=50
+#ifdef RGB_MATRIX_FRAME_BUDGET_US
+        EXPECT_LE(result.ns_per_iteration, RGB_MATRIX_FRAME_BUDGET_US * 1000.0) << effect_names[mode] << " is over the frame budget";
+#endif
+    }
+}
+
+TEST_F(RgbMatrix, HsvToRgb) {
+    // One frame of a rainbow over every LED, the common case of the effect runners
+    static HSV hsv[DRIVER_LED_TOTAL];
+    static RGB rgb[DRIVER_LED_TOTAL];
+    static int sink;
+
+    measure("hsv_to_rgb per LED", [](uint32_t i) {
+        for (uint8_t n = 0; n < DRIVER_LED_TOTAL; n++) {
+            hsv[n] = {(uint8_t)(i + n * 5), 255, 255};
+            rgb[n] = hsv_to_rgb(hsv[n]);
+        }
+        sink += rgb[i % DRIVER_LED_TOTAL].r;
+    });
+}
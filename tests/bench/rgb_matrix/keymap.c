@@ -0,0 +1,53 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {[0 ... MATRIX_ROWS - 1] = {[0 ... MATRIX_COLS - 1] = KC_A}},
+};
+
+// One LED under every key
+#define ROW_POINTS(y) {0, y}, {20, y}, {40, y}, {61, y}, {81, y}, {101, y}, {122, y}, {142, y}, {162, y}, {183, y}, {203, y}, {224, y}
+
+led_config_t g_led_config = {
+    {
+        {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11},
+        {12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23},
+        {24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35},
+        {36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47},
+    },
+    {ROW_POINTS(0), ROW_POINTS(21), ROW_POINTS(43), ROW_POINTS(64)},
+    {[0 ... DRIVER_LED_TOTAL - 1] = LED_FLAG_KEYLIGHT},
+};
+
+// A driver that only keeps the colours in memory and counts the frames
+static RGB leds[DRIVER_LED_TOTAL];
+uint32_t   frames_flushed;
+
+static void init(void) {}
+
+static void set_color(int index, uint8_t r, uint8_t g, uint8_t b) { leds[index] = (RGB){.r = r, .g = g, .b = b}; }
+
+static void set_color_all(uint8_t r, uint8_t g, uint8_t b) {
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        set_color(i, r, g, b);
+    }
+}
+
+static void flush(void) { frames_flushed++; }
+
+const rgb_matrix_driver_t rgb_matrix_driver = {init, set_color, set_color_all, flush};
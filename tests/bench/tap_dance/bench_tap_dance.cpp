@@ -0,0 +1,40 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bench_common.hpp"
+
+class TapDance : public BenchFixture {};
+
+TEST_F(TapDance, IdleScan) { measure_scans("idle"); }
+
+TEST_F(TapDance, KeysOutsideAnyDance) { measure_scans("plain", [](uint32_t i) { toggle_in_turn(i, 0, 1); }); }
+
+TEST_F(TapDance, RollingOverDances) {
+    // Each tap is finished by the next dance being pressed
+    measure_scans("roll", [](uint32_t i) { toggle_in_turn(i, 1, 3); });
+}
+
+TEST_F(TapDance, DoubleTapsTimingOut) {
+    // Two taps of one dance, then idle until the tapping term finishes it
+    const uint32_t period = 4 + TAPPING_TERM + 1;
+    measure_scans("double_tap", [period](uint32_t i) {
+        uint32_t step = i % period;
+        uint8_t  key  = (i / period) % (3 * MATRIX_COLS);
+        if (step < 4) {
+            toggle_in_turn(key * 2 + (step & 1), 1, 3);
+        }
+    });
+}
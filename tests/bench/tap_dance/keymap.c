@@ -0,0 +1,42 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+// The top row types, the rest are the first 36 of 64 tap dances
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] =
+        {
+            // 0     1     2     3     4     5     6     7     8     9     10    11
+            {KC_A, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G, KC_H, KC_I, KC_J, KC_K, KC_L},
+            {TD(0), TD(1), TD(2), TD(3), TD(4), TD(5), TD(6), TD(7), TD(8), TD(9), TD(10), TD(11)},
+            {TD(12), TD(13), TD(14), TD(15), TD(16), TD(17), TD(18), TD(19), TD(20), TD(21), TD(22), TD(23)},
+            {TD(24), TD(25), TD(26), TD(27), TD(28), TD(29), TD(30), TD(31), TD(32), TD(33), TD(34), TD(35)},
+        },
+};
+
+#define DANCE ACTION_TAP_DANCE_DOUBLE(KC_X, KC_Y)
+
+qk_tap_dance_action_t tap_dance_actions[64] = {
+    DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE,
+    DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE,
+    DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE,
+    DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE,
+    DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE,
+    DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE,
+    DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE,
+    DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE,
+};
@@ -0,0 +1,84 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "color.h"
+}
+
+namespace {
+// The conversion as it was before it was made table driven
+RGB reference_hsv_to_rgb(HSV hsv) {
+    RGB      rgb;
+    uint8_t  region, remainder, p, q, t;
+    uint16_t h, s, v;
+
+    if (hsv.s == 0) {
+        rgb.r = rgb.g = rgb.b = hsv.v;
+        return rgb;
+    }
+
+    h = hsv.h;
+    s = hsv.s;
+    v = hsv.v;
+
+    region    = h * 6 / 255;
+    remainder = (h * 2 - region * 85) * 3;
+
+    p = (v * (255 - s)) >> 8;
+    q = (v * (255 - ((s * remainder) >> 8))) >> 8;
+    t = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+
+    switch (region) {
+        case 6:
+        case 0:
+            rgb.r = v, rgb.g = t, rgb.b = p;
+            break;
+        case 1:
+            rgb.r = q, rgb.g = v, rgb.b = p;
+            break;
+        case 2:
+            rgb.r = p, rgb.g = v, rgb.b = t;
+            break;
+        case 3:
+            rgb.r = p, rgb.g = q, rgb.b = v;
+            break;
+        case 4:
+            rgb.r = t, rgb.g = p, rgb.b = v;
+            break;
+        default:
+            rgb.r = v, rgb.g = p, rgb.b = q;
+            break;
+    }
+    return rgb;
+}
+
+void expect_same(const RGB& actual, const RGB& expected, const HSV& hsv) {
+    ASSERT_TRUE(actual.r == expected.r && actual.g == expected.g && actual.b == expected.b) << "for hsv " << (int)hsv.h << ", " << (int)hsv.s << ", " << (int)hsv.v;
+}
+}  // namespace
+
+TEST(Color, SameAsBeforeForEveryColour) {
+    for (int h = 0; h < 256; h++) {
+        for (int s = 0; s < 256; s++) {
+            for (int v = 0; v < 256; v++) {
+                HSV hsv = {(uint8_t)h, (uint8_t)s, (uint8_t)v};
+                expect_same(hsv_to_rgb(hsv), reference_hsv_to_rgb(hsv), hsv);
+            }
+        }
+    }
+}
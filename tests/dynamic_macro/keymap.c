@@ -0,0 +1,44 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] =
+        {
+            // 0    1     2     3        4        5        6        7        8             9
+            {KC_A, KC_B, KC_C, DM_REC1, DM_REC2, DM_RSTP, DM_PLY1, DM_PLY2, LSFT_T(KC_D), KC_LSFT},
+            {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+            {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+            {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        },
+};
+
+// How many key events did not fit in the macro buffer
+uint16_t dynamic_macro_overflows;
+
+void dynamic_macro_record_key_user(int8_t direction, keyrecord_t *record) { dynamic_macro_overflows++; }
+
+// The key positions of the events played back
+keypos_t dynamic_macro_played_keys[8];
+uint8_t  dynamic_macro_played_count;
+
+bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    if (dynamic_macro_is_playing() && dynamic_macro_played_count < 8) {
+        dynamic_macro_played_keys[dynamic_macro_played_count++] = record->event.key;
+    }
+    return true;
+}
@@ -0,0 +1,252 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <vector>
+
+extern "C" {
+#include "eeprom.h"
+}
+
+using testing::_;
+using testing::Invoke;
+
+extern "C" uint16_t dynamic_macro_overflows;
+extern "C" keypos_t dynamic_macro_played_keys[8];
+extern "C" uint8_t  dynamic_macro_played_count;
+
+namespace {
+enum { COL_A, COL_B, COL_C, COL_REC1, COL_REC2, COL_STOP, COL_PLAY1, COL_PLAY2, COL_SFT_D, COL_LSFT };
+
+typedef std::vector<report_keyboard_t>    report_log_t;
+typedef std::vector<std::vector<uint8_t>> held_t;
+
+void record_reports(TestDriver& driver, report_log_t& log) {
+    EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke([&log](report_keyboard_t& report) { log.push_back(report); }));
+}
+
+// The modifiers and keys held in each report with something held, empty
+// reports only depend on how the keyboard was cleared
+held_t held(const report_log_t& log) {
+    held_t result;
+    for (auto report : log) {
+        std::vector<uint8_t> keys;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            if (report.mods & (1 << bit)) {
+                keys.push_back(KC_LCTRL + bit);
+            }
+        }
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+            if (report.keys[i]) {
+                keys.push_back(report.keys[i]);
+            }
+        }
+        if (!keys.empty()) {
+            result.push_back(keys);
+        }
+    }
+    return result;
+}
+}  // namespace
+
+class DynamicMacro : public TestFixture {
+   protected:
+    void tap(uint8_t col) {
+        press_key(col, 0);
+        run_one_scan_loop();
+        release_key(col, 0);
+        run_one_scan_loop();
+    }
+
+    void record(uint8_t slot, const std::vector<uint8_t>& cols) {
+        tap(slot == 1 ? COL_REC1 : COL_REC2);
+        for (auto col : cols) {
+            tap(col);
+        }
+        tap(COL_STOP);
+    }
+
+    // Returns the number of scans the playback took
+    int play(uint8_t slot) {
+        tap(slot == 1 ? COL_PLAY1 : COL_PLAY2);
+        int scans = 0;
+        while (dynamic_macro_is_playing()) {
+            run_one_scan_loop();
+            scans++;
+        }
+        return scans;
+    }
+};
+
+TEST_F(DynamicMacro, ReplaysTheRecordedKeysOneEventPerScan) {
+    TestDriver   driver;
+    report_log_t recorded;
+    report_log_t played;
+
+    record_reports(driver, recorded);
+    record(1, {COL_A, COL_B, COL_C});
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    record_reports(driver, played);
+    int scans = play(1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EQ(held(played), held(recorded));
+    EXPECT_EQ(held(played).size(), 3);
+    // Six events, then the scan that ends the playback
+    EXPECT_EQ(scans, 7);
+}
+
+TEST_F(DynamicMacro, ReplaysModifiers) {
+    TestDriver   driver;
+    report_log_t played;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+
+    tap(COL_REC1);
+    press_key(COL_LSFT, 0);
+    run_one_scan_loop();
+    tap(COL_A);
+    release_key(COL_LSFT, 0);
+    run_one_scan_loop();
+    tap(COL_STOP);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    record_reports(driver, played);
+    play(1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    held_t expected = {{KC_LSFT}, {KC_LSFT, KC_A}, {KC_LSFT}};
+    EXPECT_EQ(held(played), expected);
+}
+
+TEST_F(DynamicMacro, ReplaysTheTapOfAModTap) {
+    TestDriver   driver;
+    report_log_t played;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+
+    record(1, {COL_SFT_D});
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    record_reports(driver, played);
+    play(1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    held_t expected = {{KC_D}};
+    EXPECT_EQ(held(played), expected);
+}
+
+TEST_F(DynamicMacro, ReplaysTheRecordedKeyPositions) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+
+    record(1, {COL_B, COL_SFT_D});
+    dynamic_macro_played_count = 0;
+    play(1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    ASSERT_EQ(dynamic_macro_played_count, 4);
+    uint8_t expected[] = {COL_B, COL_B, COL_SFT_D, COL_SFT_D};
+    for (uint8_t i = 0; i < 4; i++) {
+        EXPECT_EQ(dynamic_macro_played_keys[i].row, 0);
+        EXPECT_EQ(dynamic_macro_played_keys[i].col, expected[i]);
+    }
+}
+
+TEST_F(DynamicMacro, FillsTheBufferWithThreeBytesPerEvent) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+    record(2, {});
+
+    // Sixteen taps are 32 events of three bytes, the whole buffer
+    dynamic_macro_overflows = 0;
+    record(1, std::vector<uint8_t>(16, COL_A));
+    EXPECT_EQ(dynamic_macro_overflows, 0);
+    record(1, std::vector<uint8_t>(17, COL_B));
+    EXPECT_EQ(dynamic_macro_overflows, 2);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    report_log_t played;
+    record_reports(driver, played);
+    play(1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_EQ(held(played).size(), 16);
+}
+
+TEST_F(DynamicMacro, BothMacrosShareTheBuffer) {
+    TestDriver   driver;
+    report_log_t first;
+    report_log_t second;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+
+    record(1, {COL_A, COL_B});
+    record(2, {COL_C, COL_A, COL_C});
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    record_reports(driver, first);
+    play(1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    record_reports(driver, second);
+    play(2);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    held_t expected_first = {{KC_A}, {KC_B}};
+    held_t expected_second = {{KC_C}, {KC_A}, {KC_C}};
+    EXPECT_EQ(held(first), expected_first);
+    EXPECT_EQ(held(second), expected_second);
+}
+
+TEST_F(DynamicMacro, MacroReplayingItselfIsNotRepeated) {
+    TestDriver   driver;
+    report_log_t played;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+
+    record(1, {COL_A});
+    record(2, {COL_B, COL_PLAY1});
+    record(1, {COL_C, COL_PLAY2});
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    record_reports(driver, played);
+    play(1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // Macro 1 types C and plays macro 2, which types B and skips macro 1
+    held_t expected = {{KC_C}, {KC_B}};
+    EXPECT_EQ(held(played), expected);
+}
+
+TEST_F(DynamicMacro, MacrosAreLoadedFromEeprom) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+    const size_t eeprom_size = DYNAMIC_MACRO_BUFFER_BYTES + 8;
+
+    record(2, {});
+    record(1, {COL_A, COL_B});
+    std::vector<uint8_t> saved(eeprom_size);
+    eeprom_read_block(saved.data(), (void*)DYNAMIC_MACRO_EEPROM_ADDR, eeprom_size);
+
+    record(1, {COL_C});
+    eeprom_update_block(saved.data(), (void*)DYNAMIC_MACRO_EEPROM_ADDR, eeprom_size);
+    dynamic_macro_init();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    report_log_t played;
+    record_reports(driver, played);
+    play(1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    held_t expected = {{KC_A}, {KC_B}};
+    EXPECT_EQ(held(played), expected);
+}
@@ -0,0 +1,43 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTS_ENCODER_CONFIG_H_
+#define TESTS_ENCODER_CONFIG_H_
+
+#define MATRIX_ROWS 4
+#define MATRIX_COLS 10
+
+// The test plays the pins, and calls encoder_sample() like a timer interrupt would
+#define ENCODERS_PAD_A {0, 2}
+#define ENCODERS_PAD_B {1, 3}
+#define ENCODER_INTERRUPT_SAMPLING
+
+#ifndef __ASSEMBLER__
+#    include <stdint.h>
+#    include <stdbool.h>
+#    ifdef __cplusplus
+extern "C" {
+#    endif
+typedef uint8_t pin_t;
+bool            fake_pin_read(pin_t pin);
+#    ifdef __cplusplus
+}
+#    endif
+#    define readPin(pin) fake_pin_read(pin)
+#    define setPinInputHigh(pin)
+#endif
+
+#endif /* TESTS_ENCODER_CONFIG_H_ */
@@ -0,0 +1,238 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "encoder.h"
+void advance_time(uint32_t ms);
+}
+
+namespace {
+struct Steps {
+    int8_t   index;
+    int8_t   steps;
+    uint16_t velocity;
+};
+
+std::vector<Steps> batches;
+int                clockwise[2];
+int                counter_clockwise[2];
+bool               user_handles_steps;
+bool               pins[4];
+
+// Quadrature states in clockwise order, A in bit 0 and B in bit 1, four edges per detent
+const uint8_t gray_code[] = {0b00, 0b01, 0b11, 0b10};
+
+class Knob {
+   public:
+    explicit Knob(uint8_t index) : index(index) {}
+
+    // Moves to the next quadrature state, as the timer interrupt would see it
+    void edge(bool cw) {
+        position = (position + (cw ? 1 : 3)) % 4;
+        pins[index * 2]     = gray_code[position] & 1;
+        pins[index * 2 + 1] = gray_code[position] >> 1;
+        encoder_sample();
+    }
+
+    void turn(int detents) {
+        for (int i = 0; i < 4 * abs(detents); i++) {
+            edge(detents > 0);
+        }
+    }
+
+   private:
+    uint8_t index;
+    uint8_t position = 0;
+};
+
+int total_steps(int8_t index) {
+    int total = 0;
+    for (auto& b : batches) {
+        if (b.index == index) {
+            total += b.steps;
+        }
+    }
+    return total;
+}
+}  // namespace
+
+extern "C" {
+bool fake_pin_read(pin_t pin) { return pins[pin]; }
+
+bool encoder_update_steps_kb(int8_t index, int8_t steps, uint16_t velocity) {
+    batches.push_back({index, steps, velocity});
+    return encoder_update_steps_user(index, steps, velocity);
+}
+
+bool encoder_update_steps_user(int8_t index, int8_t steps, uint16_t velocity) { return !user_handles_steps; }
+
+void encoder_update_user(int8_t index, bool cw) { (cw ? clockwise : counter_clockwise)[index]++; }
+}
+
+class Encoder : public TestFixture {
+   protected:
+    Encoder() {
+        batches.clear();
+        clockwise[0] = clockwise[1] = counter_clockwise[0] = counter_clockwise[1] = 0;
+
+        user_handles_steps = false;
+    }
+
+    TestDriver driver;
+};
+
+TEST_F(Encoder, SlowTurnReportsEachDetent) {
+    Knob knob(0);
+
+    for (int i = 0; i < 3; i++) {
+        knob.turn(1);
+        idle_for(100);
+    }
+
+    ASSERT_EQ(batches.size(), 3);
+    for (auto& b : batches) {
+        EXPECT_EQ(b.index, 0);
+        EXPECT_EQ(b.steps, 1);
+    }
+    EXPECT_EQ(clockwise[0], 3);
+    EXPECT_EQ(counter_clockwise[0], 0);
+}
+
+TEST_F(Encoder, StepsHandledByTheKeymapSkipTheDetentCallbacks) {
+    Knob knob(0);
+
+    // Steps hooks that return true keep encoder_update_kb() going
+    knob.turn(2);
+    run_one_scan_loop();
+    EXPECT_EQ(clockwise[0], 2);
+
+    user_handles_steps = true;
+    knob.turn(3);
+    run_one_scan_loop();
+    ASSERT_EQ(batches.size(), 2);
+    EXPECT_EQ(batches[1].steps, 3);
+    EXPECT_EQ(clockwise[0], 2);
+}
+
+TEST_F(Encoder, CounterClockwiseIsNegative) {
+    Knob knob(1);
+
+    knob.turn(-2);
+    run_one_scan_loop();
+
+    ASSERT_EQ(batches.size(), 1);
+    EXPECT_EQ(batches[0].index, 1);
+    EXPECT_EQ(batches[0].steps, -2);
+    EXPECT_EQ(counter_clockwise[1], 2);
+    EXPECT_EQ(clockwise[1], 0);
+}
+
+TEST_F(Encoder, SlowLoopGetsAllStepsInOneBatch) {
+    Knob volume(0);
+
+    // A fast spin while the main loop is busy for 50 ms
+    volume.turn(30);
+    advance_time(50);
+    run_one_scan_loop();
+
+    ASSERT_EQ(batches.size(), 1);
+    EXPECT_EQ(batches[0].steps, 30);
+    EXPECT_EQ(clockwise[0], 30);
+}
+
+TEST_F(Encoder, EveryStepCountsAtAnyRate) {
+    Knob volume(0);
+    Knob scroll(1);
+
+    // From one edge per scan to many detents per scan, with the knobs turning different ways
+    for (int edges_per_scan = 1; edges_per_scan <= 64; edges_per_scan *= 2) {
+        for (int i = 0; i < 4 * 20; i++) {
+            volume.edge(true);
+            scroll.edge(i % 8 < 3);
+            if (i % edges_per_scan == 0) {
+                run_one_scan_loop();
+            }
+        }
+        run_one_scan_loop();
+    }
+
+    // 7 rates of 20 detents, the second knob goes 3 edges forward and 5 back
+    EXPECT_EQ(total_steps(0), 7 * 20);
+    EXPECT_EQ(clockwise[0], 7 * 20);
+    EXPECT_EQ(total_steps(1), 7 * -20 / 4);
+}
+
+TEST_F(Encoder, VelocityFollowsTheTurnRate) {
+    Knob knob(0);
+
+    idle_for(ENCODER_VELOCITY_TIMEOUT);
+    for (int i = 0; i < 10; i++) {
+        knob.turn(1);
+        idle_for(40);
+    }
+    EXPECT_EQ(batches.back().velocity, 25);
+
+    for (int i = 0; i < 10; i++) {
+        knob.turn(1);
+        idle_for(8);
+    }
+    EXPECT_EQ(batches.back().velocity, 125);
+
+    // Two detents in the 8 ms since the last one
+    knob.turn(2);
+    run_one_scan_loop();
+    EXPECT_EQ(batches.back().velocity, 250);
+
+    // Starting again after a pause counts as slow
+    idle_for(1000);
+    knob.turn(1);
+    run_one_scan_loop();
+    EXPECT_EQ(batches.back().velocity, 1000 / ENCODER_VELOCITY_TIMEOUT);
+}
+
+TEST_F(Encoder, SamplerInterruptNeverLosesSteps) {
+    const int         rounds = 200;
+    std::atomic<int>  scans(0);
+    std::atomic<bool> done(false);
+
+    // The thread plays the sampling interrupt, turning up to 100 detents between two scans
+    std::thread isr([&scans, &done, rounds]() {
+        Knob knob(0);
+        for (int round = 0; round < rounds; round++) {
+            int seen = scans;
+            knob.turn(round % 3 ? 100 : -50);
+            while (scans == seen) {
+                std::this_thread::yield();
+            }
+        }
+        done = true;
+    });
+    while (!done) {
+        run_one_scan_loop();
+        scans++;
+    }
+    isr.join();
+    run_one_scan_loop();
+
+    // 67 rounds back and 133 forward
+    EXPECT_EQ(total_steps(0), 133 * 100 - 67 * 50);
+    EXPECT_EQ(clockwise[0] - counter_clockwise[0], total_steps(0));
+}
@@ -0,0 +1,117 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "action_tapping.h"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+extern "C" {
+void set_time_us(uint64_t t);
+void advance_time_us(uint32_t us);
+}
+
+namespace {
+// Microseconds before the 32 bit microsecond timer wraps
+uint64_t before_wrap(uint32_t us) { return 0x100000000ULL - us; }
+}  // namespace
+
+class EventTimeUs : public TestFixture {
+   protected:
+    // Scans at 8 kHz
+    void scan_for_us(uint32_t us) {
+        for (uint32_t elapsed = 0; elapsed < us; elapsed += 125) {
+            keyboard_task();
+            advance_time_us(125);
+        }
+    }
+
+    void hold_for_us(uint8_t col, uint32_t us) {
+        press_key(col, 0);
+        scan_for_us(us);
+        release_key(col, 0);
+        keyboard_task();
+    }
+};
+
+TEST_F(EventTimeUs, TapEndsJustBeforeTheTappingTerm) {
+    TestDriver driver;
+    InSequence s;
+
+    // Starts half way through a millisecond, so both ends round to the same one
+    set_time_us(1000500);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    hold_for_us(0, TAPPING_TERM * 1000 - 250);
+}
+
+TEST_F(EventTimeUs, HoldStartsJustAfterTheTappingTerm) {
+    TestDriver driver;
+    InSequence s;
+
+    set_time_us(1000500);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    hold_for_us(0, TAPPING_TERM * 1000 + 250);
+}
+
+TEST_F(EventTimeUs, TapAcrossTheTimerWrap) {
+    TestDriver driver;
+    InSequence s;
+
+    set_time_us(before_wrap(TAPPING_TERM * 1000 / 2));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    hold_for_us(0, TAPPING_TERM * 1000 - 250);
+    EXPECT_LT(timer_read_us(), TAPPING_TERM * 1000);
+}
+
+TEST_F(EventTimeUs, HoldAcrossTheTimerWrap) {
+    TestDriver driver;
+    InSequence s;
+
+    set_time_us(before_wrap(TAPPING_TERM * 1000 / 2));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    hold_for_us(0, TAPPING_TERM * 1000 + 250);
+}
+
+TEST_F(EventTimeUs, TapDanceFinishesAcrossTheTimerWrap) {
+    TestDriver driver;
+    InSequence s;
+
+    set_time_us(before_wrap(1000));
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    hold_for_us(1, 500);
+    scan_for_us(TAPPING_TERM * 1000 - 500);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // the dance applies the modifiers it saved before finishing
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    scan_for_us(500);
+}
+
+TEST_F(EventTimeUs, TimerElapsedHandlesTheWrap) {
+    set_time_us(before_wrap(300));
+    uint32_t start = timer_read_us();
+    advance_time_us(1000);
+    EXPECT_EQ(timer_read_us(), 700);
+    EXPECT_EQ(timer_elapsed_us(start), 1000);
+}
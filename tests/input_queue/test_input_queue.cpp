@@ -0,0 +1,144 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include <atomic>
+#include <thread>
+
+extern "C" {
+#include "input_queue.h"
+#include "pointing_device.h"
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+using testing::Invoke;
+
+class InputQueue : public TestFixture {};
+
+TEST_F(InputQueue, QueuedKeysAreProcessedByKeyboardTask) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_TRUE(input_queue_key(0, 0, true));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    keyboard_task();
+
+    EXPECT_TRUE(input_queue_key(0, 0, false));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+}
+
+TEST_F(InputQueue, TapsAreDecidedOnTheSampledTime) {
+    TestDriver driver;
+    InSequence s;
+
+    // Both edges are processed in the same task, but were sampled a hold apart
+    input_queue_key(0, 1, true);
+    advance_time(TAPPING_TERM + 50);
+    input_queue_key(0, 1, false);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    input_queue_key(0, 1, true);
+    advance_time(TAPPING_TERM / 2);
+    input_queue_key(0, 1, false);
+    advance_time(TAPPING_TERM + 50);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+}
+
+TEST_F(InputQueue, PointerDeltasAddUpWithoutLoss) {
+    TestDriver     driver;
+    report_mouse_t sent = {};
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    EXPECT_CALL(driver, send_mouse_mock(_)).WillRepeatedly(Invoke([&sent](report_mouse_t& report) { sent = report; }));
+
+    input_queue_pointer(10, -5);
+    input_queue_pointer(10, -5);
+    input_queue_pointer(120, 3);
+    keyboard_task();
+
+    EXPECT_EQ(sent.x, 127);
+    EXPECT_EQ(sent.y, -7);
+
+    // what did not fit follows in the next report
+    idle_for(POINTING_DEVICE_INTERVAL + 1);
+    EXPECT_EQ(sent.x, 13);
+    EXPECT_EQ(sent.y, 0);
+}
+
+TEST_F(InputQueue, OverflowIsCounted) {
+    input_event_t event;
+
+    for (uint8_t i = 0; i < INPUT_QUEUE_SIZE; i++) {
+        EXPECT_TRUE(input_queue_key(0, i, true));
+    }
+    EXPECT_FALSE(input_queue_key(1, 0, true));
+    EXPECT_FALSE(input_queue_key(1, 1, true));
+    EXPECT_EQ(input_queue_dropped(), 2);
+    EXPECT_EQ(input_queue_dropped(), 0);
+
+    for (uint8_t i = 0; i < INPUT_QUEUE_SIZE; i++) {
+        ASSERT_TRUE(input_queue_pop(&event));
+        EXPECT_EQ(event.type, INPUT_EVENT_KEY);
+        EXPECT_EQ(event.key.key.col, i);
+    }
+    EXPECT_FALSE(input_queue_pop(&event));
+}
+
+TEST_F(InputQueue, ProducerThreadNeverLosesOrReordersEvents) {
+    const uint32_t   events = 100000;
+    std::atomic<int> full(0);
+
+    // Every event carries its sequence number in the key position
+    std::thread producer([&full, events]() {
+        for (uint32_t i = 0; i < events; i++) {
+            input_event_t event = {};
+            event.type          = INPUT_EVENT_KEY;
+            event.time          = 1;
+            event.key.key.row   = i >> 8;
+            event.key.key.col   = i & 0xFF;
+            while (!input_queue_push(&event)) {
+                full++;
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    while (expected < events) {
+        input_event_t event;
+        if (input_queue_pop(&event)) {
+            ASSERT_EQ((uint32_t)(event.key.key.row << 8 | event.key.key.col), expected & 0xFFFF);
+            expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    input_event_t event;
+    EXPECT_FALSE(input_queue_pop(&event));
+    EXPECT_EQ(input_queue_dropped(), (uint8_t)full.load());
+    std::cout << full.load() << " pushes found the queue full" << std::endl;
+}
@@ -0,0 +1,247 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "action_tapping.h"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+namespace {
+// keycode_config() and mod_config() as they were before the remap tables
+uint16_t reference_keycode_config(uint16_t keycode) {
+    switch (keycode) {
+        case KC_CAPSLOCK:
+        case KC_LOCKING_CAPS:
+            if (keymap_config.swap_control_capslock || keymap_config.capslock_to_control) {
+                return KC_LCTL;
+            }
+            return keycode;
+        case KC_LCTL:
+            if (keymap_config.swap_control_capslock) {
+                return KC_CAPSLOCK;
+            }
+            if (keymap_config.swap_lctl_lgui) {
+                if (keymap_config.no_gui) {
+                    return KC_NO;
+                }
+                return KC_LGUI;
+            }
+            return KC_LCTL;
+        case KC_LALT:
+            if (keymap_config.swap_lalt_lgui) {
+                if (keymap_config.no_gui) {
+                    return KC_NO;
+                }
+                return KC_LGUI;
+            }
+            return KC_LALT;
+        case KC_LGUI:
+            if (keymap_config.swap_lalt_lgui) {
+                return KC_LALT;
+            }
+            if (keymap_config.swap_lctl_lgui) {
+                return KC_LCTRL;
+            }
+            if (keymap_config.no_gui) {
+                return KC_NO;
+            }
+            return KC_LGUI;
+        case KC_RCTL:
+            if (keymap_config.swap_rctl_rgui) {
+                if (keymap_config.no_gui) {
+                    return KC_NO;
+                }
+                return KC_RGUI;
+            }
+            return KC_RCTL;
+        case KC_RALT:
+            if (keymap_config.swap_ralt_rgui) {
+                if (keymap_config.no_gui) {
+                    return KC_NO;
+                }
+                return KC_RGUI;
+            }
+            return KC_RALT;
+        case KC_RGUI:
+            if (keymap_config.swap_ralt_rgui) {
+                return KC_RALT;
+            }
+            if (keymap_config.swap_rctl_rgui) {
+                return KC_RCTL;
+            }
+            if (keymap_config.no_gui) {
+                return KC_NO;
+            }
+            return KC_RGUI;
+        case KC_GRAVE:
+            if (keymap_config.swap_grave_esc) {
+                return KC_ESC;
+            }
+            return KC_GRAVE;
+        case KC_ESC:
+            if (keymap_config.swap_grave_esc) {
+                return KC_GRAVE;
+            }
+            return KC_ESC;
+        case KC_BSLASH:
+            if (keymap_config.swap_backslash_backspace) {
+                return KC_BSPACE;
+            }
+            return KC_BSLASH;
+        case KC_BSPACE:
+            if (keymap_config.swap_backslash_backspace) {
+                return KC_BSLASH;
+            }
+            return KC_BSPACE;
+        default:
+            return keycode;
+    }
+}
+
+uint8_t reference_mod_config(uint8_t mod) {
+    if (keymap_config.swap_lalt_lgui) {
+        if ((mod & MOD_RGUI) == MOD_LGUI) {
+            mod &= ~MOD_LGUI;
+            mod |= MOD_LALT;
+        } else if ((mod & MOD_RALT) == MOD_LALT) {
+            mod &= ~MOD_LALT;
+            mod |= MOD_LGUI;
+        }
+    }
+    if (keymap_config.swap_ralt_rgui) {
+        if ((mod & MOD_RGUI) == MOD_RGUI) {
+            mod &= ~MOD_RGUI;
+            mod |= MOD_RALT;
+        } else if ((mod & MOD_RALT) == MOD_RALT) {
+            mod &= ~MOD_RALT;
+            mod |= MOD_RGUI;
+        }
+    }
+    if (keymap_config.swap_lctl_lgui) {
+        if ((mod & MOD_RGUI) == MOD_LGUI) {
+            mod &= ~MOD_LGUI;
+            mod |= MOD_LCTL;
+        } else if ((mod & MOD_RCTL) == MOD_LCTL) {
+            mod &= ~MOD_LCTL;
+            mod |= MOD_LGUI;
+        }
+    }
+    if (keymap_config.swap_rctl_rgui) {
+        if ((mod & MOD_RGUI) == MOD_RGUI) {
+            mod &= ~MOD_RGUI;
+            mod |= MOD_RCTL;
+        } else if ((mod & MOD_RCTL) == MOD_RCTL) {
+            mod &= ~MOD_RCTL;
+            mod |= MOD_RGUI;
+        }
+    }
+    if (keymap_config.no_gui) {
+        mod &= ~MOD_LGUI;
+        mod &= ~MOD_RGUI;
+    }
+
+    return mod;
+}
+
+// Every combination of the bootmagic options, nkro included
+const uint16_t config_count = 1 << 10;
+}  // namespace
+
+class KeycodeConfig : public TestFixture {
+   protected:
+    void TearDown() override { keymap_config.raw = 0; }
+};
+
+TEST_F(KeycodeConfig, KeycodesMatchTheSwitchForEveryConfig) {
+    for (uint16_t config = 0; config < config_count; config++) {
+        keymap_config.raw = config;
+        for (uint32_t keycode = 0; keycode <= 0xFFFF; keycode += keycode < 0x200 ? 1 : 0x7F) {
+            ASSERT_EQ(keycode_config(keycode), reference_keycode_config(keycode)) << "config " << config << ", keycode " << keycode;
+        }
+    }
+}
+
+TEST_F(KeycodeConfig, ModsMatchTheSwitchForEveryConfig) {
+    for (uint16_t config = 0; config < config_count; config++) {
+        keymap_config.raw = config;
+        for (uint16_t mod = 0; mod <= 0xFF; mod++) {
+            ASSERT_EQ(mod_config(mod), reference_mod_config(mod)) << "config " << config << ", mod " << mod;
+        }
+    }
+}
+
+TEST_F(KeycodeConfig, ChangingTheConfigTakesEffectOnTheNextKey) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT)));
+    keyboard_task();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+
+    keymap_config.swap_lalt_lgui = true;
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LGUI)));
+    keyboard_task();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+
+    keymap_config.raw = 0;
+    keymap_config.capslock_to_control = true;
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL)));
+    keyboard_task();
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+}
+
+TEST_F(KeycodeConfig, ModTapHoldsTheRemappedModifier) {
+    TestDriver driver;
+    InSequence s;
+    keymap_config.swap_lalt_lgui = true;
+
+    press_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    keyboard_task();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LGUI)));
+    idle_for(TAPPING_TERM + 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+}
+
+TEST_F(KeycodeConfig, SwappedKeysAreTypedSwapped) {
+    TestDriver driver;
+    InSequence s;
+    keymap_config.swap_grave_esc = true;
+
+    press_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ESC)));
+    keyboard_task();
+    release_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+}
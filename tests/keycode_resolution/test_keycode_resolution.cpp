@@ -0,0 +1,128 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "action_tapping.h"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+extern "C" uint32_t keymap_reads;
+
+class KeycodeResolution : public TestFixture {};
+
+TEST_F(KeycodeResolution, PlainKeyReadsTheKeymapOnce) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    keymap_reads = 0;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    keyboard_task();
+    EXPECT_EQ(keymap_reads, 1);
+
+    release_key(0, 0);
+    keymap_reads = 0;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+    EXPECT_EQ(keymap_reads, 1);
+}
+
+TEST_F(KeycodeResolution, KeyPressedOnALayerIsReleasedFromIt) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    keyboard_task();
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_1)));
+    keyboard_task();
+
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    keyboard_task();
+
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+}
+
+TEST_F(KeycodeResolution, KeyBufferedBehindLayerTapResolvesOnTheHeldLayer) {
+    TestDriver driver;
+
+    press_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    keyboard_task();
+
+    press_key(0, 0);
+    keyboard_task();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_1)));
+    idle_for(TAPPING_TERM + 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+
+    release_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    keyboard_task();
+}
+
+TEST_F(KeycodeResolution, LayerTapTappedTypesItsKey) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    keyboard_task();
+
+    release_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+}
+
+TEST_F(KeycodeResolution, ModTapHeldPastTheTappingTermAppliesTheModifier) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    keyboard_task();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    idle_for(TAPPING_TERM + 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    press_key(0, 0);
+    keymap_reads = 0;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_A)));
+    keyboard_task();
+    EXPECT_EQ(keymap_reads, 1);
+
+    release_key(0, 0);
+    release_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    keyboard_task();
+}
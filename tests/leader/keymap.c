@@ -0,0 +1,67 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] =
+        {
+            // 0       1     2     3     4     5     6     7     8     9
+            {KC_LEAD, KC_A, KC_B, KC_C, KC_D, KC_S, KC_X, KC_L, KC_O, KC_N},
+            {KC_G, KC_E, KC_Q, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+            {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+            {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        },
+};
+
+// The sequence that fired last, and how many times leader_end() was called
+uint8_t leader_fired;
+uint8_t leader_ends;
+
+static void fire_a(void) { leader_fired = 1; }
+static void fire_ab(void) { leader_fired = 2; }
+static void fire_abc(void) { leader_fired = 3; }
+static void fire_dd(void) { leader_fired = 4; }
+static void fire_ds(void) { leader_fired = 5; }
+static void fire_longseq(void) { leader_fired = 6; }
+
+LEADER_SEQUENCES(
+    LEADER_SEQ(fire_a, KC_A),
+    LEADER_SEQ(fire_ab, KC_A, KC_B),
+    LEADER_SEQ(fire_abc, KC_A, KC_B, KC_C),
+    LEADER_SEQ(fire_dd, KC_D, KC_D),
+    LEADER_SEQ(fire_ds, KC_D, KC_S),
+    LEADER_SEQ(fire_longseq, KC_L, KC_O, KC_N, KC_G, KC_S, KC_E, KC_Q)
+);
+
+void leader_end(void) { leader_ends++; }
+
+// Sequences of matrix_scan_user(), used alongside the dictionary when set
+bool scan_user_sequences;
+
+LEADER_EXTERNS();
+
+void matrix_scan_user(void) {
+    if (!scan_user_sequences) {
+        return;
+    }
+    LEADER_DICTIONARY() {
+        leading = false;
+        leader_end();
+        SEQ_TWO_KEYS(KC_A, KC_X) { leader_fired = 7; }
+        SEQ_ONE_KEY(KC_X) { leader_fired = 8; }
+    }
+}
@@ -0,0 +1,171 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+
+extern "C" {
+extern uint8_t leader_fired;
+extern uint8_t leader_ends;
+extern bool    scan_user_sequences;
+LEADER_EXTERNS();
+}
+
+class Leader : public TestFixture {
+   protected:
+    void SetUp() override {
+        leader_fired        = 0;
+        leader_ends         = 0;
+        scan_user_sequences = false;
+    }
+
+    void tap_key(uint8_t col, uint8_t row) {
+        press_key(col, row);
+        keyboard_task();
+        release_key(col, row);
+        keyboard_task();
+    }
+
+    // Keys the leader swallows still send their releases
+    void expect_no_keys(TestDriver& driver) { EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber()); }
+};
+
+TEST_F(Leader, UnambiguousSequenceFiresWithoutWaiting) {
+    TestDriver driver;
+    expect_no_keys(driver);
+
+    tap_key(0, 0);
+    tap_key(4, 0);
+    EXPECT_EQ(leader_fired, 0);
+    tap_key(5, 0);
+    EXPECT_EQ(leader_fired, 5);
+    EXPECT_EQ(leader_ends, 1);
+    EXPECT_FALSE(leading);
+}
+
+TEST_F(Leader, SequenceThatStartsLongerOnesWaitsForTheTimeout) {
+    TestDriver driver;
+    expect_no_keys(driver);
+
+    tap_key(0, 0);
+    tap_key(1, 0);
+    idle_for(LEADER_TIMEOUT);
+    EXPECT_EQ(leader_fired, 0);
+    EXPECT_TRUE(leading);
+
+    idle_for(2);
+    EXPECT_EQ(leader_fired, 1);
+    EXPECT_EQ(leader_ends, 1);
+    EXPECT_FALSE(leading);
+}
+
+TEST_F(Leader, LongerSequenceWinsOverItsPrefixes) {
+    TestDriver driver;
+    expect_no_keys(driver);
+
+    tap_key(0, 0);
+    tap_key(1, 0);
+    tap_key(2, 0);
+    EXPECT_EQ(leader_fired, 0);
+    tap_key(3, 0);
+    EXPECT_EQ(leader_fired, 3);
+
+    tap_key(0, 0);
+    tap_key(1, 0);
+    tap_key(2, 0);
+    idle_for(LEADER_TIMEOUT + 2);
+    EXPECT_EQ(leader_fired, 2);
+    EXPECT_EQ(leader_ends, 2);
+}
+
+TEST_F(Leader, PrefixOfOnlyLongerSequencesFiresNothing) {
+    TestDriver driver;
+    expect_no_keys(driver);
+
+    tap_key(0, 0);
+    tap_key(4, 0);
+    idle_for(LEADER_TIMEOUT + 2);
+    EXPECT_EQ(leader_fired, 0);
+    EXPECT_EQ(leader_ends, 1);
+    EXPECT_FALSE(leading);
+}
+
+TEST_F(Leader, DeadEndStopsLeadingRightAway) {
+    TestDriver driver;
+    expect_no_keys(driver);
+
+    tap_key(0, 0);
+    tap_key(1, 0);
+    tap_key(6, 0);
+    EXPECT_FALSE(leading);
+    EXPECT_EQ(leader_fired, 0);
+    EXPECT_EQ(leader_ends, 1);
+
+    press_key(6, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_X)));
+    keyboard_task();
+    release_key(6, 0);
+    keyboard_task();
+}
+
+TEST_F(Leader, ScanUserSequencesAreMatchedAlongsideTheDictionary) {
+    TestDriver driver;
+    expect_no_keys(driver);
+    scan_user_sequences = true;
+
+    // Not in the dictionary, so left to LEADER_DICTIONARY() instead of ending right away
+    tap_key(0, 0);
+    tap_key(1, 0);
+    tap_key(6, 0);
+    EXPECT_TRUE(leading);
+    idle_for(LEADER_TIMEOUT + 2);
+    EXPECT_EQ(leader_fired, 7);
+    EXPECT_EQ(leader_ends, 1);
+    EXPECT_FALSE(leading);
+
+    tap_key(0, 0);
+    tap_key(6, 0);
+    idle_for(LEADER_TIMEOUT + 2);
+    EXPECT_EQ(leader_fired, 8);
+
+    // The dictionary still fires its own sequences, on the timeout too
+    tap_key(0, 0);
+    tap_key(4, 0);
+    tap_key(4, 0);
+    EXPECT_EQ(leader_fired, 4);
+    tap_key(0, 0);
+    tap_key(1, 0);
+    idle_for(LEADER_TIMEOUT + 2);
+    EXPECT_EQ(leader_fired, 1);
+    EXPECT_EQ(leader_ends, 4);
+}
+
+TEST_F(Leader, SequenceLengthIsConfigurable) {
+    TestDriver driver;
+    expect_no_keys(driver);
+
+    tap_key(0, 0);
+    const uint8_t keys[][2] = {{7, 0}, {8, 0}, {9, 0}, {0, 1}, {5, 0}, {1, 1}};
+    for (auto key : keys) {
+        tap_key(key[0], key[1]);
+    }
+    EXPECT_EQ(leader_fired, 0);
+    tap_key(2, 1);
+    EXPECT_EQ(leader_fired, 6);
+    EXPECT_EQ(leader_sequence_size, 7);
+}
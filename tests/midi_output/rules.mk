@@ -0,0 +1,19 @@
+# Copyright 2017 Fred Sundvik
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+CUSTOM_MATRIX=yes
+# The device independent MIDI code, without a USB driver
+SRC += $(TMK_DIR)/protocol/midi/midi.c $(TMK_DIR)/protocol/midi/midi_device.c $(TMK_DIR)/protocol/midi/bytequeue/bytequeue.c
+VPATH += $(TOP_DIR)/$(TMK_DIR)/protocol/midi
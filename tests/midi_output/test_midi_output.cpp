@@ -0,0 +1,225 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <array>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "midi.h"
+}
+
+using Message = std::array<uint8_t, 4>;  // count, bytes
+
+namespace {
+std::vector<Message>              sent;
+std::vector<std::vector<Message>> batches;
+
+void send_func(MidiDevice* device, uint16_t cnt, uint8_t byte0, uint8_t byte1, uint8_t byte2) { sent.push_back({(uint8_t)cnt, byte0, byte1, byte2}); }
+
+void send_batch_func(MidiDevice* device, uint8_t count, const midi_event_t* events) {
+    batches.emplace_back();
+    for (uint8_t i = 0; i < count; i++) {
+        Message message = {events[i].count, events[i].data[0], events[i].data[1], events[i].data[2]};
+        batches.back().push_back(message);
+        sent.push_back(message);
+    }
+}
+
+Message noteon(uint8_t chan, uint8_t note) { return {3, (uint8_t)(MIDI_NOTEON | chan), note, 127}; }
+Message noteoff(uint8_t chan, uint8_t note) { return {3, (uint8_t)(MIDI_NOTEOFF | chan), note, 0}; }
+Message cc(uint8_t chan, uint8_t num, uint8_t val) { return {3, (uint8_t)(MIDI_CC | chan), num, val}; }
+}  // namespace
+
+class MidiOutput : public testing::Test {
+   protected:
+    MidiDevice device;
+
+    void SetUp() override {
+        sent.clear();
+        batches.clear();
+        midi_device_init(&device);
+        midi_device_set_send_func(&device, send_func);
+        midi_device_set_send_batch_func(&device, send_batch_func);
+    }
+};
+
+TEST_F(MidiOutput, WithoutBatchFunctionEveryMessageIsSentRightAway) {
+    midi_device_set_send_batch_func(&device, NULL);
+    midi_send_noteon(&device, 1, 60, 127);
+    midi_send_cc(&device, 1, 7, 100);
+    midi_send_cc(&device, 1, 7, 101);
+    EXPECT_EQ(sent, (std::vector<Message>{noteon(1, 60), cc(1, 7, 100), cc(1, 7, 101)}));
+}
+
+TEST_F(MidiOutput, MessagesWaitForTheFlush) {
+    midi_send_noteon(&device, 0, 60, 127);
+    midi_send_noteon(&device, 0, 64, 127);
+    EXPECT_TRUE(sent.empty());
+
+    midi_device_flush(&device);
+    EXPECT_EQ(batches, (std::vector<std::vector<Message>>{{noteon(0, 60), noteon(0, 64)}}));
+
+    midi_device_flush(&device);
+    EXPECT_EQ(batches.size(), 1);
+}
+
+TEST_F(MidiOutput, BatchesKeepTheOrder) {
+    std::vector<Message> expected;
+    for (uint8_t i = 0; i < MIDI_OUTPUT_QUEUE_LENGTH + 8; i++) {
+        midi_send_noteon(&device, i % 16, i, 127);
+        midi_send_noteoff(&device, i % 16, i, 0);
+        expected.push_back(noteon(i % 16, i));
+        expected.push_back(noteoff(i % 16, i));
+    }
+    midi_device_flush(&device);
+
+    EXPECT_EQ(sent, expected);
+    for (auto& batch : batches) {
+        EXPECT_LE(batch.size(), MIDI_OUTPUT_BATCH_LENGTH);
+    }
+    // A full queue is sent early, in full batches
+    EXPECT_EQ(batches.size(), (expected.size() + MIDI_OUTPUT_BATCH_LENGTH - 1) / MIDI_OUTPUT_BATCH_LENGTH);
+}
+
+TEST_F(MidiOutput, FastArpeggioSendsOneTransferPerFrame) {
+    // Four notes starting and four ending every millisecond, flushed once per millisecond
+    const int frames = 100;
+    for (int frame = 0; frame < frames; frame++) {
+        for (uint8_t note = 0; note < 4; note++) {
+            midi_send_noteoff(&device, 0, 60 + note, 0);
+            midi_send_noteon(&device, 0, 72 + note, 127);
+        }
+        midi_device_flush(&device);
+    }
+    EXPECT_EQ(sent.size(), frames * 8);
+    EXPECT_EQ(batches.size(), frames);
+}
+
+TEST_F(MidiOutput, RedundantControlChangesAreDropped) {
+    midi_send_cc(&device, 0, 1, 10);
+    midi_send_cc(&device, 0, 1, 20);
+    midi_send_cc(&device, 0, 7, 100);
+    midi_send_cc(&device, 1, 1, 5);
+    midi_send_cc(&device, 0, 1, 30);
+    midi_send_cc(&device, 0, 1, 40);
+    midi_device_flush(&device);
+    EXPECT_EQ(sent, (std::vector<Message>{cc(0, 1, 20), cc(0, 7, 100), cc(1, 1, 5), cc(0, 1, 40)}));
+}
+
+TEST_F(MidiOutput, ParameterNumberSequencesAreKept) {
+    // Two RPNs set one after the other, and an NRPN stepped up twice
+    const std::vector<Message> sequence = {
+        cc(0, 101, 0), cc(0, 100, 0), cc(0, 6, 2), cc(0, 38, 0), cc(0, 101, 0), cc(0, 100, 1), cc(0, 6, 64), cc(0, 38, 0), cc(0, 99, 1), cc(0, 98, 8), cc(0, 96, 0), cc(0, 96, 0),
+    };
+    for (auto& message : sequence) {
+        midi_send_cc(&device, message[1] & 0x0F, message[2], message[3]);
+    }
+    midi_device_flush(&device);
+    EXPECT_EQ(sent, sequence);
+}
+
+TEST_F(MidiOutput, ControlChangesAroundNotesAreKept) {
+    midi_send_cc(&device, 0, 64, 127);
+    midi_send_noteon(&device, 0, 60, 127);
+    midi_send_cc(&device, 0, 64, 0);
+    midi_device_flush(&device);
+    EXPECT_EQ(sent, (std::vector<Message>{cc(0, 64, 127), noteon(0, 60), cc(0, 64, 0)}));
+
+    // Nothing is left to supersede a control change from an earlier flush
+    sent.clear();
+    midi_send_cc(&device, 0, 1, 1);
+    midi_device_flush(&device);
+    midi_send_cc(&device, 0, 1, 2);
+    midi_device_flush(&device);
+    EXPECT_EQ(sent, (std::vector<Message>{cc(0, 1, 1), cc(0, 1, 2)}));
+}
+
+TEST_F(MidiOutput, SysexIsBatchedInOrder) {
+    uint8_t sysex[] = {SYSEX_BEGIN, 0x7D, 1, 2, 3, 4, 5, SYSEX_END};
+    midi_send_array(&device, sizeof(sysex), sysex);
+    midi_send_cc(&device, 0, 1, 2);
+    midi_device_flush(&device);
+    EXPECT_EQ(sent, (std::vector<Message>{{3, SYSEX_BEGIN, 0x7D, 1}, {3, 2, 3, 4}, {2, 5, SYSEX_END, 0}, cc(0, 1, 2)}));
+    EXPECT_EQ(batches.size(), 1);
+}
+
+TEST(MidiRunningStatus, RepeatedStatusBytesAreLeftOut) {
+    uint8_t              running = 0;
+    std::vector<uint8_t> stream;
+    auto                 encode = [&](Message message) {
+        uint8_t out[3];
+        uint8_t length = midi_running_status_encode(&running, message[0], message[1], message[2], message[3], out);
+        stream.insert(stream.end(), out, out + length);
+    };
+
+    encode(noteon(0, 60));
+    encode(noteon(0, 64));
+    encode({1, MIDI_CLOCK, 0, 0});
+    encode(noteon(0, 67));
+    encode(noteon(1, 60));
+    encode({2, MIDI_PROGCHANGE | 1, 5, 0});
+    encode({2, MIDI_PROGCHANGE | 1, 6, 0});
+    encode({2, MIDI_SONGSELECT, 3, 0});
+    encode({2, MIDI_PROGCHANGE | 1, 7, 0});
+
+    std::vector<uint8_t> expected = {MIDI_NOTEON, 60, 127, 64, 127, MIDI_CLOCK, 67, 127, MIDI_NOTEON | 1, 60, 127, MIDI_PROGCHANGE | 1, 5, 6, MIDI_SONGSELECT, 3, MIDI_PROGCHANGE | 1, 7};
+    EXPECT_EQ(stream, expected);
+}
+
+TEST(MidiRunningStatus, SysexEndsTheRunningStatus) {
+    uint8_t running = 0;
+    uint8_t out[3];
+    EXPECT_EQ(midi_running_status_encode(&running, 3, MIDI_CC, 1, 2, out), 3);
+    EXPECT_EQ(midi_running_status_encode(&running, 3, SYSEX_BEGIN, 0x7D, 1, out), 3);
+    EXPECT_EQ(midi_running_status_encode(&running, 2, 2, SYSEX_END, 0, out), 2);
+    EXPECT_EQ(midi_running_status_encode(&running, 3, MIDI_CC, 1, 3, out), 3);
+    EXPECT_EQ(midi_running_status_encode(&running, 3, MIDI_CC, 1, 4, out), 2);
+}
+
+TEST(MidiByteQueue, OneWriterAndOneReaderNeedNoLock) {
+    const uint32_t total = 200000;
+    uint8_t        data[MIDI_INPUT_QUEUE_LENGTH];
+    byteQueue_t    queue;
+    bytequeue_init(&queue, data, sizeof(data));
+
+    std::thread writer([&] {
+        for (uint32_t i = 0; i < total; i++) {
+            while (!bytequeue_enqueue(&queue, (uint8_t)i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t received = 0;
+    bool     in_order = true;
+    while (received < total) {
+        byteQueueIndex_t length = bytequeue_length(&queue);
+        for (byteQueueIndex_t i = 0; i < length; i++) {
+            in_order &= bytequeue_get(&queue, i) == (uint8_t)(received + i);
+        }
+        bytequeue_remove(&queue, length);
+        received += length;
+        if (length == 0) {
+            std::this_thread::yield();
+        }
+    }
+    writer.join();
+
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(bytequeue_length(&queue), 0);
+}
@@ -0,0 +1,252 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <cmath>
+#include <vector>
+
+extern "C" {
+#include "mousekey.h"
+}
+
+using testing::_;
+using testing::Invoke;
+
+namespace {
+struct MouseReport {
+    uint16_t       time;
+    report_mouse_t report;
+};
+
+// Adds up the movement of every mouse report the host receives
+class MouseLog {
+   public:
+    explicit MouseLog(TestDriver& driver) {
+        EXPECT_CALL(driver, send_mouse_mock(_)).WillRepeatedly(Invoke([this](report_mouse_t& report) { reports.push_back({timer_read(), report}); }));
+    }
+
+    int x() const { return sum(&report_mouse_t::x); }
+    int y() const { return sum(&report_mouse_t::y); }
+    int v() const { return sum(&report_mouse_t::v); }
+    int h() const { return sum(&report_mouse_t::h); }
+
+    std::vector<MouseReport> reports;
+
+   private:
+    int sum(int8_t report_mouse_t::*axis) const {
+        int total = 0;
+        for (auto& r : reports) {
+            total += r.report.*axis;
+        }
+        return total;
+    }
+};
+
+void press(uint8_t code) {
+    mousekey_on(code);
+    mousekey_send();
+}
+
+void release(uint8_t code) {
+    mousekey_off(code);
+    mousekey_send();
+}
+}  // namespace
+
+class MousekeySmooth : public TestFixture {
+   protected:
+    MousekeySmooth() {
+        mousekey_clear();
+        mk_smooth_curve               = MOUSEKEY_SMOOTH_CURVE;
+        mk_smooth_initial_speed       = MOUSEKEY_SMOOTH_INITIAL_SPEED;
+        mk_smooth_max_speed           = MOUSEKEY_SMOOTH_MAX_SPEED;
+        mk_smooth_time_to_max         = MOUSEKEY_SMOOTH_TIME_TO_MAX;
+        mk_smooth_friction            = MOUSEKEY_SMOOTH_FRICTION;
+        mk_smooth_wheel_initial_speed = MOUSEKEY_SMOOTH_WHEEL_INITIAL_SPEED;
+        mk_smooth_wheel_max_speed     = MOUSEKEY_SMOOTH_WHEEL_MAX_SPEED;
+        mk_smooth_wheel_time_to_max   = MOUSEKEY_SMOOTH_WHEEL_TIME_TO_MAX;
+    }
+    ~MousekeySmooth() { mousekey_clear(); }
+};
+
+TEST_F(MousekeySmooth, TapMovesOnePixel) {
+    TestDriver driver;
+    MouseLog   log(driver);
+    press(KC_MS_RIGHT);
+    release(KC_MS_RIGHT);
+    idle_for(100);
+    EXPECT_EQ(log.x(), 1);
+    EXPECT_EQ(log.y(), 0);
+    EXPECT_EQ(log.reports.size(), 2);
+}
+
+TEST_F(MousekeySmooth, LinearCurveDistance) {
+    TestDriver driver;
+    MouseLog   log(driver);
+    mk_smooth_curve         = MK_CURVE_LINEAR;
+    mk_smooth_initial_speed = 100;
+    mk_smooth_max_speed     = 1100;
+    mk_smooth_time_to_max   = 1000;
+
+    press(KC_MS_LEFT);
+    idle_for(500);
+    // 1 for the press, then 100 px/s rising to 600 px/s
+    EXPECT_NEAR(log.x(), -176, 3);
+    idle_for(500);
+    EXPECT_NEAR(log.x(), -601, 3);
+    idle_for(1000);
+    EXPECT_NEAR(log.x(), -1701, 3);
+
+    // Stops when released, only the last whole pixels are still sent
+    release(KC_MS_LEFT);
+    int at_release = log.x();
+    idle_for(100);
+    EXPECT_GE(log.x(), at_release - 3);
+    EXPECT_EQ(log.y(), 0);
+}
+
+TEST_F(MousekeySmooth, QuadraticCurveStartsSlower) {
+    TestDriver driver;
+    MouseLog   log(driver);
+    mk_smooth_curve         = MK_CURVE_QUADRATIC;
+    mk_smooth_initial_speed = 100;
+    mk_smooth_max_speed     = 1100;
+    mk_smooth_time_to_max   = 1000;
+
+    press(KC_MS_DOWN);
+    idle_for(500);
+    // 1 + 100 * 0.5 + 1000 * 0.5^3 / 3
+    EXPECT_NEAR(log.y(), 93, 3);
+    idle_for(500);
+    // 1 + 100 + 1000 / 3
+    EXPECT_NEAR(log.y(), 434, 3);
+    idle_for(1000);
+    EXPECT_NEAR(log.y(), 1534, 3);
+}
+
+TEST_F(MousekeySmooth, KineticCurveGlidesAfterRelease) {
+    TestDriver driver;
+    MouseLog   log(driver);
+    mk_smooth_curve         = MK_CURVE_KINETIC;
+    mk_smooth_initial_speed = 50;
+    mk_smooth_max_speed     = 1000;
+    mk_smooth_time_to_max   = 900;
+    mk_smooth_friction      = 100;
+
+    press(KC_MS_RIGHT);
+    idle_for(900);
+    // The speed approaches 1000 px/s by 1 - e^-t/300
+    EXPECT_NEAR(log.x(), 1 + 50 + 950 * (0.9 - 0.3 * (1 - std::exp(-3.0))), 10);
+
+    release(KC_MS_RIGHT);
+    int at_release = log.x();
+    idle_for(1000);
+    // Friction slows it down from about 950 px/s, over about 0.1 s
+    EXPECT_NEAR(log.x() - at_release, 95 * (1 - 50 / 950.0), 10);
+    EXPECT_LT(log.reports.back().time, timer_read() - 500);
+}
+
+TEST_F(MousekeySmooth, SlowSpeedKeepsSubPixels) {
+    TestDriver driver;
+    MouseLog   log(driver);
+    mk_smooth_initial_speed = 10;
+    mk_smooth_max_speed     = 10;
+
+    press(KC_MS_UP);
+    idle_for(1000);
+    EXPECT_EQ(log.y(), -11);
+    for (auto& r : log.reports) {
+        EXPECT_EQ(r.report.y, -1);
+    }
+    EXPECT_NEAR(log.reports.back().time - log.reports[1].time, 900, 2);
+}
+
+TEST_F(MousekeySmooth, DiagonalsAreAsFastAsStraightLines) {
+    TestDriver driver;
+    MouseLog   log(driver);
+    mk_smooth_time_to_max = 0;
+
+    press(KC_MS_RIGHT);
+    press(KC_MS_DOWN);
+    idle_for(1000);
+    EXPECT_NEAR(log.x(), 1 + 707, 3);
+    EXPECT_NEAR(log.y(), 1 + 707, 3);
+}
+
+TEST_F(MousekeySmooth, ReportsEveryPollingInterval) {
+    TestDriver driver;
+    MouseLog   log(driver);
+    mk_smooth_time_to_max = 0;
+
+    press(KC_MS_RIGHT);
+    idle_for(100);
+    EXPECT_NEAR(log.reports.size(), 1 + 100 / USB_POLLING_INTERVAL_MS, 1);
+    for (size_t i = 2; i < log.reports.size(); i++) {
+        EXPECT_EQ(log.reports[i].time - log.reports[i - 1].time, USB_POLLING_INTERVAL_MS);
+        EXPECT_LE(log.reports[i].report.x, 3);
+    }
+}
+
+TEST_F(MousekeySmooth, AccelKeysSetAConstantSpeed) {
+    TestDriver driver;
+    MouseLog   log(driver);
+
+    press(KC_MS_ACCEL0);
+    press(KC_MS_RIGHT);
+    idle_for(1000);
+    EXPECT_NEAR(log.x(), 1 + MOUSEKEY_SMOOTH_MAX_SPEED / 4, 3);
+    release(KC_MS_ACCEL0);
+    press(KC_MS_ACCEL2);
+    idle_for(1000);
+    EXPECT_NEAR(log.x(), 1 + MOUSEKEY_SMOOTH_MAX_SPEED / 4 + MOUSEKEY_SMOOTH_MAX_SPEED, 3);
+}
+
+TEST_F(MousekeySmooth, WheelScrolls) {
+    TestDriver driver;
+    MouseLog   log(driver);
+
+    press(KC_MS_WH_UP);
+    idle_for(1000);
+    // 1 + 10 + 70 * (1 / 4)^2 / 3 with the default quadratic curve
+    EXPECT_NEAR(log.v(), 12, 1);
+    release(KC_MS_WH_UP);
+    idle_for(100);
+    press(KC_MS_WH_LEFT);
+    idle_for(1000);
+    EXPECT_NEAR(log.h(), -11, 1);
+    EXPECT_EQ(log.x(), 0);
+    EXPECT_EQ(log.y(), 0);
+}
+
+TEST_F(MousekeySmooth, KeysFromTheMatrix) {
+    TestDriver driver;
+    MouseLog   log(driver);
+
+    press_key(0, 0);  // KC_MS_R
+    press_key(4, 0);  // KC_BTN1
+    idle_for(500);
+    release_key(0, 0);
+    release_key(4, 0);
+    idle_for(100);
+    EXPECT_GT(log.x(), 20);
+    EXPECT_EQ(log.y(), 0);
+    EXPECT_EQ(log.reports.back().report.buttons, 0);
+    bool clicked = false;
+    for (auto& r : log.reports) {
+        clicked |= r.report.buttons == MOUSE_BTN1;
+    }
+    EXPECT_TRUE(clicked);
+}
@@ -0,0 +1,260 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "pointing_device.h"
+}
+
+using testing::_;
+using testing::Invoke;
+
+namespace {
+struct MouseReport {
+    uint16_t       time;
+    report_mouse_t report;
+};
+
+// Keeps every mouse report the host receives
+class MouseLog {
+   public:
+    explicit MouseLog(TestDriver& driver) {
+        EXPECT_CALL(driver, send_mouse_mock(_)).WillRepeatedly(Invoke([this](report_mouse_t& report) { reports.push_back({timer_read(), report}); }));
+    }
+
+    int x() const {
+        return sum([](const report_mouse_t& r) { return r.x; });
+    }
+    int y() const {
+        return sum([](const report_mouse_t& r) { return r.y; });
+    }
+    int v() const {
+        return sum([](const report_mouse_t& r) { return r.v; });
+    }
+    int h() const {
+        return sum([](const report_mouse_t& r) { return r.h; });
+    }
+
+    std::vector<MouseReport> reports;
+
+   private:
+    template <typename F>
+    int sum(F axis) const {
+        int total = 0;
+        for (auto& r : reports) {
+            total += axis(r.report);
+        }
+        return total;
+    }
+};
+
+// A high DPI sensor read by a fixed rate timer, with deltas that repeat every few hundred reads
+class FakeSensor {
+   public:
+    void read() {
+        int16_t x = (int16_t)(reads * 37 % 601) - 300;
+        int16_t y = (int16_t)(reads * 53 % 241) - 120;
+        pointing_device_push_motion(x, y);
+        total_x += x;
+        total_y += y;
+        reads++;
+    }
+
+    long total_x = 0;
+    long total_y = 0;
+
+   private:
+    long reads = 0;
+};
+}  // namespace
+
+class PointingDevice : public TestFixture {
+   protected:
+    // The host has enabled the resolution multiplier, unless a test says otherwise
+    PointingDevice() { mouse_resolution_multiplier = 1; }
+
+    // Sends whatever is still pending, so every test starts from a quiet pointer
+    void drain() {
+        report_mouse_t report = pointing_device_get_report();
+        report.buttons        = 0;
+        pointing_device_set_report(report);
+        idle_for(5000);
+    }
+    ~PointingDevice() {
+        mouse_resolution_multiplier = 1;
+        TestDriver driver;
+        EXPECT_CALL(driver, send_mouse_mock(_)).Times(testing::AnyNumber());
+        drain();
+    }
+};
+
+TEST_F(PointingDevice, FakeSensorMotionIsConserved) {
+    TestDriver driver;
+    MouseLog   log(driver);
+    FakeSensor sensor;
+
+    for (int ms = 0; ms < 2000; ms++) {
+        sensor.read();
+        run_one_scan_loop();
+    }
+    idle_for(2000);
+
+    EXPECT_EQ(log.x(), sensor.total_x);
+    EXPECT_EQ(log.y(), sensor.total_y);
+    for (auto& r : log.reports) {
+        EXPECT_LE(abs(r.report.x), 127);
+        EXPECT_LE(abs(r.report.y), 127);
+    }
+}
+
+TEST_F(PointingDevice, SensorThreadMotionIsConserved) {
+    TestDriver        driver;
+    MouseLog          log(driver);
+    std::atomic<bool> done(false);
+    const int         pushes = 100000;
+
+    // The thread plays the sensor ISR, the loop below keyboard_task()
+    std::thread sensor([&done, pushes]() {
+        for (int i = 0; i < pushes; i++) {
+            pointing_device_push_motion(i % 2 ? 7 : -7 + (i % 100 == 0), i % 2 ? -3 : 3);
+        }
+        done = true;
+    });
+    while (!done) {
+        run_one_scan_loop();
+    }
+    sensor.join();
+    idle_for(200);
+
+    EXPECT_EQ(log.x(), pushes / 100);
+    EXPECT_EQ(log.y(), 0);
+}
+
+TEST_F(PointingDevice, LargeDeltaIsSplitAcrossReports) {
+    TestDriver driver;
+    MouseLog   log(driver);
+
+    pointing_device_add_motion(1000, -300);
+    idle_for(200);
+
+    EXPECT_EQ(log.x(), 1000);
+    EXPECT_EQ(log.y(), -300);
+    ASSERT_EQ(log.reports.size(), 8);
+    EXPECT_EQ(log.reports[0].report.x, 127);
+    EXPECT_EQ(log.reports[0].report.y, -127);
+    EXPECT_EQ(log.reports[7].report.x, 1000 - 7 * 127);
+    EXPECT_EQ(log.reports[7].report.y, 0);
+}
+
+TEST_F(PointingDevice, ReportsAreCoalescedToTheInterval) {
+    TestDriver driver;
+    MouseLog   log(driver);
+
+    for (int ms = 0; ms < 100; ms++) {
+        pointing_device_add_motion(1, 2);
+        run_one_scan_loop();
+    }
+    idle_for(100);
+
+    EXPECT_EQ(log.x(), 100);
+    EXPECT_EQ(log.y(), 200);
+    EXPECT_LE(log.reports.size(), 100 / POINTING_DEVICE_INTERVAL + 1);
+    for (size_t i = 1; i < log.reports.size(); i++) {
+        EXPECT_GE((uint16_t)(log.reports[i].time - log.reports[i - 1].time), POINTING_DEVICE_INTERVAL);
+    }
+}
+
+TEST_F(PointingDevice, ButtonsAreNotDelayed) {
+    TestDriver driver;
+    MouseLog   log(driver);
+
+    pointing_device_add_motion(5, 0);
+    run_one_scan_loop();
+    ASSERT_EQ(log.reports.size(), 1);
+
+    report_mouse_t report = pointing_device_get_report();
+    report.buttons |= MOUSE_BTN1;
+    pointing_device_set_report(report);
+    run_one_scan_loop();
+    ASSERT_EQ(log.reports.size(), 2);
+    EXPECT_EQ(log.reports[1].report.buttons, MOUSE_BTN1);
+    EXPECT_EQ(log.reports[1].time, log.reports[0].time + 1);
+}
+
+TEST_F(PointingDevice, MotionSetInTheReportIsKept) {
+    TestDriver driver;
+    MouseLog   log(driver);
+
+    for (int ms = 0; ms < 20; ms++) {
+        report_mouse_t report = pointing_device_get_report();
+        report.x              = 100;
+        report.v              = -1;
+        pointing_device_set_report(report);
+        run_one_scan_loop();
+    }
+    // 127 per report, one report every interval
+    idle_for(200);
+
+    EXPECT_EQ(log.x(), 2000);
+    EXPECT_EQ(log.v(), -20);
+}
+
+TEST_F(PointingDevice, HighResolutionScroll) {
+    TestDriver driver;
+    MouseLog   log(driver);
+
+    // A quarter notch at a time adds up to one notch
+    for (int i = 0; i < 4; i++) {
+        pointing_device_add_scroll(POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER / 4, 0);
+    }
+    run_one_scan_loop();
+    ASSERT_EQ(log.reports.size(), 1);
+    EXPECT_EQ(log.v(), POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER);
+
+    // Many notches still fit in one report
+    pointing_device_add_scroll(0, -10 * POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER);
+    idle_for(POINTING_DEVICE_INTERVAL);
+    ASSERT_EQ(log.reports.size(), 2);
+    EXPECT_EQ(log.reports[1].report.h, -10 * POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER);
+}
+
+TEST_F(PointingDevice, WholeNotchesUntilTheHostEnablesTheMultiplier) {
+    TestDriver driver;
+    MouseLog   log(driver);
+    mouse_resolution_multiplier = 0;
+
+    // Half a notch is kept until it adds up to whole notches
+    pointing_device_add_scroll(POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER / 2, 0);
+    idle_for(POINTING_DEVICE_INTERVAL);
+    EXPECT_TRUE(log.reports.empty());
+
+    pointing_device_add_scroll(POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER / 2 + 3 * POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER, 0);
+    idle_for(POINTING_DEVICE_INTERVAL);
+    ASSERT_EQ(log.reports.size(), 1);
+    EXPECT_EQ(log.reports[0].report.v, 4);
+
+    // Once the host sets the feature report, fractions of a notch go out as they are
+    mouse_resolution_multiplier = 1;
+    pointing_device_add_scroll(30, 0);
+    idle_for(POINTING_DEVICE_INTERVAL);
+    ASSERT_EQ(log.reports.size(), 2);
+    EXPECT_EQ(log.reports[1].report.v, 30);
+}
@@ -0,0 +1,45 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] =
+        {
+            // 0    1        2        3        4      5        6        7      8      9
+            {KC_A, KC_GESC, NK_TOGG, UC_M_LN, TD(0), KC_LSPO, KC_LOCK, KC_NO, KC_NO, KC_NO},
+            {KC_C, KC_D, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+            {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+            {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        },
+};
+
+qk_tap_dance_action_t tap_dance_actions[] = {
+    [0] = ACTION_TAP_DANCE_DOUBLE(KC_X, KC_Y),
+};
+
+const uint16_t PROGMEM cd_combo[] = {KC_C, KC_D, COMBO_END};
+
+combo_t key_combos[COMBO_COUNT] = {COMBO(cd_combo, KC_ESC)};
+
+led_config_t g_led_config = {{{0}}, {{0, 0}}, {LED_FLAG_KEYLIGHT}};
+
+static void init(void) {}
+static void set_color(int index, uint8_t r, uint8_t g, uint8_t b) {}
+static void set_color_all(uint8_t r, uint8_t g, uint8_t b) {}
+static void flush(void) {}
+
+const rgb_matrix_driver_t rgb_matrix_driver = {init, set_color, set_color_all, flush};
@@ -0,0 +1,35 @@
+# Copyright 2017 Fred Sundvik
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+CUSTOM_MATRIX=yes
+# Every handler process_record_handlers() can call on this platform.
+# Audio, MIDI, VIA and the terminal don't build for the tests.
+TAP_DANCE_ENABLE = yes
+COMBO_ENABLE = yes
+LEADER_ENABLE = yes
+UNICODE_ENABLE = yes
+KEY_LOCK_ENABLE = yes
+DYNAMIC_MACRO_ENABLE = yes
+AUTO_SHIFT_ENABLE = yes
+STENO_ENABLE = yes
+VIRTSER_ENABLE = no
+RGB_MATRIX_ENABLE = custom
+BACKLIGHT_ENABLE = yes
+BACKLIGHT_DRIVER = custom
+
+# The test counts the calls each handler gets
+LDFLAGS += -Wl,--wrap=process_dynamic_macro,--wrap=process_rgb_matrix,--wrap=process_tap_dance,--wrap=process_leader
+LDFLAGS += -Wl,--wrap=process_combo,--wrap=process_auto_shift,--wrap=process_space_cadet,--wrap=process_backlight
+LDFLAGS += -Wl,--wrap=process_steno,--wrap=process_unicode_common,--wrap=process_magic,--wrap=process_grave_esc,--wrap=process_rgb
@@ -0,0 +1,168 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+namespace {
+std::map<std::string, int> calls;
+bool                       call_handlers = true;
+
+struct ranged_handler_t {
+    std::string                                name;
+    std::vector<std::pair<uint16_t, uint16_t>> ranges;
+    bool                                       pressed_only;
+};
+
+// The handlers process_record_handlers() skips for keycodes outside their ranges
+const std::vector<ranged_handler_t> ranged_handlers = {
+    {"process_backlight", {{BL_ON, BL_BRTG}}, true},
+    {"process_steno", {{QK_STENO, QK_STENO_MAX}}, false},
+    {"process_unicode_common", {{UNICODE_MODE_FORWARD, UNICODE_MODE_WINC}, {QK_UNICODE, QK_UNICODE_MAX}}, false},
+    {"process_magic", {{MAGIC_SWAP_CONTROL_CAPSLOCK, MAGIC_TOGGLE_ALT_GUI}, {MAGIC_SWAP_LCTL_LGUI, MAGIC_EE_HANDS_RIGHT}}, true},
+    {"process_grave_esc", {{GRAVE_ESC, GRAVE_ESC}}, false},
+    {"process_rgb", {{RGB_TOG, RGB_MODE_RGBTEST}}, false},
+};
+
+// The handlers that see every key
+const std::vector<std::string> unranged_handlers = {
+    "process_dynamic_macro", "process_rgb_matrix", "process_tap_dance", "process_leader", "process_combo", "process_auto_shift", "process_space_cadet",
+};
+
+bool in_ranges(uint16_t keycode, const std::vector<std::pair<uint16_t, uint16_t>>& ranges) {
+    for (auto& range : ranges) {
+        if (keycode >= range.first && keycode <= range.second) {
+            return true;
+        }
+    }
+    return false;
+}
+}  // namespace
+
+// Each handler is linked with -Wl,--wrap (see rules.mk), so the calls from
+// process_record_handlers() come here first.
+#define COUNT_CALLS(handler)                                                \
+    extern "C" bool __real_##handler(uint16_t keycode, keyrecord_t* record); \
+    extern "C" bool __wrap_##handler(uint16_t keycode, keyrecord_t* record) { \
+        calls[#handler]++;                                                  \
+        return !call_handlers || __real_##handler(keycode, record);         \
+    }
+
+COUNT_CALLS(process_dynamic_macro)
+COUNT_CALLS(process_rgb_matrix)
+COUNT_CALLS(process_tap_dance)
+COUNT_CALLS(process_leader)
+COUNT_CALLS(process_combo)
+COUNT_CALLS(process_auto_shift)
+COUNT_CALLS(process_space_cadet)
+COUNT_CALLS(process_backlight)
+COUNT_CALLS(process_steno)
+COUNT_CALLS(process_unicode_common)
+COUNT_CALLS(process_magic)
+COUNT_CALLS(process_grave_esc)
+COUNT_CALLS(process_rgb)
+
+class ProcessRecordDispatch : public TestFixture {
+   public:
+    ~ProcessRecordDispatch() { call_handlers = true; }
+};
+
+TEST_F(ProcessRecordDispatch, PlainKeyIsTyped) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    keyboard_task();
+
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+}
+
+TEST_F(ProcessRecordDispatch, RangedHandlerStillSeesItsKeycode) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ESC)));
+    keyboard_task();
+
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+}
+
+TEST_F(ProcessRecordDispatch, PressOnlyHandlerIgnoresRelease) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    bool nkro = keymap_config.nkro;
+
+    press_key(2, 0);
+    keyboard_task();
+    EXPECT_NE(keymap_config.nkro, nkro);
+
+    release_key(2, 0);
+    keyboard_task();
+    EXPECT_NE(keymap_config.nkro, nkro);
+
+    press_key(2, 0);
+    keyboard_task();
+    release_key(2, 0);
+    keyboard_task();
+    EXPECT_EQ(keymap_config.nkro, nkro);
+}
+
+TEST_F(ProcessRecordDispatch, HandlersWithSeveralRangesAreReached) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    set_unicode_input_mode(UC_MAC);
+
+    press_key(3, 0);
+    keyboard_task();
+    release_key(3, 0);
+    keyboard_task();
+    EXPECT_EQ(get_unicode_input_mode(), UC_LNX);
+}
+
+TEST_F(ProcessRecordDispatch, HandlersOnlySeeTheirKeycodes) {
+    call_handlers = false;
+
+    for (uint32_t keycode = 0; keycode <= 0xFFFF; keycode++) {
+        for (bool pressed : {true, false}) {
+            keyrecord_t record   = {};
+            record.event.key     = (keypos_t){.col = 9, .row = 3};
+            record.event.pressed = pressed;
+            record.event.time    = 1;
+
+            calls.clear();
+            ASSERT_TRUE(process_record_handlers(keycode, &record));
+            for (auto& handler : unranged_handlers) {
+                ASSERT_EQ(calls[handler], 1) << handler << " for keycode 0x" << std::hex << keycode;
+            }
+            for (auto& handler : ranged_handlers) {
+                int expected = in_ranges(keycode, handler.ranges) && (pressed || !handler.pressed_only) ? 1 : 0;
+                ASSERT_EQ(calls[handler.name], expected) << handler.name << " for keycode 0x" << std::hex << keycode << (pressed ? " pressed" : " released");
+            }
+        }
+    }
+}
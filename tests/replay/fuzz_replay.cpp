@@ -0,0 +1,63 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "trace_replay.hpp"
+
+/* Every two bytes of input toggle one of the keys on row 0 after a delay of
+ * up to 255 ms. The keys still held at the end are released. */
+ReplayResult replay_fuzz_input(TestDriver& driver, const uint8_t* data, size_t size) {
+    std::vector<TraceEvent> events;
+    bool                    held[MATRIX_COLS] = {};
+    uint32_t                time              = 0;
+
+    for (size_t i = 0; i + 1 < size; i += 2) {
+        uint8_t col = data[i] % MATRIX_COLS;
+        time += data[i + 1];
+        held[col] = !held[col];
+        events.push_back({time, 0, col, held[col]});
+    }
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        if (held[col]) {
+            events.push_back({time + 1, 0, col, false});
+        }
+    }
+    return replay_trace(driver, events, TAPPING_TERM * 2);
+}
+
+/* Entry point for libFuzzer, see docs/unit_testing.md. Stuck keys abort,
+ * and so do waiting buffer overflows with REPLAY_FUZZ_OVERFLOW defined. */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    static bool initialized = false;
+    if (!initialized) {
+        TestFixture::SetUpTestCase();
+        initialized = true;
+    }
+
+    TestDriver   driver;
+    ReplayResult result = replay_fuzz_input(driver, data, size);
+    layer_clear();
+    if (result.stuck_keys) {
+        abort();
+    }
+#ifdef REPLAY_FUZZ_OVERFLOW
+    if (result.waiting_buffer_overflows) {
+        abort();
+    }
+#endif
+    return 0;
+}
@@ -0,0 +1,83 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "trace_replay.hpp"
+#include <random>
+
+ReplayResult replay_fuzz_input(TestDriver& driver, const uint8_t* data, size_t size);
+
+namespace {
+const char* const traces[] = {"mod_tap_roll", "layer_tap", "combo", "combo_flushed"};
+
+void print_rate(const char* name, uint32_t events, double seconds) { std::cout << name << ": " << events << " events, " << (uint32_t)(events / seconds) << " events/s" << std::endl; }
+}  // namespace
+
+class Replay : public TestFixture {};
+
+TEST_F(Replay, TracesMatchTheirGoldenReports) {
+    for (auto name : traces) {
+        TestDriver              driver;
+        std::vector<TraceEvent> events;
+        std::string             error;
+        std::string             path = std::string("tests/replay/traces/") + name;
+
+        ASSERT_TRUE(load_trace(path + ".trace", events, error)) << error;
+        ReplayResult result = replay_trace(driver, events, TAPPING_TERM * 2);
+
+        EXPECT_TRUE(matches_golden(result, path + ".golden"));
+        EXPECT_FALSE(result.stuck_keys) << name;
+        EXPECT_EQ(result.waiting_buffer_overflows, 0) << name;
+        print_rate(name, result.events, result.seconds);
+    }
+}
+
+TEST_F(Replay, RejectsMalformedTraces) {
+    std::vector<TraceEvent> events;
+    std::string             error;
+    std::istringstream      backwards("10 d 0 0\n5 u 0 0\n");
+    std::istringstream      unknown("# comment\n\n0 x 0 0\n");
+
+    EXPECT_FALSE(parse_trace(backwards, events, error));
+    EXPECT_EQ(error, "line 2: 5 u 0 0");
+    events.clear();
+    EXPECT_FALSE(parse_trace(unknown, events, error));
+    EXPECT_EQ(error, "line 3: 0 x 0 0");
+}
+
+TEST_F(Replay, RandomInputLeavesNoKeysStuck) {
+    std::mt19937         random(0x1e7);
+    std::vector<uint8_t> input(96);
+    uint32_t             events    = 0;
+    uint32_t             overflows = 0;
+    double               seconds   = 0;
+
+    for (int i = 0; i < 200; i++) {
+        for (auto& byte : input) {
+            byte = random();
+        }
+        TestDriver   driver;
+        ReplayResult result = replay_fuzz_input(driver, input.data(), input.size());
+        ASSERT_FALSE(result.stuck_keys) << "input " << i;
+        events += result.events;
+        overflows += result.waiting_buffer_overflows;
+        seconds += result.seconds;
+        layer_clear();
+    }
+    print_rate("random input", events, seconds);
+    std::cout << overflows << " waiting buffer overflows" << std::endl;
+}
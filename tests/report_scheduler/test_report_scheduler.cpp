@@ -0,0 +1,136 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class ReportScheduler : public TestFixture {
+   public:
+    ReportScheduler() { host_keyboard_report_stats_clear(); }
+};
+
+TEST_F(ReportScheduler, IdenticalReportIsDropped) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    register_code(KC_A);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(KEYBOARD_REPORT_INTERVAL + 1);
+    send_keyboard_report();
+    send_keyboard_report();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    host_report_stats_t stats = host_keyboard_report_stats();
+    EXPECT_EQ(stats.sent, 1);
+    EXPECT_EQ(stats.dropped, 2);
+    EXPECT_EQ(stats.merged, 0);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    unregister_code(KC_A);
+}
+
+TEST_F(ReportScheduler, ReportsInOneIntervalAreMerged) {
+    TestDriver driver;
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    register_code(KC_LSFT);
+    register_code(KC_A);
+    register_code(KC_B);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_A, KC_B)));
+    idle_for(KEYBOARD_REPORT_INTERVAL + 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    host_report_stats_t stats = host_keyboard_report_stats();
+    EXPECT_EQ(stats.sent, 2);
+    EXPECT_EQ(stats.merged, 1);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    unregister_code(KC_A);
+    unregister_code(KC_B);
+    unregister_code(KC_LSFT);
+    idle_for(KEYBOARD_REPORT_INTERVAL + 1);
+}
+
+TEST_F(ReportScheduler, TapIsNotMergedAway) {
+    TestDriver driver;
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    tap_code(KC_A);
+    idle_for(KEYBOARD_REPORT_INTERVAL + 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    tap_code(KC_B);
+    tap_code(KC_C);
+    idle_for(KEYBOARD_REPORT_INTERVAL + 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // The release of KC_B is folded into the press of KC_C
+    host_report_stats_t stats = host_keyboard_report_stats();
+    EXPECT_EQ(stats.sent, 5);
+    EXPECT_EQ(stats.merged, 1);
+}
+
+TEST_F(ReportScheduler, FastRepeatedTapsKeepEveryEdge) {
+    TestDriver driver;
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    press_key(0, 0);
+    run_one_scan_loop();
+    release_key(0, 0);
+    run_one_scan_loop();
+    press_key(0, 0);
+    run_one_scan_loop();
+    release_key(0, 0);
+    idle_for(KEYBOARD_REPORT_INTERVAL + 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    host_report_stats_t stats = host_keyboard_report_stats();
+    EXPECT_EQ(stats.sent, 4);
+    EXPECT_EQ(stats.merged, 0);
+}
+
+TEST_F(ReportScheduler, ReleaseAndNextPressShareAReport) {
+    TestDriver driver;
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    press_key(0, 0);
+    run_one_scan_loop();
+    release_key(0, 0);
+    run_one_scan_loop();
+    press_key(1, 0);
+    run_one_scan_loop();
+    release_key(1, 0);
+    idle_for(KEYBOARD_REPORT_INTERVAL + 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    host_report_stats_t stats = host_keyboard_report_stats();
+    EXPECT_EQ(stats.sent, 3);
+    EXPECT_EQ(stats.merged, 1);
+}
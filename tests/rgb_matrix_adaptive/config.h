@@ -0,0 +1,32 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTS_RGB_MATRIX_ADAPTIVE_CONFIG_H_
+#define TESTS_RGB_MATRIX_ADAPTIVE_CONFIG_H_
+
+#define MATRIX_ROWS 4
+#define MATRIX_COLS 10
+
+// A large board, the test driver takes 20 us to set each LED
+#define DRIVER_LED_TOTAL 200
+#define LED_COST_US 20
+
+#define RGB_MATRIX_ADAPTIVE_RENDER
+#define RGB_MATRIX_RENDER_BUDGET_US 500
+#define RGB_MATRIX_TYPING_RENDER_BUDGET_US 120
+#define RGB_MATRIX_STARTUP_MODE RGB_MATRIX_SOLID_COLOR
+
+#endif /* TESTS_RGB_MATRIX_ADAPTIVE_CONFIG_H_ */
@@ -0,0 +1,55 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+void advance_time_us(uint32_t us);
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {[0 ... MATRIX_ROWS - 1] = {[0 ... MATRIX_COLS - 1] = KC_A}},
+};
+
+led_config_t g_led_config = {
+    {[0 ... MATRIX_ROWS - 1] = {[0 ... MATRIX_COLS - 1] = NO_LED}},
+    {[0 ... DRIVER_LED_TOTAL - 1] = {112, 32}},
+    {[0 ... DRIVER_LED_TOTAL - 1] = LED_FLAG_KEYLIGHT},
+};
+
+// Checks that every frame sets each LED exactly once
+uint8_t led_writes[DRIVER_LED_TOTAL];
+bool    frame_mismatch = false;
+
+static void init(void) {}
+
+static void set_color(int index, uint8_t r, uint8_t g, uint8_t b) {
+    led_writes[index]++;
+    advance_time_us(LED_COST_US);
+}
+
+static void set_color_all(uint8_t r, uint8_t g, uint8_t b) {
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        set_color(i, r, g, b);
+    }
+}
+
+static void flush(void) {
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        frame_mismatch |= led_writes[i] != 1;
+        led_writes[i] = 0;
+    }
+}
+
+const rgb_matrix_driver_t rgb_matrix_driver = {init, set_color, set_color_all, flush};
@@ -0,0 +1,90 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "rgb_matrix.h"
+extern bool frame_mismatch;
+}
+
+using testing::_;
+
+class RgbMatrixAdaptive : public TestFixture {
+   protected:
+    RgbMatrixAdaptive() {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+        // Lets the renderer learn what an LED costs, then starts counting afresh
+        idle_for(1000);
+        rgb_matrix_render_stats_clear();
+        frame_mismatch = false;
+    }
+
+    // Taps a key every 100 ms for `ms`
+    void type_for(uint32_t ms) {
+        for (uint32_t t = 0; t < ms; t += 100) {
+            press_key(0, 0);
+            idle_for(50);
+            release_key(0, 0);
+            idle_for(50);
+        }
+    }
+
+    TestDriver driver;
+};
+
+TEST_F(RgbMatrixAdaptive, ChunksFitTheBudget) {
+    idle_for(2000);
+
+    rgb_matrix_render_stats_t stats = rgb_matrix_render_stats();
+    EXPECT_EQ(stats.led_cost, LED_COST_US * 16);
+    EXPECT_EQ(stats.chunk_max, RGB_MATRIX_RENDER_BUDGET_US / LED_COST_US);
+    EXPECT_EQ(stats.overruns, 0);
+    EXPECT_FALSE(frame_mismatch);
+}
+
+TEST_F(RgbMatrixAdaptive, IdleHitsTheTargetFrameRate) {
+    idle_for(3000);
+
+    rgb_matrix_render_stats_t stats = rgb_matrix_render_stats();
+    EXPECT_GE(stats.fps, RGB_MATRIX_TARGET_FPS - 1);
+    EXPECT_LE(stats.fps, RGB_MATRIX_TARGET_FPS);
+}
+
+TEST_F(RgbMatrixAdaptive, TypingBacksOff) {
+    // The scan that sees the first press renders before the key is processed
+    press_key(0, 0);
+    run_one_scan_loop();
+    rgb_matrix_render_stats_clear();
+    release_key(0, 0);
+
+    type_for(3000);
+
+    rgb_matrix_render_stats_t typing = rgb_matrix_render_stats();
+    EXPECT_EQ(typing.chunk_max, RGB_MATRIX_TYPING_RENDER_BUDGET_US / LED_COST_US);
+    EXPECT_EQ(typing.overruns, 0);
+    // 34 scans for a frame of 200 LEDs at 6 per scan
+    EXPECT_LE(typing.fps, 30);
+    EXPECT_GT(typing.fps, 20);
+    EXPECT_FALSE(frame_mismatch);
+
+    // And speeds up again when the typing stops
+    idle_for(RGB_MATRIX_TYPING_TIMEOUT + 2000);
+    rgb_matrix_render_stats_t idle = rgb_matrix_render_stats();
+    EXPECT_EQ(idle.chunk, RGB_MATRIX_RENDER_BUDGET_US / LED_COST_US);
+    EXPECT_GE(idle.fps, RGB_MATRIX_TARGET_FPS - 1);
+    EXPECT_EQ(idle.overruns, 0);
+}
@@ -0,0 +1,34 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {{KC_A, KC_B}, {KC_C, KC_D}},
+};
+
+led_config_t g_led_config = {
+    {{0, 1}, {2, 3}},
+    {{0, 0}, {224, 0}, {0, 64}, {224, 64}},
+    {LED_FLAG_KEYLIGHT, LED_FLAG_KEYLIGHT, LED_FLAG_KEYLIGHT, LED_FLAG_KEYLIGHT},
+};
+
+static void init(void) {}
+static void set_color(int index, uint8_t r, uint8_t g, uint8_t b) {}
+static void set_color_all(uint8_t r, uint8_t g, uint8_t b) {}
+static void flush(void) {}
+
+const rgb_matrix_driver_t rgb_matrix_driver = {init, set_color, set_color_all, flush};
@@ -0,0 +1,50 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "rgb_matrix.h"
+}
+
+namespace {
+const std::vector<std::string> effects = {
+#define RGB_MATRIX_EFFECT(name, ...) #name,
+#include "rgb_matrix_animations/rgb_matrix_effects.inc"
+#undef RGB_MATRIX_EFFECT
+};
+}  // namespace
+
+class RgbMatrixEffects : public TestFixture {};
+
+TEST_F(RgbMatrixEffects, OnlyTheListedEffectsAreBuilt) {
+    EXPECT_EQ(effects, std::vector<std::string>({"SOLID_COLOR", "BREATHING", "CYCLE_ALL", "SOLID_REACTIVE_SIMPLE"}));
+    EXPECT_EQ(RGB_MATRIX_EFFECT_MAX, 5);
+    EXPECT_EQ(RGB_MATRIX_BREATHING, 2);
+}
+
+TEST_F(RgbMatrixEffects, StepVisitsEveryListedEffect) {
+    TestDriver driver;
+
+    rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_COLOR);
+    for (uint8_t mode = 2; mode <= RGB_MATRIX_EFFECT_MAX; mode++) {
+        rgb_matrix_step();
+        EXPECT_EQ(rgb_matrix_get_mode(), mode < RGB_MATRIX_EFFECT_MAX ? mode : 1);
+        idle_for(50);
+    }
+}
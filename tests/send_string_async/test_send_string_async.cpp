@@ -0,0 +1,141 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::Invoke;
+
+namespace {
+typedef std::vector<std::vector<uint8_t>> report_log_t;
+
+void record_reports(TestDriver& driver, report_log_t& log) {
+    EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke([&log](report_keyboard_t& report) { log.emplace_back(report.raw, report.raw + sizeof(report.raw)); }));
+}
+
+std::vector<uint8_t> pressed_keys(const report_log_t& log) {
+    std::vector<uint8_t> result;
+    for (auto& raw : log) {
+        report_keyboard_t report;
+        memcpy(report.raw, raw.data(), sizeof(report.raw));
+        if (report.keys[0] && (result.empty() || result.back() != report.keys[0])) {
+            result.push_back(report.keys[0]);
+        }
+    }
+    return result;
+}
+
+const char test_string[] = "Hello, World!" SS_TAP(X_ENTER) SS_DOWN(X_LCTRL) "a" SS_UP(X_LCTRL) SS_DELAY(5) "~_ok";
+}  // namespace
+
+class SendStringAsync : public TestFixture {};
+
+TEST_F(SendStringAsync, ReportsMatchBlockingSendString) {
+    TestDriver   driver;
+    report_log_t blocking;
+    report_log_t async;
+
+    record_reports(driver, blocking);
+    send_string(test_string);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    record_reports(driver, async);
+    EXPECT_NE(send_string_async(test_string), SEND_STRING_ASYNC_NONE);
+    EXPECT_TRUE(async.empty());
+    while (send_string_async_is_busy()) {
+        run_one_scan_loop();
+    }
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_FALSE(blocking.empty());
+    EXPECT_EQ(blocking, async);
+}
+
+TEST_F(SendStringAsync, OneReportPerStep) {
+    TestDriver   driver;
+    report_log_t log;
+    record_reports(driver, log);
+
+    send_string_async_P(PSTR("aB"));
+    run_one_scan_loop();
+    EXPECT_EQ(log.size(), 1);
+    run_one_scan_loop();
+    EXPECT_EQ(log.size(), 2);
+    idle_for(10);
+    // a down, a up, shift down, b down, b up, shift up
+    EXPECT_EQ(log.size(), 6);
+    EXPECT_FALSE(send_string_async_is_busy());
+}
+
+TEST_F(SendStringAsync, MatrixIsScannedWhileTyping) {
+    TestDriver   driver;
+    report_log_t log;
+    record_reports(driver, log);
+
+    send_string_async("aaaaaaaaaaaaaaaaaaaa");
+    idle_for(4);
+    press_key(1, 0);
+    run_one_scan_loop();
+    release_key(1, 0);
+    run_one_scan_loop();
+
+    EXPECT_TRUE(send_string_async_is_busy());
+    bool seen_b = false;
+    for (auto& raw : log) {
+        report_keyboard_t report;
+        memcpy(report.raw, raw.data(), sizeof(report.raw));
+        seen_b |= is_key_pressed(&report, KC_B);
+    }
+    EXPECT_TRUE(seen_b);
+    send_string_async_cancel_all();
+}
+
+TEST_F(SendStringAsync, CancelReleasesHeldKeys) {
+    TestDriver   driver;
+    report_log_t log;
+    record_reports(driver, log);
+
+    uint8_t handle = send_string_async_P(PSTR("HELLO"));
+    run_one_scan_loop();
+    run_one_scan_loop();
+    EXPECT_TRUE(send_string_async_cancel(handle));
+    EXPECT_FALSE(send_string_async_is_busy());
+    EXPECT_FALSE(send_string_async_cancel(handle));
+
+    report_keyboard_t empty = {};
+    EXPECT_EQ(log.back(), std::vector<uint8_t>(empty.raw, empty.raw + sizeof(empty.raw)));
+    idle_for(10);
+    EXPECT_EQ(log.size(), 4);
+}
+
+TEST_F(SendStringAsync, PriorityStringsGoAheadOfWaitingOnes) {
+    TestDriver   driver;
+    report_log_t log;
+    record_reports(driver, log);
+
+    send_string_async_P(PSTR("ab"));
+    send_string_async_P(PSTR("c"));
+    uint8_t cancelled = send_string_async_P(PSTR("x"));
+    send_string_async_with_delay(PSTR("d"), 0, SS_ASYNC_PROGMEM | SS_ASYNC_PRIORITY);
+    send_string_async_with_delay(PSTR("e"), 0, SS_ASYNC_PROGMEM | SS_ASYNC_PRIORITY);
+    EXPECT_EQ(send_string_async_P(PSTR("f")), SEND_STRING_ASYNC_NONE);
+    EXPECT_TRUE(send_string_async_cancel(cancelled));
+    while (send_string_async_is_busy()) {
+        run_one_scan_loop();
+    }
+
+    EXPECT_EQ(pressed_keys(log), std::vector<uint8_t>({KC_A, KC_B, KC_D, KC_E, KC_C}));
+}
@@ -0,0 +1,117 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <utility>
+
+using testing::_;
+using testing::ElementsAre;
+using testing::Invoke;
+
+namespace {
+typedef std::vector<report_keyboard_t>           report_log_t;
+typedef std::vector<std::pair<uint8_t, uint8_t>> typed_t;
+
+void record_reports(TestDriver& driver, report_log_t& log) {
+    EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke([&log](report_keyboard_t& report) { log.push_back(report); }));
+}
+
+// What the host types: every newly pressed key together with the modifiers held at that moment
+typed_t typed(const report_log_t& log) {
+    typed_t           result;
+    report_keyboard_t previous = {};
+    for (auto report : log) {
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+            if (report.keys[i] && !is_key_pressed(&previous, report.keys[i])) {
+                result.emplace_back(report.keys[i], report.mods);
+            }
+        }
+        previous = report;
+    }
+    return result;
+}
+
+std::vector<uint8_t> compile(const char* str) {
+    std::vector<uint8_t> bytecode(256);
+    bytecode.resize(send_string_compile(str, bytecode.data(), bytecode.size()));
+    return bytecode;
+}
+}  // namespace
+
+class SendStringBytecode : public TestFixture {};
+
+TEST_F(SendStringBytecode, ShiftIsHoistedAcrossUppercaseRuns) {
+    EXPECT_THAT(compile("HELLO"), ElementsAre(SS_BC_MODS, MOD_BIT(KC_LSFT), KC_H, KC_E, KC_L, KC_L, KC_O, SS_BC_MODS, 0, SS_BC_END));
+}
+
+TEST_F(SendStringBytecode, RepeatedTapsAreRunLengthEncoded) {
+    EXPECT_THAT(compile("a----b"), ElementsAre(KC_A, SS_BC_REPEAT, 4, KC_MINS, KC_B, SS_BC_END));
+}
+
+TEST_F(SendStringBytecode, RawCodesAreTypedWithoutHoistedModifiers) {
+    EXPECT_THAT(compile("A" SS_TAP(X_ENTER) SS_DELAY(300) SS_DOWN(X_LCTRL) "c" SS_UP(X_LCTRL)),
+                ElementsAre(SS_BC_MODS, MOD_BIT(KC_LSFT), KC_A, SS_BC_MODS, 0, KC_ENTER, SS_BC_DELAY, 300 & 0xFF, 300 >> 8, SS_BC_DOWN, KC_LCTRL, KC_C, SS_BC_UP, KC_LCTRL, SS_BC_END));
+}
+
+TEST_F(SendStringBytecode, CompileFailsWhenBufferIsTooSmall) {
+    uint8_t bytecode[4];
+    EXPECT_EQ(send_string_compile("HELLO", bytecode, sizeof(bytecode)), 0);
+    EXPECT_EQ(send_string_compile("ab", bytecode, sizeof(bytecode)), 3);
+}
+
+TEST_F(SendStringBytecode, TypesTheSameTextWithFewerReports) {
+    const char* text = "Hello, World! THIS IS QMK... Typing ~~~ Fast" SS_TAP(X_ENTER) SS_LCTL("a") "Done";
+
+    TestDriver   driver;
+    report_log_t plain;
+    report_log_t fast;
+
+    record_reports(driver, plain);
+    send_string(text);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    std::vector<uint8_t> bytecode = compile(text);
+    ASSERT_FALSE(bytecode.empty());
+    record_reports(driver, fast);
+    send_bytecode(bytecode.data());
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EQ(typed(plain), typed(fast));
+    EXPECT_EQ(fast.back().mods, 0);
+    EXPECT_EQ(typed(fast).size(), 50);
+    EXPECT_EQ(plain.size(), 138);
+    EXPECT_EQ(fast.size(), 122);
+    EXPECT_EQ(bytecode.size(), 95);
+}
+
+TEST_F(SendStringBytecode, UppercaseWordNeedsTwelveReports) {
+    TestDriver   driver;
+    report_log_t plain;
+    report_log_t fast;
+
+    record_reports(driver, plain);
+    send_string("HELLO");
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    static const uint8_t hello[] PROGMEM = {SS_BC_MODS, MOD_BIT(KC_LSFT), KC_H, KC_E, KC_L, KC_L, KC_O, SS_BC_MODS, 0, SS_BC_END};
+    record_reports(driver, fast);
+    send_bytecode_P(hello);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EQ(plain.size(), 20);
+    EXPECT_EQ(fast.size(), 12);
+    EXPECT_EQ(typed(plain), typed(fast));
+}
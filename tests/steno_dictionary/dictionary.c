@@ -0,0 +1,22 @@
+// Generated by `qmk steno2c` from dictionary.json, 17 entries in 254 bytes
+
+#include "steno_dictionary.h"
+
+const uint8_t steno_dictionary[] PROGMEM = {
+    0x53, 0x54, 0x4E, 0x01, 0x03, 0x7D, 0x00, 0x00, 0x00, 0x04, 0x68, 0x65, 0x6C, 0x6C, 0x00, 0x05,
+    0x68, 0x65, 0x6C, 0x6C, 0x6F, 0x00, 0x05, 0x77, 0x6F, 0x72, 0x6C, 0x64, 0x00, 0x03, 0x64, 0x6F,
+    0x67, 0x00, 0x03, 0x63, 0x61, 0x74, 0x00, 0x03, 0x70, 0x72, 0x6F, 0x00, 0x07, 0x70, 0x72, 0x6F,
+    0x64, 0x75, 0x63, 0x65, 0x00, 0x08, 0x70, 0x72, 0x6F, 0x64, 0x75, 0x63, 0x65, 0x72, 0x01, 0x01,
+    0x73, 0x01, 0x03, 0x69, 0x6E, 0x67, 0x05, 0x01, 0x2E, 0x01, 0x01, 0x2C, 0x04, 0x00, 0x07, 0x01,
+    0x0A, 0x08, 0x01, 0x61, 0x08, 0x01, 0x62, 0x10, 0x00, 0x01, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00,
+    0x00, 0x00, 0x34, 0x00, 0x00, 0x01, 0x00, 0x00, 0x0C, 0x10, 0x10, 0x59, 0x00, 0x00, 0x2B, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0xC0, 0x02, 0x00, 0x00, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x0E, 0x00, 0x00,
+    0x18, 0x01, 0x00, 0x00, 0x00, 0x00, 0x4C, 0x00, 0x00, 0x90, 0x02, 0x00, 0x65, 0x00, 0x00, 0x26,
+    0x00, 0x00, 0x30, 0x04, 0x00, 0x00, 0x00, 0x00, 0x54, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
+    0x00, 0x51, 0x00, 0x00, 0x80, 0x40, 0x00, 0x00, 0x00, 0x00, 0x4E, 0x00, 0x00, 0x40, 0x08, 0x02,
+    0x71, 0x00, 0x00, 0x08, 0x00, 0x00, 0x14, 0x80, 0x02, 0x00, 0x00, 0x00, 0x46, 0x00, 0x00, 0x00,
+    0x00, 0x04, 0x00, 0x00, 0x00, 0x41, 0x00, 0x00, 0x0C, 0x02, 0x04, 0x00, 0x00, 0x00, 0x1C, 0x00,
+    0x00, 0x28, 0x00, 0x05, 0x00, 0x00, 0x00, 0x49, 0x00, 0x00, 0x08, 0x01, 0x08, 0x00, 0x00, 0x00,
+    0x21, 0x00, 0x00, 0x54, 0x16, 0x08, 0x00, 0x00, 0x00, 0x57, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00,
+    0x00, 0x00, 0x3E, 0x00, 0x00, 0x20, 0x42, 0x22, 0x00, 0x00, 0x00, 0x15, 0x00, 0x00,
+};
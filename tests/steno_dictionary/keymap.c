@@ -0,0 +1,29 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+#include "keymap_steno.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] =
+        {
+            // 0    1       2       3       4       5       6       7       8      9
+            {STN_N1, STN_S1, STN_TL, STN_KL, STN_PL, STN_WL, STN_HL, STN_RL, STN_A, STN_O},
+            {STN_ST1, STN_E, STN_U, STN_FR, STN_RR, STN_PR, STN_BR, STN_LR, STN_GR, STN_TR},
+            {STN_SR, STN_DR, STN_ZR, STN_FN, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+            {QK_STENO_DICT, QK_STENO_GEMINI, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        },
+};
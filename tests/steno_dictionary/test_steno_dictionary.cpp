@@ -0,0 +1,256 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using testing::_;
+using testing::Invoke;
+
+namespace {
+// Entries of dictionary.json that made it into dictionary.c
+const unsigned DICTIONARY_ENTRIES = 17;
+
+const char STENO_ORDER[] = "#STKPWHRAO*EUFRPBLGTSDZ";
+
+// Parses a stroke like Plover writes it, see parse_stroke() in lib/python/qmk/steno.py
+uint32_t parse_stroke(const std::string& text) {
+    uint32_t bits     = 0;
+    unsigned position = 1;
+    for (char c : text) {
+        if (c == '-') {
+            position = std::max(position, 11u);
+            continue;
+        }
+        if (c == '#') {
+            bits |= STENO_KEY_NUMBER;
+            continue;
+        }
+        while (position < STENO_KEYS && STENO_ORDER[position] != c) {
+            position++;
+        }
+        EXPECT_LT(position, STENO_KEYS) << "invalid stroke " << text;
+        bits |= 1UL << position++;
+    }
+    return bits;
+}
+
+void write(const std::string& outline) {
+    size_t start = 0;
+    while (start <= outline.size()) {
+        size_t end = outline.find(' ', start);
+        if (end == std::string::npos) {
+            end = outline.size();
+        }
+        steno_translate(parse_stroke(outline.substr(start, end - start)));
+        start = end + 1;
+    }
+}
+
+// The text on the host after it received every report, with backspaces applied
+class TypedText {
+   public:
+    explicit TypedText(TestDriver& driver) {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke([this](report_keyboard_t& report) { receive(report); }));
+    }
+
+    const std::string& str() const { return text; }
+
+   private:
+    void receive(const report_keyboard_t& report) {
+        uint8_t key = report.keys[0];
+        if (key && key != last_key) {
+            if (key == KC_BSPC) {
+                if (!text.empty()) {
+                    text.pop_back();
+                }
+            } else {
+                text += character(key, report.mods & (MOD_BIT(KC_LSFT) | MOD_BIT(KC_RSFT)));
+            }
+        }
+        last_key = key;
+    }
+
+    static char character(uint8_t key, bool shifted) {
+        for (int c = 0; c < 128; c++) {
+            if (pgm_read_byte(&ascii_to_keycode_lut[c]) == key && (bool)PGM_LOADBIT(ascii_to_shift_lut, c) == shifted) {
+                return c;
+            }
+        }
+        ADD_FAILURE() << "no character for key " << (int)key;
+        return '?';
+    }
+
+    std::string text;
+    uint8_t     last_key = 0;
+};
+}  // namespace
+
+class StenoDictionary : public TestFixture {
+   protected:
+    StenoDictionary() { steno_set_mode(STENO_MODE_DICTIONARY); }
+};
+
+TEST_F(StenoDictionary, TranslatesStrokes) {
+    TestDriver driver;
+    TypedText  typed(driver);
+    write("HEL WORLD TKOG");
+    EXPECT_EQ(typed.str(), "hell world dog");
+}
+
+TEST_F(StenoDictionary, LongestOutlineReplacesEarlierTranslations) {
+    TestDriver driver;
+    TypedText  typed(driver);
+    write("HEL");
+    EXPECT_EQ(typed.str(), "hell");
+    write("HRO");
+    EXPECT_EQ(typed.str(), "hello");
+    write("PRO TKUS -R KAT PRO TKUS");
+    EXPECT_EQ(typed.str(), "hello producer cat produce");
+}
+
+TEST_F(StenoDictionary, AttachesAndCapitalizes) {
+    TestDriver driver;
+    TypedText  typed(driver);
+    write("KAT -S TP-PL TKOG -G KW-BG KPA KAT R-R HEL");
+    EXPECT_EQ(typed.str(), "cats. Doging, Cat\nHell");
+}
+
+TEST_F(StenoDictionary, GluesFingerspelling) {
+    TestDriver driver;
+    TypedText  typed(driver);
+    write("KAT A* PW* A* KAT");
+    EXPECT_EQ(typed.str(), "cat aba cat");
+}
+
+TEST_F(StenoDictionary, TypesUntranslatedStrokesAsSteno) {
+    TestDriver driver;
+    TypedText  typed(driver);
+    write("KAT STKPW -PB A*EU");
+    EXPECT_EQ(typed.str(), "cat STKPW -PB A*EU");
+}
+
+TEST_F(StenoDictionary, UndoTakesBackTranslations) {
+    TestDriver driver;
+    TypedText  typed(driver);
+    write("KAT TKOG *");
+    EXPECT_EQ(typed.str(), "cat");
+    write("TPHO*UT *");
+    EXPECT_EQ(typed.str(), "");
+    write("*");
+    EXPECT_EQ(typed.str(), "");
+}
+
+TEST_F(StenoDictionary, UndoTranslatesTheOtherStrokesAgain) {
+    TestDriver driver;
+    TypedText  typed(driver);
+    write("KAT HEL HRO *");
+    EXPECT_EQ(typed.str(), "cat hell");
+    write("HRO PRO TKUS -R *");
+    EXPECT_EQ(typed.str(), "cat hello produce");
+    write("* *");
+    EXPECT_EQ(typed.str(), "cat hello");
+}
+
+TEST_F(StenoDictionary, UndoRestoresTheOutputState) {
+    TestDriver driver;
+    TypedText  typed(driver);
+    write("KAT TP-PL TKOG * TKOG");
+    EXPECT_EQ(typed.str(), "cat. Dog");
+    write("-S * * KAT");
+    EXPECT_EQ(typed.str(), "cat. Cat");
+}
+
+TEST_F(StenoDictionary, UndoGoesBackAsFarAsTheHistory) {
+    TestDriver driver;
+    TypedText  typed(driver);
+    write("KAT TKOG KAT TKOG KAT TKOG");
+    write("* * * * * *");
+    EXPECT_EQ(typed.str(), "cat dog");
+    // Outlines also can not reach behind the history
+    write("PRO TKUS -R HEL HRO HEL HRO");
+    EXPECT_EQ(typed.str(), "cat dog producer hello hello");
+}
+
+TEST_F(StenoDictionary, ChordsFromTheMatrix) {
+    TestDriver driver;
+    TypedText  typed(driver);
+    steno_set_mode(STENO_MODE_GEMINI);
+
+    press_key(0, 3);  // QK_STENO_DICT
+    idle_for(10);
+    release_key(0, 3);
+    idle_for(10);
+
+    // H- -E -L, released one by one
+    press_key(6, 0);
+    press_key(1, 1);
+    idle_for(10);
+    press_key(7, 1);
+    idle_for(10);
+    release_key(6, 0);
+    idle_for(10);
+    EXPECT_EQ(typed.str(), "");
+    release_key(1, 1);
+    release_key(7, 1);
+    idle_for(10);
+    EXPECT_EQ(typed.str(), "hell");
+
+    // FN has no steno key, so a chord of it alone does nothing
+    press_key(3, 2);
+    idle_for(10);
+    release_key(3, 2);
+    idle_for(10);
+    EXPECT_EQ(typed.str(), "hell");
+
+    // Back to sending chords to the host
+    press_key(1, 3);  // QK_STENO_GEMINI
+    idle_for(10);
+    release_key(1, 3);
+    idle_for(10);
+    press_key(6, 0);
+    idle_for(10);
+    release_key(6, 0);
+    idle_for(10);
+    EXPECT_EQ(typed.str(), "hell");
+}
+
+TEST_F(StenoDictionary, LookupSpeed) {
+    const std::vector<std::vector<uint32_t>> outlines = {
+        {parse_stroke("HEL")}, {parse_stroke("HEL"), parse_stroke("HRO")}, {parse_stroke("PRO"), parse_stroke("TKUS"), parse_stroke("-R")}, {parse_stroke("STKPW")}, {parse_stroke("KAT"), parse_stroke("TKOG")},
+    };
+    EXPECT_NE(steno_dictionary_lookup(outlines[0].data(), 1), 0);
+    EXPECT_NE(steno_dictionary_lookup(outlines[2].data(), 3), 0);
+    EXPECT_EQ(steno_dictionary_lookup(outlines[3].data(), 1), 0);
+    EXPECT_EQ(steno_dictionary_lookup(outlines[4].data(), 2), 0);
+
+    const unsigned rounds  = 200000;
+    uint32_t       found   = 0;
+    auto           start   = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < rounds; i++) {
+        auto& outline = outlines[i % outlines.size()];
+        found += steno_dictionary_lookup(outline.data(), outline.size()) != 0;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(found, rounds / outlines.size() * 3);
+
+    // The root node is written last, so it ends the dictionary
+    uint32_t root = steno_dictionary[5] | steno_dictionary[6] << 8 | steno_dictionary[7] << 16;
+    uint32_t size = root + 3 + (steno_dictionary[root] | steno_dictionary[root + 1] << 8 | steno_dictionary[root + 2] << 16) * 9;
+    std::cout << rounds / elapsed.count() << " lookups per second, " << (double)size / DICTIONARY_ENTRIES << " bytes per entry" << std::endl;
+}
@@ -0,0 +1,48 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] =
+        {
+            // 0      1       2       3       4       5       6       7       8       9
+            {KC_X, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+            {TD(0), TD(1), TD(2), TD(3), TD(4), TD(5), TD(6), TD(7), TD(8), TD(9)},
+            {TD(54), TD(55), TD(56), TD(57), TD(58), TD(59), TD(60), TD(61), TD(62), TD(63)},
+            {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        },
+};
+
+// A single tap types a letter picked by the dance's index, more taps type 1
+static uint8_t dance_keycode(qk_tap_dance_state_t *state) { return state->count == 1 ? KC_A + (state->keycode - QK_TAP_DANCE) % 26 : KC_1; }
+
+static void dance_finished(qk_tap_dance_state_t *state, void *user_data) { register_code(dance_keycode(state)); }
+
+static void dance_reset(qk_tap_dance_state_t *state, void *user_data) { unregister_code(dance_keycode(state)); }
+
+#define DANCE ACTION_TAP_DANCE_FN_ADVANCED(NULL, dance_finished, dance_reset)
+
+qk_tap_dance_action_t tap_dance_actions[64] = {
+    DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE,
+    DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE,
+    DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE,
+    DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE,
+    DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE,
+    DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE,
+    DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE,
+    DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE, DANCE,
+};
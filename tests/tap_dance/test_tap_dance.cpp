@@ -0,0 +1,147 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include <chrono>
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+class TapDance : public TestFixture {
+   protected:
+    void tap_key(uint8_t col, uint8_t row) {
+        press_key(col, row);
+        keyboard_task();
+        release_key(col, row);
+        keyboard_task();
+    }
+};
+
+TEST_F(TapDance, SingleTapFinishesAfterTheTappingTerm) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    tap_key(0, 1);
+    idle_for(TAPPING_TERM + 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // the dance applies the modifiers it saved before finishing
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(TapDance, DoubleTapTypesTheSecondKey) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    tap_key(1, 1);
+    idle_for(TAPPING_TERM / 2);
+    tap_key(1, 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // the dance applies the modifiers it saved before finishing
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_1)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(TAPPING_TERM + 2);
+}
+
+TEST_F(TapDance, OtherKeyInterruptsTheDance) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    tap_key(2, 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    press_key(0, 0);
+    // the dance applies the modifiers it saved before finishing
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_X)));
+    keyboard_task();
+
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+    idle_for(TAPPING_TERM + 2);
+}
+
+TEST_F(TapDance, LastOfSixtyFourDancesTimesOut) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    tap_key(9, 2);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // the dance applies the modifiers it saved before finishing
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A + 63 % 26)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(TAPPING_TERM + 2);
+}
+
+TEST_F(TapDance, MoreDancesHeldThanTheActiveSetKeeps) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        press_key(col, 1);
+        keyboard_task();
+    }
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        release_key(col, 1);
+        keyboard_task();
+    }
+    idle_for(TAPPING_TERM + 2);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    for (uint8_t i = 0; i < 64; i++) {
+        EXPECT_EQ(tap_dance_actions[i].state.count, 0) << "dance " << (int)i;
+    }
+
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    tap_key(5, 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_F)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(TAPPING_TERM + 2);
+}
+
+TEST_F(TapDance, IdleScanBenchmark) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    tap_key(9, 2);
+    idle_for(TAPPING_TERM + 2);
+
+    const int scans = 1000000;
+    auto      start = std::chrono::steady_clock::now();
+    for (int i = 0; i < scans; i++) {
+        matrix_scan_tap_dance();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Idle tap dance scan with 64 dances: " << elapsed.count() / scans << " ns" << std::endl;
+}
@@ -0,0 +1,158 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "trace_replay.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include "test_matrix.h"
+
+extern "C" {
+#include "quantum.h"
+#include "action_tapping.h"
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::Invoke;
+
+namespace {
+std::string format_report(uint32_t time, const report_keyboard_t& report) {
+    char line[32];
+    snprintf(line, sizeof(line), "%u: %02X [", time, report.mods);
+    std::string result = line;
+    bool        first  = true;
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (report.keys[i]) {
+            snprintf(line, sizeof(line), first ? "%02X" : " %02X", report.keys[i]);
+            result += line;
+            first = false;
+        }
+    }
+    return result + "]";
+}
+
+bool is_empty(const report_keyboard_t& report) { return !report.mods && !has_anykey(const_cast<report_keyboard_t*>(&report)); }
+
+void scan(ReplayResult& result) {
+    keyboard_task();
+    advance_time(1);
+    result.scans++;
+}
+}  // namespace
+
+bool parse_trace(std::istream& in, std::vector<TraceEvent>& events, std::string& error) {
+    std::string line;
+    uint32_t    number = 0;
+    while (std::getline(in, line)) {
+        number++;
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        uint32_t           time;
+        std::string        edge;
+        unsigned           row, col;
+        if (!(fields >> time)) {
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+        } else if (fields >> edge >> row >> col && (edge == "d" || edge == "u") && row < MATRIX_ROWS && col < MATRIX_COLS && (events.empty() || time >= events.back().time)) {
+            events.push_back({time, (uint8_t)row, (uint8_t)col, edge == "d"});
+            continue;
+        }
+        error = "line " + std::to_string(number) + ": " + line;
+        return false;
+    }
+    return true;
+}
+
+bool load_trace(const std::string& path, std::vector<TraceEvent>& events, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    return parse_trace(in, events, error);
+}
+
+ReplayResult replay_trace(TestDriver& driver, const std::vector<TraceEvent>& events, uint32_t settle_ms) {
+    ReplayResult                           result   = {};
+    uint32_t                               start    = timer_read32();
+    uint8_t                                overflow = waiting_buffer_overflows();
+    report_keyboard_t                      last     = {};
+    std::set<std::pair<uint8_t, uint8_t>> held;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke([&](report_keyboard_t& report) {
+        result.reports.push_back(format_report(timer_read32() - start, report));
+        last = report;
+    }));
+
+    auto begin = std::chrono::steady_clock::now();
+    for (auto& event : events) {
+        while (timer_read32() - start < event.time) {
+            scan(result);
+        }
+        if (event.pressed) {
+            press_key(event.col, event.row);
+            held.insert({event.row, event.col});
+        } else {
+            release_key(event.col, event.row);
+            held.erase({event.row, event.col});
+        }
+        result.events++;
+    }
+    for (uint32_t i = 0; i < settle_ms; i++) {
+        scan(result);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    result.seconds                  = elapsed.count();
+    result.waiting_buffer_overflows = (uint8_t)(waiting_buffer_overflows() - overflow);
+    result.stuck_keys               = held.empty() && !is_empty(last);
+    return result;
+}
+
+testing::AssertionResult matches_golden(const ReplayResult& result, const std::string& path) {
+    if (getenv("UPDATE_GOLDEN")) {
+        std::ofstream out(path);
+        for (auto& line : result.reports) {
+            out << line << "\n";
+        }
+        return testing::AssertionSuccess() << "wrote " << path;
+    }
+
+    std::ifstream            in(path);
+    std::vector<std::string> golden;
+    std::string              line;
+    if (!in) {
+        return testing::AssertionFailure() << "cannot open " << path << ", run with UPDATE_GOLDEN=1 to create it";
+    }
+    while (std::getline(in, line)) {
+        golden.push_back(line);
+    }
+
+    for (size_t i = 0; i < std::max(golden.size(), result.reports.size()); i++) {
+        std::string expected = i < golden.size() ? golden[i] : "(none)";
+        std::string actual   = i < result.reports.size() ? result.reports[i] : "(none)";
+        if (expected != actual) {
+            return testing::AssertionFailure() << path << " report " << i + 1 << ": expected " << expected << ", got " << actual;
+        }
+    }
+    return testing::AssertionSuccess();
+}
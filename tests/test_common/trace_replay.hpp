@@ -0,0 +1,58 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+#include "test_driver.hpp"
+
+// A matrix edge at a time in ms from the start of the trace
+struct TraceEvent {
+    uint32_t time;
+    uint8_t  row;
+    uint8_t  col;
+    bool     pressed;
+};
+
+struct ReplayResult {
+    // One line per keyboard report: "<ms>: <mods> [<keys>]" in hex
+    std::vector<std::string> reports;
+    uint32_t                 events;
+    uint32_t                 scans;
+    uint32_t                 waiting_buffer_overflows;
+    // Keys or modifiers still reported once every key was released and the keyboard settled
+    bool   stuck_keys;
+    double seconds;
+};
+
+/* Trace text format, one event per line, '#' starts a comment:
+ *
+ *   <ms> d <row> <col>    key pressed
+ *   <ms> u <row> <col>    key released
+ *
+ * Times are from the start of the trace and never go backwards.
+ */
+bool parse_trace(std::istream& in, std::vector<TraceEvent>& events, std::string& error);
+bool load_trace(const std::string& path, std::vector<TraceEvent>& events, std::string& error);
+
+// Plays the events through keyboard_task(), one scan per ms, then idles for settle_ms
+ReplayResult replay_trace(TestDriver& driver, const std::vector<TraceEvent>& events, uint32_t settle_ms);
+
+// Compares the reports with a golden file, writing it instead when UPDATE_GOLDEN is set in the environment
+testing::AssertionResult matches_golden(const ReplayResult& result, const std::string& path);
@@ -0,0 +1,314 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <utility>
+
+using testing::_;
+using testing::ElementsAre;
+using testing::Invoke;
+using testing::Pair;
+
+namespace {
+typedef std::vector<report_keyboard_t>           report_log_t;
+typedef std::vector<std::pair<uint8_t, uint8_t>> typed_t;
+
+void record_reports(TestDriver& driver, report_log_t& log) {
+    EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke([&log](report_keyboard_t& report) { log.push_back(report); }));
+}
+
+// Every key and modifier the host sees pressed, with the modifiers held at that moment
+typed_t typed(const report_log_t& log, bool with_mods = true) {
+    typed_t           result;
+    report_keyboard_t previous = {};
+    for (auto report : log) {
+        for (uint8_t bit = 0; bit < 8 && with_mods; bit++) {
+            if ((report.mods & ~previous.mods) & (1 << bit)) {
+                result.emplace_back(KC_LCTRL + bit, report.mods);
+            }
+        }
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+            if (report.keys[i] && !is_key_pressed(&previous, report.keys[i])) {
+                result.emplace_back(report.keys[i], report.mods);
+            }
+        }
+        previous = report;
+    }
+    return result;
+}
+
+// Only the key presses, for comparing streams whose modifier edges differ
+typed_t typed_keys(const report_log_t& log) { return typed(log, false); }
+}  // namespace
+
+class UnicodeAsync : public TestFixture {
+   protected:
+    uint16_t run_until_idle(void) {
+        uint16_t start = timer_read();
+        while (unicode_async_is_busy()) {
+            run_one_scan_loop();
+        }
+        return timer_elapsed(start);
+    }
+};
+
+TEST_F(UnicodeAsync, TypesTheSameKeysAsBlockingInput) {
+    TestDriver driver;
+
+    const std::pair<uint8_t, const char*> cases[] = {{UC_LNX, "é→😀"}, {UC_WINC, "é→😀"}, {UC_WIN, "é→"}};
+    for (auto c : cases) {
+        set_unicode_input_mode(c.first);
+        report_log_t blocking;
+        report_log_t async;
+
+        record_reports(driver, blocking);
+        uint16_t blocking_start = timer_read();
+        send_unicode_string(c.second);
+        uint16_t blocking_time = timer_elapsed(blocking_start);
+        testing::Mock::VerifyAndClearExpectations(&driver);
+
+        record_reports(driver, async);
+        EXPECT_TRUE(send_unicode_string_async(c.second));
+        EXPECT_TRUE(async.empty());
+        uint16_t async_time = run_until_idle();
+        testing::Mock::VerifyAndClearExpectations(&driver);
+
+        EXPECT_EQ(typed(blocking), typed(async)) << "input mode " << (int)c.first;
+        EXPECT_LT(async.size(), blocking.size()) << "input mode " << (int)c.first;
+        std::cout << "mode " << (int)c.first << ": blocking " << blocking.size() << " reports, scanning stalled for " << blocking_time << "ms; async " << async.size() << " reports over " << async_time << "ms" << std::endl;
+    }
+}
+
+TEST_F(UnicodeAsync, MacKeepsOptionHeldAcrossTheBatch) {
+    TestDriver   driver;
+    report_log_t blocking;
+    report_log_t async;
+    set_unicode_input_mode(UC_MAC);
+
+    record_reports(driver, blocking);
+    send_unicode_string("éé→");
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    record_reports(driver, async);
+    send_unicode_string_async("éé→");
+    run_until_idle();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EQ(typed_keys(blocking), typed_keys(async));
+    typed_t option_presses;
+    for (auto press : typed(async)) {
+        if (press.first == KC_LALT) {
+            option_presses.push_back(press);
+        }
+    }
+    EXPECT_EQ(option_presses.size(), 1);
+    EXPECT_EQ(async.back().mods, 0);
+}
+
+TEST_F(UnicodeAsync, MacTypesSurrogatePairs) {
+    TestDriver   driver;
+    report_log_t async;
+    set_unicode_input_mode(UC_MAC);
+
+    record_reports(driver, async);
+    register_unicode_async(0x1F600);
+    run_until_idle();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    const uint8_t alt = MOD_BIT(KC_LALT);
+    EXPECT_THAT(typed(async), ElementsAre(Pair(KC_LALT, alt), Pair(KC_D, alt), Pair(KC_8, alt), Pair(KC_3, alt), Pair(KC_D, alt), Pair(KC_D, alt), Pair(KC_E, alt), Pair(KC_0, alt), Pair(KC_0, alt)));
+}
+
+TEST_F(UnicodeAsync, LinuxSequenceIsPrecomputedPerCodePoint) {
+    TestDriver   driver;
+    report_log_t async;
+    set_unicode_input_mode(UC_LNX);
+
+    record_reports(driver, async);
+    register_unicode_async(0x2192);
+    run_until_idle();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    const uint8_t cs = MOD_BIT(KC_LCTRL) | MOD_BIT(KC_LSFT);
+    EXPECT_THAT(typed(async), ElementsAre(Pair(KC_LCTRL, cs), Pair(KC_LSFT, cs), Pair(KC_U, cs), Pair(KC_2, 0), Pair(KC_1, 0), Pair(KC_9, 0), Pair(KC_2, 0), Pair(KC_SPC, 0)));
+    // Modifiers, start, release, four rolled digits, space and the final release
+    EXPECT_EQ(async.size(), 9);
+}
+
+TEST_F(UnicodeAsync, RestoresModifiersAfterTheBatch) {
+    TestDriver   driver;
+    report_log_t async;
+    set_unicode_input_mode(UC_WINC);
+    add_mods(MOD_BIT(KC_LSFT));
+
+    record_reports(driver, async);
+    send_unicode_string_async("ab");
+    run_until_idle();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // Shift is left out while typing, and sent again at the end
+    for (size_t i = 0; i + 1 < async.size(); i++) {
+        EXPECT_FALSE(async[i].mods & MOD_BIT(KC_LSFT));
+    }
+    EXPECT_EQ(async.back().mods, MOD_BIT(KC_LSFT));
+    EXPECT_EQ(get_mods(), MOD_BIT(KC_LSFT));
+    clear_mods();
+}
+
+TEST_F(UnicodeAsync, ShiftPressedDuringTheBatchIsKept) {
+    TestDriver   driver;
+    report_log_t untouched;
+    report_log_t async;
+    set_unicode_input_mode(UC_LNX);
+
+    record_reports(driver, untouched);
+    send_unicode_string_async("ab");
+    run_until_idle();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    record_reports(driver, async);
+    send_unicode_string_async("ab");
+    for (int i = 0; i < 5; i++) {
+        run_one_scan_loop();
+    }
+    press_key(1, 0);
+    run_until_idle();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // The batch types as if Shift was not there, and Shift is sent once it is done
+    EXPECT_EQ(typed_keys(untouched), typed_keys(async));
+    EXPECT_EQ(get_mods(), MOD_BIT(KC_LSFT));
+    EXPECT_EQ(async.back().mods, MOD_BIT(KC_LSFT));
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+    release_key(1, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(get_mods(), 0);
+}
+
+TEST_F(UnicodeAsync, ShiftReleasedDuringTheBatchIsNotStuck) {
+    TestDriver   driver;
+    report_log_t untouched;
+    report_log_t async;
+    set_unicode_input_mode(UC_LNX);
+
+    record_reports(driver, untouched);
+    send_unicode_string_async("ab");
+    run_until_idle();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+    press_key(1, 0);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    record_reports(driver, async);
+    send_unicode_string_async("ab");
+    for (int i = 0; i < 5; i++) {
+        run_one_scan_loop();
+    }
+    release_key(1, 0);
+    run_until_idle();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // The batch types the same, and the host ends up with Shift released
+    EXPECT_EQ(typed_keys(untouched), typed_keys(async));
+    EXPECT_EQ(async.back().mods, 0);
+    EXPECT_EQ(get_mods(), 0);
+}
+
+TEST_F(UnicodeAsync, KeyTappedDuringTheBatchIsTypedAfterIt) {
+    TestDriver   driver;
+    report_log_t async;
+    set_unicode_input_mode(UC_WIN);
+
+    record_reports(driver, async);
+    send_unicode_string_async("b");
+    for (int i = 0; i < 3; i++) {
+        run_one_scan_loop();
+    }
+    press_key(2, 0);
+    run_one_scan_loop();
+    release_key(2, 0);
+    run_until_idle();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // Not with the Alt of the input sequence, but on its own once the sequence is done
+    EXPECT_THAT(typed(async), ElementsAre(Pair(KC_LALT, MOD_BIT(KC_LALT)), Pair(KC_KP_PLUS, MOD_BIT(KC_LALT)), Pair(KC_0, MOD_BIT(KC_LALT)), Pair(KC_0, MOD_BIT(KC_LALT)), Pair(KC_6, MOD_BIT(KC_LALT)), Pair(KC_2, MOD_BIT(KC_LALT)), Pair(KC_A, 0)));
+    EXPECT_EQ(async.back(), report_keyboard_t{});
+}
+
+TEST_F(UnicodeAsync, KeyHeldByTheUserIsNotReleased) {
+    TestDriver   driver;
+    report_log_t async;
+    set_unicode_input_mode(UC_LNX);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+    press_key(3, 0);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // The sequence for U+00E9 types an E of its own
+    record_reports(driver, async);
+    send_unicode_string_async("é");
+    run_until_idle();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    for (auto report : async) {
+        EXPECT_TRUE(is_key_pressed(&report, KC_E));
+    }
+    EXPECT_TRUE(is_key_down(KC_E));
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+    release_key(3, 0);
+    run_one_scan_loop();
+    EXPECT_FALSE(is_key_down(KC_E));
+}
+
+TEST_F(UnicodeAsync, RejectsStringsThatDoNotFit) {
+    TestDriver driver;
+    set_unicode_input_mode(UC_LNX);
+    std::string text;
+    for (uint8_t i = 0; i <= UNICODE_ASYNC_QUEUE_SIZE; i++) {
+        text += "é";
+    }
+
+    EXPECT_FALSE(send_unicode_string_async(text.c_str()));
+    EXPECT_FALSE(unicode_async_is_busy());
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+    EXPECT_TRUE(send_unicode_string_async(text.c_str() + 2));
+    EXPECT_FALSE(register_unicode_async(0xE9));
+    unicode_async_cancel();
+    run_until_idle();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(UnicodeAsync, UnicodeKeycodeIsTypedFromTheMainLoop) {
+    TestDriver   driver;
+    report_log_t async;
+    set_unicode_input_mode(UC_WINC);
+
+    press_key(0, 0);
+    record_reports(driver, async);
+    keyboard_task();
+    EXPECT_TRUE(unicode_async_is_busy());
+    release_key(0, 0);
+    run_until_idle();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_THAT(typed(async), ElementsAre(Pair(KC_RALT, MOD_BIT(KC_RALT)), Pair(KC_U, 0), Pair(KC_0, 0), Pair(KC_0, 0), Pair(KC_E, 0), Pair(KC_9, 0), Pair(KC_ENTER, 0)));
+}
@@ -0,0 +1,98 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::ElementsAre;
+using testing::InSequence;
+
+namespace {
+std::vector<uint8_t> encoded_keys(const report_keys_t& keys) {
+    report_keyboard_t report = {};
+    report_keys_encode(&keys, &report);
+    return std::vector<uint8_t>(report.keys, report.keys + KEYBOARD_REPORT_KEYS);
+}
+}  // namespace
+
+class Rollover : public TestFixture {};
+
+TEST(ReportKeys, KeysAreKeptInPressOrder) {
+    report_keys_t keys = {};
+    report_keys_add(&keys, KC_C);
+    report_keys_add(&keys, KC_A);
+    report_keys_add(&keys, KC_B);
+    EXPECT_THAT(encoded_keys(keys), ElementsAre(KC_C, KC_A, KC_B, 0, 0, 0));
+}
+
+TEST(ReportKeys, ReleaseCompactsTheRemainingKeys) {
+    report_keys_t keys = {};
+    report_keys_add(&keys, KC_A);
+    report_keys_add(&keys, KC_B);
+    report_keys_add(&keys, KC_C);
+    report_keys_del(&keys, KC_A);
+    EXPECT_THAT(encoded_keys(keys), ElementsAre(KC_B, KC_C, 0, 0, 0, 0));
+    report_keys_add(&keys, KC_A);
+    EXPECT_THAT(encoded_keys(keys), ElementsAre(KC_B, KC_C, KC_A, 0, 0, 0));
+}
+
+TEST(ReportKeys, SeventhKeyRollsOutTheOldest) {
+    report_keys_t keys = {};
+    for (uint8_t k = KC_A; k <= KC_G; k++) {
+        report_keys_add(&keys, k);
+    }
+    EXPECT_EQ(report_keys_count(&keys), 7);
+    EXPECT_TRUE(report_keys_has(&keys, KC_A));
+    EXPECT_THAT(encoded_keys(keys), ElementsAre(KC_B, KC_C, KC_D, KC_E, KC_F, KC_G));
+    report_keys_add(&keys, KC_H);
+    EXPECT_THAT(encoded_keys(keys), ElementsAre(KC_C, KC_D, KC_E, KC_F, KC_G, KC_H));
+}
+
+TEST(ReportKeys, ReleasingARolledOutKeyKeepsTheReport) {
+    report_keys_t keys = {};
+    for (uint8_t k = KC_A; k <= KC_G; k++) {
+        report_keys_add(&keys, k);
+    }
+    report_keys_del(&keys, KC_A);
+    EXPECT_EQ(report_keys_count(&keys), 6);
+    EXPECT_THAT(encoded_keys(keys), ElementsAre(KC_B, KC_C, KC_D, KC_E, KC_F, KC_G));
+    report_keys_del(&keys, KC_G);
+    EXPECT_THAT(encoded_keys(keys), ElementsAre(KC_B, KC_C, KC_D, KC_E, KC_F, 0));
+}
+
+TEST_F(Rollover, SeventhKeyReplacesTheFirstInTheReport) {
+    TestDriver driver;
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_C)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_C, KC_D)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_C, KC_D, KC_E)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_C, KC_D, KC_E, KC_F)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B, KC_C, KC_D, KC_E, KC_F, KC_G)));
+    for (uint8_t col = 0; col < 7; col++) {
+        press_key(col, 0);
+        run_one_scan_loop();
+    }
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // Releasing the rolled out KC_A does not change the report
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(6);
+    for (uint8_t col = 0; col < 7; col++) {
+        release_key(col, 0);
+        run_one_scan_loop();
+    }
+}
@@ -70,6 +70,11 @@ ifeq ($(strip $(MOUSEKEY_ENABLE)), yes)
     endif
 endif
 
+ifeq ($(strip $(INPUT_QUEUE_ENABLE)), yes)
+    TMK_COMMON_SRC += $(COMMON_DIR)/input_queue.c
+    TMK_COMMON_DEFS += -DINPUT_QUEUE_ENABLE
+endif
+
 ifeq ($(strip $(EXTRAKEY_ENABLE)), yes)
     TMK_COMMON_DEFS += -DEXTRAKEY_ENABLE
     SHARED_EP_ENABLE = yes
@@ -146,6 +146,7 @@ void process_hand_swap(keyevent_t *event) {
 bool disable_action_cache = false;
 
 void process_record_nocache(keyrecord_t *record) {
+    record->keycode      = KC_NO;
     disable_action_cache = true;
     process_record(record);
     disable_action_cache = false;
@@ -199,7 +200,7 @@ void process_record(keyrecord_t *record) {
 }
 
 void process_record_handler(keyrecord_t *record) {
-    action_t action = store_or_get_action(record->event.pressed, record->event.key);
+    action_t action = action_for_keycode(get_record_keycode(record, true));
     dprint("ACTION: ");
     debug_action(action);
 #ifndef NO_ACTION_LAYER
@@ -335,7 +336,7 @@ void process_action(keyrecord_t *record, action_t action) {
 #    if !defined(IGNORE_MOD_TAP_INTERRUPT) || defined(IGNORE_MOD_TAP_INTERRUPT_PER_KEY)
                             if (
 #        ifdef IGNORE_MOD_TAP_INTERRUPT_PER_KEY
-                                !get_ignore_mod_tap_interrupt(get_event_keycode(record->event, false)) &&
+                                !get_ignore_mod_tap_interrupt(get_record_keycode(record, false)) &&
 #        endif
                                 record->tap.interrupted) {
                                 dprint("mods_tap: tap: cancel: add_mods\n");
@@ -355,6 +356,7 @@ void process_action(keyrecord_t *record, action_t action) {
                     } else {
                         if (tap_count > 0) {
                             dprint("MODS_TAP: Tap: unregister_code\n");
+                            host_keyboard_flush();
                             if (action.layer_tap.code == KC_CAPS) {
                                 wait_ms(TAP_HOLD_CAPS_DELAY);
                             }
@@ -558,6 +560,7 @@ void process_action(keyrecord_t *record, action_t action) {
                     } else {
                         if (tap_count > 0) {
                             dprint("KEYMAP_TAP_KEY: Tap: unregister_code\n");
+                            host_keyboard_flush();
                             if (action.layer_tap.code == KC_CAPS) {
                                 wait_ms(TAP_HOLD_CAPS_DELAY);
                             } else {
@@ -638,6 +641,7 @@ void process_action(keyrecord_t *record, action_t action) {
                         if (event.pressed) {
                             register_code(action.swap.code);
                         } else {
+                            host_keyboard_flush();
                             wait_ms(TAP_CODE_DELAY);
                             unregister_code(action.swap.code);
                             *record = (keyrecord_t){};  // hack: reset tap mode
@@ -712,6 +716,7 @@ void process_action(keyrecord_t *record, action_t action) {
      */
     if (do_release_oneshot && !(get_oneshot_layer_state() & ONESHOT_PRESSED)) {
         record->event.pressed = false;
+        record->keycode       = KC_NO;
         layer_on(get_oneshot_layer());
         process_record(record);
         layer_off(get_oneshot_layer());
@@ -735,6 +740,7 @@ void register_code(uint8_t code) {
 #    endif
         add_key(KC_CAPSLOCK);
         send_keyboard_report();
+        host_keyboard_flush();
         wait_ms(100);
         del_key(KC_CAPSLOCK);
         send_keyboard_report();
@@ -746,6 +752,7 @@ void register_code(uint8_t code) {
 #    endif
         add_key(KC_NUMLOCK);
         send_keyboard_report();
+        host_keyboard_flush();
         wait_ms(100);
         del_key(KC_NUMLOCK);
         send_keyboard_report();
@@ -757,6 +764,7 @@ void register_code(uint8_t code) {
 #    endif
         add_key(KC_SCROLLLOCK);
         send_keyboard_report();
+        host_keyboard_flush();
         wait_ms(100);
         del_key(KC_SCROLLLOCK);
         send_keyboard_report();
@@ -787,7 +795,7 @@ void register_code(uint8_t code) {
                 // Force a new key press if the key is already pressed
                 // without this, keys with the same keycode, but different
                 // modifiers will be reported incorrectly, see issue #1708
-                if (is_key_pressed(keyboard_report, code)) {
+                if (is_key_down(code)) {
                     del_key(code);
                     send_keyboard_report();
                 }
@@ -885,6 +893,7 @@ void unregister_code(uint8_t code) {
  */
 void tap_code(uint8_t code) {
     register_code(code);
+    host_keyboard_flush();
     if (code == KC_CAPS) {
         wait_ms(TAP_HOLD_CAPS_DELAY);
     } else {
@@ -982,6 +991,13 @@ bool is_tap_key(keypos_t key) {
     return is_tap_action(action);
 }
 
+/** \brief Checks whether a pressed record starts tapping
+ *
+ * Resolves the record's keycode on the current layers, so a key that turns
+ * out not to tap is processed without looking it up again.
+ */
+bool is_tap_record(keyrecord_t *record) { return is_tap_action(action_for_keycode(get_record_keycode(record, true))); }
+
 /** \brief Utilities for actions. (FIXME: Needs better description)
  *
  * FIXME: Needs documentation.
@@ -1020,7 +1036,7 @@ bool is_tap_action(action_t action) {
  *
  * FIXME: Needs documentation.
  */
-void debug_event(keyevent_t event) { dprintf("%04X%c(%u)", (event.key.row << 8 | event.key.col), (event.pressed ? 'd' : 'u'), event.time); }
+void debug_event(keyevent_t event) { dprintf("%04X%c(%lu)", (event.key.row << 8 | event.key.col), (event.pressed ? 'd' : 'u'), (uint32_t)event.time); }
 /** \brief Debug print (FIXME: Needs better description)
  *
  * FIXME: Needs documentation.
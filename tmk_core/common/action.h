@@ -53,6 +53,7 @@ typedef struct {
 #ifndef NO_ACTION_TAPPING
     tap_t tap;
 #endif
+    uint16_t keycode;  // resolved by get_record_keycode(), KC_NO until then
 } keyrecord_t;
 
 /* Execute action per keyevent */
@@ -60,6 +61,10 @@ void action_exec(keyevent_t event);
 
 /* action for key */
 action_t action_for_key(uint8_t layer, keypos_t key);
+action_t action_for_keycode(uint16_t keycode);
+
+/* keycode for key, resolved once per record */
+uint16_t get_record_keycode(keyrecord_t *record, bool update_layer_cache);
 
 /* macro */
 const macro_t *action_get_macro(keyrecord_t *record, uint8_t id, uint8_t opt);
@@ -110,6 +115,7 @@ void clear_keyboard_but_mods(void);
 void clear_keyboard_but_mods_and_keys(void);
 void layer_switch(uint8_t new_layer);
 bool is_tap_key(keypos_t key);
+bool is_tap_record(keyrecord_t *record);
 bool is_tap_action(action_t action);
 
 #ifndef NO_ACTION_TAPPING
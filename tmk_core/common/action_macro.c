@@ -17,6 +17,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "action.h"
 #include "action_util.h"
 #include "action_macro.h"
+#include "host.h"
 #include "wait.h"
 
 #ifdef DEBUG_ACTION
@@ -63,6 +64,7 @@ void action_macro_play(const macro_t *macro_p) {
                 MACRO_READ();
                 dprintf("WAIT(%u)\n", macro);
                 {
+                    host_keyboard_flush();
                     uint8_t ms = macro;
                     while (ms--) wait_ms(1);
                 }
@@ -84,7 +86,8 @@ void action_macro_play(const macro_t *macro_p) {
                 return;
         }
         // interval
-        {
+        if (interval) {
+            host_keyboard_flush();
             uint8_t ms = interval;
             while (ms--) wait_ms(1);
         }
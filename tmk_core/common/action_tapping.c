@@ -22,9 +22,9 @@
 __attribute__((weak)) uint16_t get_tapping_term(uint16_t keycode) { return TAPPING_TERM; }
 
 #    ifdef TAPPING_TERM_PER_KEY
-#        define WITHIN_TAPPING_TERM(e) (TIMER_DIFF_16(e.time, tapping_key.event.time) < get_tapping_term(get_event_keycode(tapping_key.event, false)))
+#        define WITHIN_TAPPING_TERM(e) (EVENT_TIME_DIFF(e.time, tapping_key.event.time) < EVENT_TIME_MS(get_tapping_term(get_record_keycode(&tapping_key, false))))
 #    else
-#        define WITHIN_TAPPING_TERM(e) (TIMER_DIFF_16(e.time, tapping_key.event.time) < TAPPING_TERM)
+#        define WITHIN_TAPPING_TERM(e) (EVENT_TIME_DIFF(e.time, tapping_key.event.time) < EVENT_TIME_MS(TAPPING_TERM))
 #    endif
 
 #    ifdef TAPPING_FORCE_HOLD_PER_KEY
@@ -39,6 +39,7 @@ static keyrecord_t tapping_key                         = {};
 static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE] = {};
 static uint8_t     waiting_buffer_head                 = 0;
 static uint8_t     waiting_buffer_tail                 = 0;
+static uint8_t     waiting_buffer_overflow_count       = 0;
 
 static bool process_tapping(keyrecord_t *record);
 static bool waiting_buffer_enq(keyrecord_t record);
@@ -64,6 +65,7 @@ void action_tapping_process(keyrecord_t record) {
         if (!waiting_buffer_enq(record)) {
             // clear all in case of overflow.
             debug("OVERFLOW: CLEAR ALL STATES\n");
+            waiting_buffer_overflow_count++;
             clear_keyboard();
             waiting_buffer_clear();
             tapping_key = (keyrecord_t){};
@@ -122,10 +124,10 @@ bool process_tapping(keyrecord_t *keyp) {
 #    if defined(TAPPING_TERM_PER_KEY) || (TAPPING_TERM >= 500) || defined(PERMISSIVE_HOLD) || defined(PERMISSIVE_HOLD_PER_KEY)
                 else if (
 #        ifdef TAPPING_TERM_PER_KEY
-                    (get_tapping_term(get_event_keycode(tapping_key.event, false)) >= 500) &&
+                    (get_tapping_term(get_record_keycode(&tapping_key, false)) >= 500) &&
 #        endif
 #        ifdef PERMISSIVE_HOLD_PER_KEY
-                    !get_permissive_hold(get_event_keycode(tapping_key.event, false), keyp) &&
+                    !get_permissive_hold(get_record_keycode(&tapping_key, false), keyp) &&
 #        endif
                     IS_RELEASED(event) && waiting_buffer_typed(event)) {
                     debug("Tapping: End. No tap. Interfered by typing key\n");
@@ -246,7 +248,7 @@ bool process_tapping(keyrecord_t *keyp) {
 #    if !defined(TAPPING_FORCE_HOLD) || defined(TAPPING_FORCE_HOLD_PER_KEY)
                     if (
 #        ifdef TAPPING_FORCE_HOLD_PER_KEY
-                        !get_tapping_force_hold(get_event_keycode(tapping_key.event, false), keyp) &&
+                        !get_tapping_force_hold(get_record_keycode(&tapping_key, false), keyp) &&
 #        endif
                         !tapping_key.tap.interrupted && tapping_key.tap.count > 0) {
                         // sequential tap.
@@ -296,7 +298,7 @@ bool process_tapping(keyrecord_t *keyp) {
     }
     // not tapping state
     else {
-        if (event.pressed && is_tap_key(event.key)) {
+        if (event.pressed && is_tap_record(keyp)) {
             debug("Tapping: Start(Press tap key).\n");
             tapping_key = *keyp;
             process_record_tap_hint(&tapping_key);
@@ -310,6 +312,12 @@ bool process_tapping(keyrecord_t *keyp) {
     }
 }
 
+/** \brief Number of times the waiting buffer overflowed and all states were cleared
+ *
+ * Wraps after 255, for tests and debugging.
+ */
+uint8_t waiting_buffer_overflows(void) { return waiting_buffer_overflow_count; }
+
 /** \brief Waiting buffer enq
  *
  * FIXME: Needs docs
@@ -35,6 +35,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 uint16_t get_event_keycode(keyevent_t event, bool update_layer_cache);
 uint16_t get_tapping_term(uint16_t keycode);
 void     action_tapping_process(keyrecord_t record);
+uint8_t  waiting_buffer_overflows(void);
 #endif
 
 #endif
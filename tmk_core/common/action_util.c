@@ -28,24 +28,26 @@ static uint8_t real_mods  = 0;
 static uint8_t weak_mods  = 0;
 static uint8_t macro_mods = 0;
 
-#ifdef USB_6KRO_ENABLE
-#    define RO_ADD(a, b) ((a + b) % KEYBOARD_REPORT_KEYS)
-#    define RO_SUB(a, b) ((a - b + KEYBOARD_REPORT_KEYS) % KEYBOARD_REPORT_KEYS)
-#    define RO_INC(a) RO_ADD(a, 1)
-#    define RO_DEC(a) RO_SUB(a, 1)
-static int8_t cb_head  = 0;
-static int8_t cb_tail  = 0;
-static int8_t cb_count = 0;
-#endif
+// Sent instead of the modifiers, and on top of the keys, while an input sequence is being typed
+static uint8_t override_mods     = 0;
+static uint8_t override_key      = KC_NO;
+static bool    report_overridden = false;
 
 // TODO: pointer variable is not needed
 // report_keyboard_t keyboard_report = {};
 report_keyboard_t *keyboard_report = &(report_keyboard_t){};
+report_keys_t      keyboard_keys   = {};
 
 extern inline void add_key(uint8_t key);
 extern inline void del_key(uint8_t key);
 extern inline void clear_keys(void);
 
+/** \brief Checks if a key is held in the keyboard state
+ *
+ * Unlike is_key_pressed() this does not depend on the last sent report.
+ */
+bool is_key_down(uint8_t key) { return report_keys_has(&keyboard_keys, key); }
+
 #ifndef NO_ACTION_ONESHOT
 static uint8_t oneshot_mods        = 0;
 static uint8_t oneshot_locked_mods = 0;
@@ -189,6 +191,7 @@ bool is_oneshot_layer_active(void) { return get_oneshot_layer_state(); }
  * FIXME: needs doc
  */
 void send_keyboard_report(void) {
+    report_keys_encode(&keyboard_keys, keyboard_report);
     keyboard_report->mods = real_mods;
     keyboard_report->mods |= weak_mods;
     keyboard_report->mods |= macro_mods;
@@ -201,12 +204,18 @@ void send_keyboard_report(void) {
         }
 #    endif
         keyboard_report->mods |= oneshot_mods;
-        if (has_anykey(keyboard_report)) {
+        if (report_keys_count(&keyboard_keys)) {
             clear_oneshot_mods();
         }
     }
 
 #endif
+    if (report_overridden) {
+        keyboard_report->mods = override_mods;
+        if (override_key != KC_NO) {
+            add_key_to_report(keyboard_report, override_key);
+        }
+    }
     host_keyboard_send(keyboard_report);
 }
 
@@ -289,6 +298,29 @@ void set_macro_mods(uint8_t mods) { macro_mods = mods; }
  */
 void clear_macro_mods(void) { macro_mods = 0; }
 
+/* override report */
+/** \brief set override report
+ *
+ * Reports carry exactly these modifiers, and this key on top of the ones held,
+ * until clear_override_report(). The keys and the real, weak and oneshot
+ * modifiers are left alone, so an input sequence typed over several scans
+ * never presses or releases a key for the user.
+ */
+void set_override_report(uint8_t mods, uint8_t key) {
+    override_mods     = mods;
+    override_key      = key;
+    report_overridden = true;
+}
+/** \brief clear override report
+ *
+ * Reports carry the keyboard state again.
+ */
+void clear_override_report(void) {
+    override_mods     = 0;
+    override_key      = KC_NO;
+    report_overridden = false;
+}
+
 #ifndef NO_ACTION_ONESHOT
 /** \brief set oneshot mods
  *
@@ -25,15 +25,18 @@ extern "C" {
 #endif
 
 extern report_keyboard_t *keyboard_report;
+extern report_keys_t      keyboard_keys;
 
 void send_keyboard_report(void);
 
 /* key */
-inline void add_key(uint8_t key) { add_key_to_report(keyboard_report, key); }
+inline void add_key(uint8_t key) { report_keys_add(&keyboard_keys, key); }
 
-inline void del_key(uint8_t key) { del_key_from_report(keyboard_report, key); }
+inline void del_key(uint8_t key) { report_keys_del(&keyboard_keys, key); }
 
-inline void clear_keys(void) { clear_keys_from_report(keyboard_report); }
+inline void clear_keys(void) { report_keys_clear(&keyboard_keys); }
+
+bool is_key_down(uint8_t key);
 
 /* modifier */
 uint8_t get_mods(void);
@@ -56,6 +59,10 @@ void    del_macro_mods(uint8_t mods);
 void    set_macro_mods(uint8_t mods);
 void    clear_macro_mods(void);
 
+/* override report */
+void set_override_report(uint8_t mods, uint8_t key);
+void clear_override_report(void);
+
 /* oneshot modifier */
 void    set_oneshot_mods(uint8_t mods);
 uint8_t get_oneshot_mods(void);
@@ -124,6 +124,43 @@ inline uint32_t timer_elapsed32(uint32_t last) {
     return TIMER_DIFF_32(t, last);
 }
 
+#if defined(__AVR_ATmega32A__)
+#    define TIMER_INTERRUPT_PENDING (TIFR & _BV(OCF0))
+#elif defined(__AVR_ATtiny85__)
+#    define TIMER_INTERRUPT_PENDING (TIFR & _BV(OCF0A))
+#else
+#    define TIMER_INTERRUPT_PENDING (TIFR0 & _BV(OCF0A))
+#endif
+
+/** \brief timer read in microseconds
+ *
+ * The millisecond count plus the fraction Timer0 has counted towards the next
+ * one. A compare match still waiting for its interrupt counts as a millisecond
+ * if the counter was read after it restarted.
+ */
+uint32_t timer_read_us(void) {
+    uint32_t t;
+    uint8_t  raw;
+    bool     pending;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        t       = timer_count;
+        raw     = TIMER_RAW;
+        pending = TIMER_INTERRUPT_PENDING;
+    }
+    if (pending && raw < TIMER_RAW_TOP / 2) {
+        t++;
+    }
+
+    return t * 1000 + (uint32_t)raw * 1000 / (TIMER_RAW_TOP + 1);
+}
+
+/** \brief timer elapsed in microseconds
+ *
+ * Handles a single wrap of the microsecond counter.
+ */
+uint32_t timer_elapsed_us(uint32_t last) { return TIMER_DIFF_32(timer_read_us(), last); }
+
 // excecuted once per 1ms.(excess for just timer count?)
 #ifndef __AVR_ATmega32A__
 #    define TIMER_INTERRUPT_VECTOR TIMER0_COMPA_vect
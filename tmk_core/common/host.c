@@ -16,9 +16,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <stdint.h>
+#include <string.h>
 //#include <avr/interrupt.h>
 #include "keycode.h"
 #include "host.h"
+#include "timer.h"
 #include "util.h"
 #include "debug.h"
 
@@ -27,11 +29,31 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 extern keymap_config_t keymap_config;
 #endif
 
+#ifdef POINTING_DEVICE_HIRES_SCROLL
+uint8_t mouse_resolution_multiplier = 0;
+#endif
+
 static host_driver_t *driver;
 static uint16_t       last_system_report   = 0;
 static uint16_t       last_consumer_report = 0;
 
-void host_set_driver(host_driver_t *d) { driver = d; }
+static report_keyboard_t   last_keyboard_report;
+static host_report_stats_t keyboard_report_stats;
+#if defined(KEYBOARD_REPORT_INTERVAL) && KEYBOARD_REPORT_INTERVAL > 0
+static report_keyboard_t pending_keyboard_report;
+static bool              keyboard_report_pending = false;
+static uint16_t          last_keyboard_time      = 0;
+#endif
+
+void host_set_driver(host_driver_t *d) {
+    driver = d;
+    // A new driver has not seen any report yet, so nothing can be a duplicate
+    memset(&last_keyboard_report, 0xFF, sizeof(last_keyboard_report));
+#if defined(KEYBOARD_REPORT_INTERVAL) && KEYBOARD_REPORT_INTERVAL > 0
+    keyboard_report_pending = false;
+    last_keyboard_time      = timer_read() - KEYBOARD_REPORT_INTERVAL;
+#endif
+}
 
 host_driver_t *host_get_driver(void) { return driver; }
 
@@ -45,6 +67,67 @@ led_t host_keyboard_led_state(void) {
     return (led_t)((*driver->keyboard_leds)());
 }
 
+static void keyboard_report_transmit(report_keyboard_t *report) {
+    (*driver->send_keyboard)(report);
+    memcpy(&last_keyboard_report, report, sizeof(report_keyboard_t));
+    keyboard_report_stats.sent++;
+#if defined(KEYBOARD_REPORT_INTERVAL) && KEYBOARD_REPORT_INTERVAL > 0
+    last_keyboard_time = timer_read();
+#endif
+
+    if (debug_keyboard) {
+        dprint("keyboard_report: ");
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_SIZE; i++) {
+            dprintf("%02X ", report->raw[i]);
+        }
+        dprint("\n");
+    }
+}
+
+#if defined(KEYBOARD_REPORT_INTERVAL) && KEYBOARD_REPORT_INTERVAL > 0
+static bool report_has_key(const report_keyboard_t *report, uint8_t key) {
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (report->keys[i] == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** \brief Checks if the pending report can be replaced without losing an edge
+ *
+ * Replacing is only safe when no key or modifier changes state both from the
+ * last sent report to the pending one and from the pending one to the new one,
+ * otherwise the host would never see a press or a release.
+ */
+static bool keyboard_report_mergeable(const report_keyboard_t *sent, const report_keyboard_t *pending, const report_keyboard_t *next) {
+#    ifdef NKRO_ENABLE
+    if (keyboard_protocol && keymap_config.nkro) {
+        for (uint8_t i = 0; i < sizeof(report_keyboard_t); i++) {
+            if ((sent->raw[i] ^ pending->raw[i]) & (pending->raw[i] ^ next->raw[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+#    endif
+    if ((sent->mods ^ pending->mods) & (pending->mods ^ next->mods)) {
+        return false;
+    }
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        uint8_t key = pending->keys[i];
+        if (key && !report_has_key(sent, key) && !report_has_key(next, key)) {
+            return false;
+        }
+        key = sent->keys[i];
+        if (key && !report_has_key(pending, key) && report_has_key(next, key)) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
 /* send report */
 void host_keyboard_send(report_keyboard_t *report) {
     if (!driver) return;
@@ -62,17 +145,62 @@ void host_keyboard_send(report_keyboard_t *report) {
         report->report_id = REPORT_ID_KEYBOARD;
 #endif
     }
-    (*driver->send_keyboard)(report);
 
-    if (debug_keyboard) {
-        dprint("keyboard_report: ");
-        for (uint8_t i = 0; i < KEYBOARD_REPORT_SIZE; i++) {
-            dprintf("%02X ", report->raw[i]);
+#if defined(KEYBOARD_REPORT_INTERVAL) && KEYBOARD_REPORT_INTERVAL > 0
+    if (keyboard_report_pending) {
+        if (memcmp(report, &pending_keyboard_report, sizeof(report_keyboard_t)) == 0) {
+            keyboard_report_stats.dropped++;
+            return;
         }
-        dprint("\n");
+        if (keyboard_report_mergeable(&last_keyboard_report, &pending_keyboard_report, report)) {
+            memcpy(&pending_keyboard_report, report, sizeof(report_keyboard_t));
+            keyboard_report_stats.merged++;
+            return;
+        }
+        host_keyboard_flush();
+    }
+#endif
+    if (memcmp(report, &last_keyboard_report, sizeof(report_keyboard_t)) == 0) {
+        keyboard_report_stats.dropped++;
+        return;
+    }
+#if defined(KEYBOARD_REPORT_INTERVAL) && KEYBOARD_REPORT_INTERVAL > 0
+    if (timer_elapsed(last_keyboard_time) < KEYBOARD_REPORT_INTERVAL) {
+        memcpy(&pending_keyboard_report, report, sizeof(report_keyboard_t));
+        keyboard_report_pending = true;
+        return;
     }
+#endif
+    keyboard_report_transmit(report);
+}
+
+/** \brief Sends the report held back for the current polling interval
+ *
+ * Called before anything that blocks, so a held back release is not delayed.
+ */
+void host_keyboard_flush(void) {
+#if defined(KEYBOARD_REPORT_INTERVAL) && KEYBOARD_REPORT_INTERVAL > 0
+    if (keyboard_report_pending && driver) {
+        keyboard_report_pending = false;
+        keyboard_report_transmit(&pending_keyboard_report);
+    }
+#endif
 }
 
+/** \brief Sends a held back report once its polling interval has passed
+ */
+void host_keyboard_task(void) {
+#if defined(KEYBOARD_REPORT_INTERVAL) && KEYBOARD_REPORT_INTERVAL > 0
+    if (keyboard_report_pending && timer_elapsed(last_keyboard_time) >= KEYBOARD_REPORT_INTERVAL) {
+        host_keyboard_flush();
+    }
+#endif
+}
+
+host_report_stats_t host_keyboard_report_stats(void) { return keyboard_report_stats; }
+
+void host_keyboard_report_stats_clear(void) { memset(&keyboard_report_stats, 0, sizeof(keyboard_report_stats)); }
+
 void host_mouse_send(report_mouse_t *report) {
     if (!driver) return;
 #ifdef MOUSE_SHARED_EP
@@ -33,8 +33,20 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 extern "C" {
 #endif
 
+/* keyboard report scheduler counters */
+typedef struct {
+    uint32_t sent;
+    uint32_t dropped;
+    uint32_t merged;
+} host_report_stats_t;
+
 extern uint8_t keyboard_idle;
 extern uint8_t keyboard_protocol;
+#ifdef POINTING_DEVICE_HIRES_SCROLL
+/* Set by the host with the mouse feature report: 1 when it takes the wheels
+ * in 1/POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER notch, 0 for whole notches */
+extern uint8_t mouse_resolution_multiplier;
+#endif
 
 /* host driver */
 void           host_set_driver(host_driver_t *driver);
@@ -48,6 +60,11 @@ void    host_mouse_send(report_mouse_t *report);
 void    host_system_send(uint16_t data);
 void    host_consumer_send(uint16_t data);
 
+void                host_keyboard_flush(void);
+void                host_keyboard_task(void);
+host_report_stats_t host_keyboard_report_stats(void);
+void                host_keyboard_report_stats_clear(void);
+
 uint16_t host_last_system_report(void);
 uint16_t host_last_consumer_report(void);
 
@@ -0,0 +1,87 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "input_queue.h"
+#include "timer.h"
+
+/* Free running indices, only ever written by one side each. Their
+ * difference is the number of queued events, which is why the size has
+ * to divide 256. Single byte loads and stores are atomic on every
+ * target, the acquire/release ordering keeps the event copy on the
+ * right side of the index update. */
+static input_event_t queue[INPUT_QUEUE_SIZE];
+static uint8_t       head = 0;  // written by the producer
+static uint8_t       tail = 0;  // written by the consumer
+
+/* Events the producer could not queue, and how many of them the
+ * consumer has already reported. */
+static uint8_t dropped      = 0;
+static uint8_t dropped_seen = 0;
+
+/** \brief Queues an input event
+ *
+ * Returns false, and counts the event as dropped, when the queue is full.
+ */
+bool input_queue_push(const input_event_t *event) {
+    uint8_t h = head;
+    if ((uint8_t)(h - __atomic_load_n(&tail, __ATOMIC_ACQUIRE)) == INPUT_QUEUE_SIZE) {
+        __atomic_store_n(&dropped, dropped + 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    queue[h & (INPUT_QUEUE_SIZE - 1)] = *event;
+    __atomic_store_n(&head, (uint8_t)(h + 1), __ATOMIC_RELEASE);
+    return true;
+}
+
+bool input_queue_key(uint8_t row, uint8_t col, bool pressed) {
+    input_event_t event = {.type = INPUT_EVENT_KEY, .time = (event_timer_read() | 1), .key = {.key = {.row = row, .col = col}, .pressed = pressed}};
+    return input_queue_push(&event);
+}
+
+bool input_queue_encoder(uint8_t index, bool clockwise) {
+    input_event_t event = {.type = INPUT_EVENT_ENCODER, .time = (event_timer_read() | 1), .encoder = {.index = index, .clockwise = clockwise}};
+    return input_queue_push(&event);
+}
+
+bool input_queue_pointer(int8_t x, int8_t y) {
+    input_event_t event = {.type = INPUT_EVENT_POINTER, .time = (event_timer_read() | 1), .pointer = {.x = x, .y = y}};
+    return input_queue_push(&event);
+}
+
+/** \brief Takes the oldest event off the queue
+ *
+ * Returns false when the queue is empty.
+ */
+bool input_queue_pop(input_event_t *event) {
+    uint8_t t = tail;
+    if (t == __atomic_load_n(&head, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    *event = queue[t & (INPUT_QUEUE_SIZE - 1)];
+    __atomic_store_n(&tail, (uint8_t)(t + 1), __ATOMIC_RELEASE);
+    return true;
+}
+
+/** \brief Number of events dropped since the last call
+ *
+ * Counts up to 255 drops between two calls.
+ */
+uint8_t input_queue_dropped(void) {
+    uint8_t now   = __atomic_load_n(&dropped, __ATOMIC_RELAXED);
+    uint8_t count = now - dropped_seen;
+    dropped_seen  = now;
+    return count;
+}
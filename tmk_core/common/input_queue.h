@@ -0,0 +1,65 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "keyboard.h"
+
+/* Number of events the queue holds, a power of two up to 128 */
+#ifndef INPUT_QUEUE_SIZE
+#    define INPUT_QUEUE_SIZE 32
+#endif
+
+#if INPUT_QUEUE_SIZE < 2 || INPUT_QUEUE_SIZE > 128 || (INPUT_QUEUE_SIZE & (INPUT_QUEUE_SIZE - 1))
+#    error "INPUT_QUEUE_SIZE must be a power of two between 2 and 128"
+#endif
+
+enum input_event_type {
+    INPUT_EVENT_KEY,
+    INPUT_EVENT_ENCODER,
+    INPUT_EVENT_POINTER,
+};
+
+typedef struct {
+    uint8_t      type;
+    event_time_t time;  // when the input was sampled
+    union {
+        struct {
+            keypos_t key;
+            bool     pressed;
+        } key;
+        struct {
+            uint8_t index;
+            bool    clockwise;
+        } encoder;
+        struct {
+            int8_t x;
+            int8_t y;
+        } pointer;
+    };
+} input_event_t;
+
+/* Producer side: one context only, e.g. a timer ISR or a DMA callback */
+bool input_queue_push(const input_event_t *event);
+bool input_queue_key(uint8_t row, uint8_t col, bool pressed);
+bool input_queue_encoder(uint8_t index, bool clockwise);
+bool input_queue_pointer(int8_t x, int8_t y);
+
+/* Consumer side: keyboard_task() */
+bool    input_queue_pop(input_event_t *event);
+uint8_t input_queue_dropped(void);
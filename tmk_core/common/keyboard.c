@@ -86,6 +86,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef VIA_ENABLE
 #    include "via.h"
 #endif
+#ifdef INPUT_QUEUE_ENABLE
+#    include "input_queue.h"
+#endif
+#ifdef ENCODER_ENABLE
+#    include "encoder.h"
+#endif
+#ifdef UNICODE_ASYNC_ENABLE
+#    include "process_unicode_async.h"
+#endif
 
 // Only enable this if console is enabled to print to
 #if defined(DEBUG_MATRIX_SCAN_RATE) && defined(CONSOLE_ENABLE)
@@ -272,6 +281,49 @@ void keyboard_init(void) {
     keyboard_post_init_kb(); /* Always keep this last */
 }
 
+#ifdef INPUT_QUEUE_ENABLE
+/** \brief Processes the events queued since the last scan
+ *
+ * Key events keep the time they were sampled at, so tapping decisions do not
+ * depend on how long the rest of the loop took.
+ */
+static void input_queue_task(void) {
+    input_event_t event;
+    uint8_t       dropped = input_queue_dropped();
+
+    if (dropped) {
+        dprintf("input queue: %u events dropped\n", dropped);
+    }
+
+#    ifdef UNICODE_ASYNC_ENABLE
+    // The events wait in the queue while a Unicode batch is typed, like the matrix changes in keyboard_task()
+    if (unicode_async_is_busy()) {
+        return;
+    }
+#    endif
+
+    while (input_queue_pop(&event)) {
+        switch (event.type) {
+            case INPUT_EVENT_KEY:
+                if (should_process_keypress()) {
+                    action_exec((keyevent_t){.key = event.key.key, .pressed = event.key.pressed, .time = event.time});
+                }
+                break;
+#    ifdef ENCODER_ENABLE
+            case INPUT_EVENT_ENCODER:
+                encoder_update_kb(event.encoder.index, event.encoder.clockwise);
+                break;
+#    endif
+#    ifdef POINTING_DEVICE_ENABLE
+            case INPUT_EVENT_POINTER:
+                pointing_device_add_motion(event.pointer.x, event.pointer.y);
+                break;
+#    endif
+        }
+    }
+}
+#endif
+
 /** \brief Keyboard task: Do keyboard routine jobs
  *
  * Do routine keyboard jobs:
@@ -299,6 +351,10 @@ void keyboard_task(void) {
     matrix_scan();
 #endif
 
+#ifdef INPUT_QUEUE_ENABLE
+    input_queue_task();
+#endif
+
     if (should_process_keypress()) {
         for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
             matrix_row    = matrix_get_row(r);
@@ -313,9 +369,19 @@ void keyboard_task(void) {
                 matrix_row_t col_mask = 1;
                 for (uint8_t c = 0; c < MATRIX_COLS; c++, col_mask <<= 1) {
                     if (matrix_change & col_mask) {
-                        action_exec((keyevent_t){
-                            .key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = (timer_read() | 1) /* time should not be 0 */
-                        });
+                        keyevent_t event = {
+                            .key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = (event_timer_read() | 1) /* time should not be 0 */
+                        };
+#ifdef UNICODE_ASYNC_ENABLE
+                        // Held back while a Unicode batch is typed, so the key is not sent with its modifiers.
+                        // A change that does not fit is left in the matrix for a later scan.
+                        if (unicode_async_is_busy()) {
+                            if (!unicode_async_hold_event(event)) {
+                                continue;
+                            }
+                        } else
+#endif
+                            action_exec(event);
                         // record a processed key
                         matrix_prev[r] ^= col_mask;
 #ifdef QMK_KEYS_PER_SCAN
@@ -403,6 +469,8 @@ MATRIX_LOOP_END:
     }
 #endif
 
+    host_keyboard_task();
+
     // update LED
     if (led_status != host_keyboard_leds()) {
         led_status = host_keyboard_leds();
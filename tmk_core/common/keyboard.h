@@ -31,11 +31,27 @@ typedef struct {
     uint8_t row;
 } keypos_t;
 
+/* Time of a key event: the microsecond timer with EVENT_TIME_US defined,
+ * the 16 bit millisecond timer otherwise. Events set it to
+ * (event_timer_read() | 1) as it is never 0.
+ */
+#ifdef EVENT_TIME_US
+typedef uint32_t event_time_t;
+#    define event_timer_read() timer_read_us()
+#    define EVENT_TIME_DIFF(a, b) TIMER_DIFF_32(a, b)
+#    define EVENT_TIME_MS(ms) ((uint32_t)(ms)*1000)
+#else
+typedef uint16_t event_time_t;
+#    define event_timer_read() timer_read()
+#    define EVENT_TIME_DIFF(a, b) TIMER_DIFF_16(a, b)
+#    define EVENT_TIME_MS(ms) (ms)
+#endif
+
 /* key event */
 typedef struct {
-    keypos_t key;
-    bool     pressed;
-    uint16_t time;
+    keypos_t     key;
+    bool         pressed;
+    event_time_t time;
 } keyevent_t;
 
 /* equivalent test of keypos_t */
@@ -51,7 +67,7 @@ static inline bool IS_RELEASED(keyevent_t event) { return (!IS_NOEVENT(event) &&
 
 /* Tick event */
 #define TICK \
-    (keyevent_t) { .key = (keypos_t){.row = 255, .col = 255}, .pressed = false, .time = (timer_read() | 1) }
+    (keyevent_t) { .key = (keypos_t){.row = 255, .col = 255}, .pressed = false, .time = (event_timer_read() | 1) }
 
 /* it runs once at early stage of startup before keyboard_init. */
 void keyboard_setup(void);
@@ -37,7 +37,226 @@ static uint8_t        mousekey_accel  = 0;
 static uint8_t        mousekey_repeat = 0;
 static uint16_t       last_timer      = 0;
 
-#ifndef MK_3_SPEED
+#if defined(MK_SMOOTH_SPEED)
+
+/*
+ * Smooth mouse keys
+ *
+ * The speed follows a curve from the initial to the maximum speed while the
+ * keys are held, and is integrated every millisecond into a distance with 1/256
+ * of a pixel per second resolution. Whole pixels are reported once per
+ * MOUSEKEY_SMOOTH_INTERVAL and the rest carries over, so slow and diagonal
+ * movements don't lose anything to rounding.
+ */
+/* curve used to reach the maximum speed, MK_CURVE_LINEAR, MK_CURVE_QUADRATIC or MK_CURVE_KINETIC */
+uint8_t mk_smooth_curve = MOUSEKEY_SMOOTH_CURVE;
+/* speed in pixels per second right after a key is pressed */
+uint16_t mk_smooth_initial_speed = MOUSEKEY_SMOOTH_INITIAL_SPEED;
+/* speed in pixels per second after the keys have been held for mk_smooth_time_to_max */
+uint16_t mk_smooth_max_speed   = MOUSEKEY_SMOOTH_MAX_SPEED;
+uint16_t mk_smooth_time_to_max = MOUSEKEY_SMOOTH_TIME_TO_MAX;
+/* kinetic curve: milliseconds for the speed to drop to about a third once the keys are released */
+uint16_t mk_smooth_friction = MOUSEKEY_SMOOTH_FRICTION;
+/* wheel params, in scroll steps per second */
+uint16_t mk_smooth_wheel_initial_speed = MOUSEKEY_SMOOTH_WHEEL_INITIAL_SPEED;
+uint16_t mk_smooth_wheel_max_speed     = MOUSEKEY_SMOOTH_WHEEL_MAX_SPEED;
+uint16_t mk_smooth_wheel_time_to_max   = MOUSEKEY_SMOOTH_WHEEL_TIME_TO_MAX;
+
+// A pixel or scroll step, in the units of speed (1/256 per second) times milliseconds
+#    define MK_UNIT (256L * 1000)
+// Longest step integrated at once, after the main loop was busy
+#    define MK_MAX_STEP 32
+
+typedef struct {
+    uint32_t speed;  // in 1/256 per second, 0 while still
+    uint16_t held;   // milliseconds since the keys were pressed
+    int8_t   dx;     // direction, kept while gliding
+    int8_t   dy;
+    int32_t  x;  // distance not reported yet, in MK_UNIT
+    int32_t  y;
+} mk_motion_t;
+
+static mk_motion_t cursor_motion = {0};
+static mk_motion_t wheel_motion  = {0};
+static uint16_t    last_tick     = 0;
+// Movement and wheel keys held, one bit per keycode from KC_MS_UP
+static uint16_t held_keys = 0;
+
+#    define MK_KEY_BIT(code) (1U << ((code)-KC_MS_UP))
+
+static int8_t key_direction(uint8_t negative, uint8_t positive) { return (held_keys & MK_KEY_BIT(positive) ? 1 : 0) - (held_keys & MK_KEY_BIT(negative) ? 1 : 0); }
+
+// The constant speed of the accel keys, 0 when none is held
+static uint16_t accel_speed(uint16_t max) {
+    if (mousekey_accel & (1 << 0)) {
+        return max / 4;
+    } else if (mousekey_accel & (1 << 1)) {
+        return max / 2;
+    } else if (mousekey_accel & (1 << 2)) {
+        return max;
+    }
+    return 0;
+}
+
+static uint32_t curve_speed(uint16_t initial, uint16_t max, uint16_t time_to_max, uint16_t held) {
+    if (held >= time_to_max) {
+        return (uint32_t)max << 8;
+    }
+    uint32_t ramp = ((uint32_t)held << 16) / time_to_max;  // in 1/65536
+    if (mk_smooth_curve == MK_CURVE_QUADRATIC) {
+        ramp = ramp * ramp >> 16;
+    }
+    return ((uint32_t)initial << 8) + (((int32_t)max - initial) * (int32_t)(ramp >> 4) >> 4);
+}
+
+static int32_t clamp_distance(int32_t distance, int32_t limit) { return distance > limit ? limit : (distance < -limit ? -limit : distance); }
+
+/** \brief Advances one motion by dt milliseconds, returns whether it has whole units to report */
+static bool motion_step(mk_motion_t *motion, int8_t dx, int8_t dy, uint16_t initial, uint16_t max, uint16_t time_to_max, uint8_t limit, uint16_t dt) {
+    if (dx || dy) {
+        motion->dx   = dx;
+        motion->dy   = dy;
+        motion->held = motion->held > UINT16_MAX - dt ? UINT16_MAX : motion->held + dt;
+
+        uint16_t fixed = accel_speed(max);
+        if (fixed) {
+            motion->speed = (uint32_t)fixed << 8;
+        } else if (mk_smooth_curve == MK_CURVE_KINETIC) {
+            // Pushed towards the maximum speed, against friction that grows with the speed
+            uint32_t target = (uint32_t)max << 8;
+            uint16_t tau    = time_to_max / 3 > dt ? time_to_max / 3 : dt;
+            if (motion->speed < (uint32_t)initial << 8) {
+                motion->speed = (uint32_t)initial << 8;
+            }
+            if (motion->speed < target) {
+                motion->speed += (target - motion->speed) / tau * dt;
+            } else {
+                motion->speed -= (motion->speed - target) / tau * dt;
+            }
+        } else {
+            motion->speed = curve_speed(initial, max, time_to_max, motion->held);
+        }
+    } else if (motion->speed) {
+        motion->held = 0;
+        // Only the kinetic curve glides on after the keys are released
+        if (mk_smooth_curve == MK_CURVE_KINETIC && mk_smooth_friction > dt) {
+            motion->speed -= motion->speed / mk_smooth_friction * dt;
+        } else {
+            motion->speed = 0;
+        }
+        if (motion->speed < (uint32_t)initial << 8) {
+            motion->speed = 0;
+            // Whatever is left of a pixel is dropped, so the next movement starts fresh
+            motion->x -= motion->x % MK_UNIT;
+            motion->y -= motion->y % MK_UNIT;
+        }
+    }
+
+    if (motion->speed) {
+        uint32_t distance = motion->speed * dt;
+        if (motion->dx && motion->dy) {
+            // 181/256 is close to 1/sqrt(2), so diagonals are as fast as straight lines
+            distance = (distance >> 8) * 181;
+        }
+        // Not more than two reports ahead, when the speed is higher than reports can carry
+        motion->x = clamp_distance(motion->x + motion->dx * (int32_t)distance, 2 * limit * MK_UNIT);
+        motion->y = clamp_distance(motion->y + motion->dy * (int32_t)distance, 2 * limit * MK_UNIT);
+    }
+    return motion->x <= -MK_UNIT || motion->x >= MK_UNIT || motion->y <= -MK_UNIT || motion->y >= MK_UNIT;
+}
+
+// Takes the whole units of a distance that fit in a report
+static int8_t take_distance(int32_t *distance, uint8_t limit) {
+    int32_t units = clamp_distance(*distance / MK_UNIT, limit);
+    *distance -= units * MK_UNIT;
+    return units;
+}
+
+void mousekey_task(void) {
+    uint16_t dt = timer_elapsed(last_tick);
+    if (dt == 0) {
+        return;
+    }
+    last_tick += dt;
+    if (dt > MK_MAX_STEP) {
+        dt = MK_MAX_STEP;
+    }
+
+    bool pending = motion_step(&cursor_motion, key_direction(KC_MS_LEFT, KC_MS_RIGHT), key_direction(KC_MS_UP, KC_MS_DOWN), mk_smooth_initial_speed, mk_smooth_max_speed, mk_smooth_time_to_max, MOUSEKEY_MOVE_MAX, dt);
+    pending |= motion_step(&wheel_motion, key_direction(KC_MS_WH_LEFT, KC_MS_WH_RIGHT), key_direction(KC_MS_WH_DOWN, KC_MS_WH_UP), mk_smooth_wheel_initial_speed, mk_smooth_wheel_max_speed, mk_smooth_wheel_time_to_max, MOUSEKEY_WHEEL_MAX, dt);
+    if (pending && timer_elapsed(last_timer) >= MOUSEKEY_SMOOTH_INTERVAL) {
+        mousekey_send();
+    }
+}
+
+static void mousekey_take_report(void) {
+    mouse_report.x = take_distance(&cursor_motion.x, MOUSEKEY_MOVE_MAX);
+    mouse_report.y = take_distance(&cursor_motion.y, MOUSEKEY_MOVE_MAX);
+    mouse_report.h = take_distance(&wheel_motion.x, MOUSEKEY_WHEEL_MAX);
+    mouse_report.v = take_distance(&wheel_motion.y, MOUSEKEY_WHEEL_MAX);
+}
+
+void mousekey_on(uint8_t code) {
+    if (IS_MOUSEKEY_MOVE(code) || IS_MOUSEKEY_WHEEL(code)) {
+        held_keys |= MK_KEY_BIT(code);
+    }
+    // A tap moves by exactly one pixel or scroll step, right away
+    if (code == KC_MS_UP)
+        cursor_motion.y -= MK_UNIT;
+    else if (code == KC_MS_DOWN)
+        cursor_motion.y += MK_UNIT;
+    else if (code == KC_MS_LEFT)
+        cursor_motion.x -= MK_UNIT;
+    else if (code == KC_MS_RIGHT)
+        cursor_motion.x += MK_UNIT;
+    else if (code == KC_MS_WH_UP)
+        wheel_motion.y += MK_UNIT;
+    else if (code == KC_MS_WH_DOWN)
+        wheel_motion.y -= MK_UNIT;
+    else if (code == KC_MS_WH_LEFT)
+        wheel_motion.x -= MK_UNIT;
+    else if (code == KC_MS_WH_RIGHT)
+        wheel_motion.x += MK_UNIT;
+    else if (code == KC_MS_BTN1)
+        mouse_report.buttons |= MOUSE_BTN1;
+    else if (code == KC_MS_BTN2)
+        mouse_report.buttons |= MOUSE_BTN2;
+    else if (code == KC_MS_BTN3)
+        mouse_report.buttons |= MOUSE_BTN3;
+    else if (code == KC_MS_BTN4)
+        mouse_report.buttons |= MOUSE_BTN4;
+    else if (code == KC_MS_BTN5)
+        mouse_report.buttons |= MOUSE_BTN5;
+    else if (code == KC_MS_ACCEL0)
+        mousekey_accel |= (1 << 0);
+    else if (code == KC_MS_ACCEL1)
+        mousekey_accel |= (1 << 1);
+    else if (code == KC_MS_ACCEL2)
+        mousekey_accel |= (1 << 2);
+}
+
+void mousekey_off(uint8_t code) {
+    if (IS_MOUSEKEY_MOVE(code) || IS_MOUSEKEY_WHEEL(code))
+        held_keys &= ~MK_KEY_BIT(code);
+    else if (code == KC_MS_BTN1)
+        mouse_report.buttons &= ~MOUSE_BTN1;
+    else if (code == KC_MS_BTN2)
+        mouse_report.buttons &= ~MOUSE_BTN2;
+    else if (code == KC_MS_BTN3)
+        mouse_report.buttons &= ~MOUSE_BTN3;
+    else if (code == KC_MS_BTN4)
+        mouse_report.buttons &= ~MOUSE_BTN4;
+    else if (code == KC_MS_BTN5)
+        mouse_report.buttons &= ~MOUSE_BTN5;
+    else if (code == KC_MS_ACCEL0)
+        mousekey_accel &= ~(1 << 0);
+    else if (code == KC_MS_ACCEL1)
+        mousekey_accel &= ~(1 << 1);
+    else if (code == KC_MS_ACCEL2)
+        mousekey_accel &= ~(1 << 2);
+}
+
+#elif !defined(MK_3_SPEED)
 
 static uint16_t last_timer_c = 0;
 static uint16_t last_timer_w = 0;
@@ -367,11 +586,24 @@ void mousekey_off(uint8_t code) {
 #    endif
 }
 
-#endif /* #ifndef MK_3_SPEED */
+#endif /* #if defined(MK_SMOOTH_SPEED) */
 
 void mousekey_send(void) {
+#ifdef MK_SMOOTH_SPEED
+    mousekey_take_report();
+#endif
     mousekey_debug();
+#ifdef POINTING_DEVICE_HIRES_SCROLL
+    // the wheel speeds are in notches, and so is the report until the host enables the multiplier
+    report_mouse_t report = mouse_report;
+    if (mouse_resolution_multiplier) {
+        report.v *= POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER;
+        report.h *= POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER;
+    }
+    host_mouse_send(&report);
+#else
     host_mouse_send(&mouse_report);
+#endif
     last_timer = timer_read();
 }
 
@@ -379,6 +611,11 @@ void mousekey_clear(void) {
     mouse_report    = (report_mouse_t){};
     mousekey_repeat = 0;
     mousekey_accel  = 0;
+#ifdef MK_SMOOTH_SPEED
+    cursor_motion = (mk_motion_t){0};
+    wheel_motion  = (mk_motion_t){0};
+    held_keys     = 0;
+#endif
 }
 
 static void mousekey_debug(void) {
@@ -22,7 +22,59 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <stdbool.h>
 #include "host.h"
 
-#ifndef MK_3_SPEED
+#if defined(MK_SMOOTH_SPEED)
+
+#    ifndef MOUSEKEY_MOVE_MAX
+#        define MOUSEKEY_MOVE_MAX 127
+#    elif MOUSEKEY_MOVE_MAX > 127
+#        error MOUSEKEY_MOVE_MAX needs to be smaller than 127
+#    endif
+
+#    ifndef MOUSEKEY_WHEEL_MAX
+#        define MOUSEKEY_WHEEL_MAX 127
+#    elif MOUSEKEY_WHEEL_MAX > 127
+#        error MOUSEKEY_WHEEL_MAX needs to be smaller than 127
+#    endif
+
+/* Speeds are in pixels or scroll steps per second, times in milliseconds */
+#    define MK_CURVE_LINEAR 0
+#    define MK_CURVE_QUADRATIC 1
+#    define MK_CURVE_KINETIC 2
+
+#    ifndef MOUSEKEY_SMOOTH_CURVE
+#        define MOUSEKEY_SMOOTH_CURVE MK_CURVE_QUADRATIC
+#    endif
+#    ifndef MOUSEKEY_SMOOTH_INITIAL_SPEED
+#        define MOUSEKEY_SMOOTH_INITIAL_SPEED 50
+#    endif
+#    ifndef MOUSEKEY_SMOOTH_MAX_SPEED
+#        define MOUSEKEY_SMOOTH_MAX_SPEED 1000
+#    endif
+#    ifndef MOUSEKEY_SMOOTH_TIME_TO_MAX
+#        define MOUSEKEY_SMOOTH_TIME_TO_MAX 1000
+#    endif
+#    ifndef MOUSEKEY_SMOOTH_FRICTION
+#        define MOUSEKEY_SMOOTH_FRICTION 100
+#    endif
+#    ifndef MOUSEKEY_SMOOTH_WHEEL_INITIAL_SPEED
+#        define MOUSEKEY_SMOOTH_WHEEL_INITIAL_SPEED 10
+#    endif
+#    ifndef MOUSEKEY_SMOOTH_WHEEL_MAX_SPEED
+#        define MOUSEKEY_SMOOTH_WHEEL_MAX_SPEED 80
+#    endif
+#    ifndef MOUSEKEY_SMOOTH_WHEEL_TIME_TO_MAX
+#        define MOUSEKEY_SMOOTH_WHEEL_TIME_TO_MAX 4000
+#    endif
+/* Time between reports while moving, one per USB poll by default */
+#    ifndef MOUSEKEY_SMOOTH_INTERVAL
+#        ifdef USB_POLLING_INTERVAL_MS
+#            define MOUSEKEY_SMOOTH_INTERVAL USB_POLLING_INTERVAL_MS
+#        else
+#            define MOUSEKEY_SMOOTH_INTERVAL 10
+#        endif
+#    endif
+
+#elif !defined(MK_3_SPEED)
 
 /* max value on report descriptor */
 #    ifndef MOUSEKEY_MOVE_MAX
@@ -120,12 +172,23 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #        define MK_W_INTERVAL_2 20
 #    endif
 
-#endif /* #ifndef MK_3_SPEED */
+#endif /* #if defined(MK_SMOOTH_SPEED) */
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#ifdef MK_SMOOTH_SPEED
+extern uint8_t  mk_smooth_curve;
+extern uint16_t mk_smooth_initial_speed;
+extern uint16_t mk_smooth_max_speed;
+extern uint16_t mk_smooth_time_to_max;
+extern uint16_t mk_smooth_friction;
+extern uint16_t mk_smooth_wheel_initial_speed;
+extern uint16_t mk_smooth_wheel_max_speed;
+extern uint16_t mk_smooth_wheel_time_to_max;
+#endif
+
 extern uint8_t mk_delay;
 extern uint8_t mk_interval;
 extern uint8_t mk_max_speed;
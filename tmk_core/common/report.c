@@ -54,18 +54,7 @@ uint8_t get_first_key(report_keyboard_t* keyboard_report) {
         return i << 3 | biton(keyboard_report->nkro.bits[i]);
     }
 #endif
-#ifdef USB_6KRO_ENABLE
-    uint8_t i = cb_head;
-    do {
-        if (keyboard_report->keys[i] != 0) {
-            break;
-        }
-        i = RO_INC(i);
-    } while (i != cb_tail);
-    return keyboard_report->keys[i];
-#else
     return keyboard_report->keys[0];
-#endif
 }
 
 /** \brief Checks if a key is pressed in the report
@@ -99,50 +88,6 @@ bool is_key_pressed(report_keyboard_t* keyboard_report, uint8_t key) {
  * FIXME: Needs doc
  */
 void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
-#ifdef USB_6KRO_ENABLE
-    int8_t i     = cb_head;
-    int8_t empty = -1;
-    if (cb_count) {
-        do {
-            if (keyboard_report->keys[i] == code) {
-                return;
-            }
-            if (empty == -1 && keyboard_report->keys[i] == 0) {
-                empty = i;
-            }
-            i = RO_INC(i);
-        } while (i != cb_tail);
-        if (i == cb_tail) {
-            if (cb_tail == cb_head) {
-                // buffer is full
-                if (empty == -1) {
-                    // pop head when has no empty space
-                    cb_head = RO_INC(cb_head);
-                    cb_count--;
-                } else {
-                    // left shift when has empty space
-                    uint8_t offset = 1;
-                    i              = RO_INC(empty);
-                    do {
-                        if (keyboard_report->keys[i] != 0) {
-                            keyboard_report->keys[empty] = keyboard_report->keys[i];
-                            keyboard_report->keys[i]     = 0;
-                            empty                        = RO_INC(empty);
-                        } else {
-                            offset++;
-                        }
-                        i = RO_INC(i);
-                    } while (i != cb_tail);
-                    cb_tail = RO_SUB(cb_tail, offset);
-                }
-            }
-        }
-    }
-    // add to tail
-    keyboard_report->keys[cb_tail] = code;
-    cb_tail                        = RO_INC(cb_tail);
-    cb_count++;
-#else
     int8_t i     = 0;
     int8_t empty = -1;
     for (; i < KEYBOARD_REPORT_KEYS; i++) {
@@ -158,7 +103,6 @@ void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
             keyboard_report->keys[empty] = code;
         }
     }
-#endif
 }
 
 /** \brief del key byte
@@ -166,38 +110,11 @@ void add_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
  * FIXME: Needs doc
  */
 void del_key_byte(report_keyboard_t* keyboard_report, uint8_t code) {
-#ifdef USB_6KRO_ENABLE
-    uint8_t i = cb_head;
-    if (cb_count) {
-        do {
-            if (keyboard_report->keys[i] == code) {
-                keyboard_report->keys[i] = 0;
-                cb_count--;
-                if (cb_count == 0) {
-                    // reset head and tail
-                    cb_tail = cb_head = 0;
-                }
-                if (i == RO_DEC(cb_tail)) {
-                    // left shift when next to tail
-                    do {
-                        cb_tail = RO_DEC(cb_tail);
-                        if (keyboard_report->keys[RO_DEC(cb_tail)] != 0) {
-                            break;
-                        }
-                    } while (cb_tail != cb_head);
-                }
-                break;
-            }
-            i = RO_INC(i);
-        } while (i != cb_tail);
-    }
-#else
     for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
         if (keyboard_report->keys[i] == code) {
             keyboard_report->keys[i] = 0;
         }
     }
-#endif
 }
 
 #ifdef NKRO_ENABLE
@@ -268,3 +185,86 @@ void clear_keys_from_report(report_keyboard_t* keyboard_report) {
 #endif
     memset(keyboard_report->keys, 0, sizeof(keyboard_report->keys));
 }
+
+/** \brief Add a key to the key state
+ *
+ * The presence bitmap makes duplicate presses a single test. Without
+ * USB_6KRO_ENABLE the key takes the first free 6KRO slot and is left out of
+ * the 6KRO report when all slots are taken; with it the oldest key is rolled
+ * out instead. Keys are always kept in the bitmap, so the NKRO report sees all
+ * of them.
+ */
+void report_keys_add(report_keys_t* keys, uint8_t code) {
+    if (code == KC_NO || report_keys_has(keys, code)) {
+        return;
+    }
+    keys->bits[code >> 3] |= 1 << (code & 7);
+    keys->count++;
+#ifdef USB_6KRO_ENABLE
+    if (keys->slots == KEYBOARD_REPORT_KEYS) {
+        memmove(&keys->keys[0], &keys->keys[1], KEYBOARD_REPORT_KEYS - 1);
+        keys->slots--;
+    }
+    keys->keys[keys->slots++] = code;
+#else
+    if (keys->slots == KEYBOARD_REPORT_KEYS) {
+        return;
+    }
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (keys->keys[i] == KC_NO) {
+            keys->keys[i] = code;
+            keys->slots++;
+            return;
+        }
+    }
+#endif
+}
+
+/** \brief Remove a key from the key state
+ *
+ * Keys that are not pressed return after the bitmap test. The 6KRO slots are
+ * only touched for keys that are actually held.
+ */
+void report_keys_del(report_keys_t* keys, uint8_t code) {
+    if (!report_keys_has(keys, code)) {
+        return;
+    }
+    keys->bits[code >> 3] &= ~(1 << (code & 7));
+    keys->count--;
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (keys->keys[i] == code) {
+#ifdef USB_6KRO_ENABLE
+            memmove(&keys->keys[i], &keys->keys[i + 1], keys->slots - i - 1);
+            keys->keys[keys->slots - 1] = KC_NO;
+#else
+            keys->keys[i] = KC_NO;
+#endif
+            keys->slots--;
+            return;
+        }
+    }
+}
+
+/** \brief Remove all keys from the key state
+ */
+void report_keys_clear(report_keys_t* keys) { memset(keys, 0, sizeof(report_keys_t)); }
+
+/** \brief Encode the key state into a keyboard report
+ *
+ * Writes the NKRO bitmap or the 6KRO slots depending on the current protocol.
+ * Modifiers are left untouched.
+ */
+void report_keys_encode(const report_keys_t* keys, report_keyboard_t* keyboard_report) {
+#ifdef NKRO_ENABLE
+    if (keyboard_protocol && keymap_config.nkro) {
+#    if KEYBOARD_REPORT_BITS > 32
+        memcpy(keyboard_report->nkro.bits, keys->bits, sizeof(keys->bits));
+        memset(&keyboard_report->nkro.bits[sizeof(keys->bits)], 0, KEYBOARD_REPORT_BITS - sizeof(keys->bits));
+#    else
+        memcpy(keyboard_report->nkro.bits, keys->bits, KEYBOARD_REPORT_BITS);
+#    endif
+        return;
+    }
+#endif
+    memcpy(keyboard_report->keys, keys->keys, KEYBOARD_REPORT_KEYS);
+}
@@ -125,6 +125,27 @@ enum desktop_usages {
 #    undef MOUSE_SHARED_EP
 #endif
 
+/* High resolution scrolling sends the wheels in 1/POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER
+ * of a notch, which needs 16 bit wheel axes and the resolution multiplier in
+ * the report descriptor.
+ */
+#ifdef POINTING_DEVICE_HIRES_SCROLL
+#    if defined(PROTOCOL_VUSB) || defined(PROTOCOL_ARM_ATSAM)
+#        error "POINTING_DEVICE_HIRES_SCROLL is not supported with this protocol"
+#    endif
+#    ifndef POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER
+#        define POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER 120
+#    endif
+#    if POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER < 2 || POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER > 255
+#        error "POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER must be between 2 and 255"
+#    endif
+#    define MOUSE_WHEEL_MAX 32767
+typedef int16_t mouse_wheel_t;
+#else
+#    define MOUSE_WHEEL_MAX 127
+typedef int8_t mouse_wheel_t;
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -170,6 +191,22 @@ typedef union {
 #endif
 } __attribute__((packed)) report_keyboard_t;
 
+/*
+ * Protocol independent state of the non-modifier keys.
+ *
+ * bits is a presence bitmap over the whole 8-bit keycode space, so membership,
+ * insertion and deletion never have to search the report. keys holds the
+ * 6KRO slots; with USB_6KRO_ENABLE they are kept in press order so the oldest
+ * key rolls over first. Both the 6KRO and the NKRO report are encoded from
+ * this state by report_keys_encode() just before sending.
+ */
+typedef struct {
+    uint8_t bits[32];
+    uint8_t keys[KEYBOARD_REPORT_KEYS];
+    uint8_t count;
+    uint8_t slots;
+} report_keys_t;
+
 typedef struct {
     uint8_t  report_id;
     uint16_t usage;
@@ -177,13 +214,13 @@ typedef struct {
 
 typedef struct {
 #ifdef MOUSE_SHARED_EP
-    uint8_t report_id;
+    uint8_t       report_id;
 #endif
-    uint8_t buttons;
-    int8_t  x;
-    int8_t  y;
-    int8_t  v;
-    int8_t  h;
+    uint8_t       buttons;
+    int8_t        x;
+    int8_t        y;
+    mouse_wheel_t v;
+    mouse_wheel_t h;
 } __attribute__((packed)) report_mouse_t;
 
 /* keycode to system usage */
@@ -269,6 +306,14 @@ void add_key_to_report(report_keyboard_t* keyboard_report, uint8_t key);
 void del_key_from_report(report_keyboard_t* keyboard_report, uint8_t key);
 void clear_keys_from_report(report_keyboard_t* keyboard_report);
 
+static inline bool report_keys_has(const report_keys_t* keys, uint8_t code) { return keys->bits[code >> 3] & (1 << (code & 7)); }
+static inline uint8_t report_keys_count(const report_keys_t* keys) { return keys->count; }
+
+void report_keys_add(report_keys_t* keys, uint8_t code);
+void report_keys_del(report_keys_t* keys, uint8_t code);
+void report_keys_clear(report_keys_t* keys);
+void report_keys_encode(const report_keys_t* keys, report_keyboard_t* keyboard_report);
+
 #ifdef __cplusplus
 }
 #endif
@@ -16,7 +16,10 @@
 
 #include "eeprom.h"
 
-#define EEPROM_SIZE 32
+#ifndef EEPROM_SIZE
+#    include "eeconfig.h"
+#    define EEPROM_SIZE EECONFIG_SIZE
+#endif
 
 static uint8_t buffer[EEPROM_SIZE];
 
@@ -16,18 +16,23 @@
 
 #include "timer.h"
 
-static uint32_t current_time = 0;
+// The simulated time, in microseconds
+static uint64_t current_time = 0;
 
 void timer_init(void) { current_time = 0; }
 
 void timer_clear(void) { current_time = 0; }
 
-uint16_t timer_read(void) { return current_time & 0xFFFF; }
-uint32_t timer_read32(void) { return current_time; }
+uint16_t timer_read(void) { return (current_time / 1000) & 0xFFFF; }
+uint32_t timer_read32(void) { return current_time / 1000; }
 uint16_t timer_elapsed(uint16_t last) { return TIMER_DIFF_16(timer_read(), last); }
 uint32_t timer_elapsed32(uint32_t last) { return TIMER_DIFF_32(timer_read32(), last); }
+uint32_t timer_read_us(void) { return current_time; }
+uint32_t timer_elapsed_us(uint32_t last) { return TIMER_DIFF_32(timer_read_us(), last); }
 
-void set_time(uint32_t t) { current_time = t; }
-void advance_time(uint32_t ms) { current_time += ms; }
+void set_time(uint32_t t) { current_time = (uint64_t)t * 1000; }
+void advance_time(uint32_t ms) { current_time += (uint64_t)ms * 1000; }
+void set_time_us(uint64_t t) { current_time = t; }
+void advance_time_us(uint32_t us) { current_time += us; }
 
 void wait_ms(uint32_t ms) { advance_time(ms); }
\ No newline at end of file
@@ -300,6 +300,10 @@ static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
             return;
 
         case USB_EVENT_CONFIGURED:
+#if defined(MOUSE_ENABLE) && defined(POINTING_DEVICE_HIRES_SCROLL)
+            /* The host enables the resolution multiplier again if it supports it */
+            mouse_resolution_multiplier = 0;
+#endif
             osalSysLockFromISR();
             /* Enable the endpoints specified into the configuration. */
 #ifndef KEYBOARD_SHARED_EP
@@ -393,6 +397,11 @@ static void    set_led_transfer_cb(USBDriver *usbp) {
     }
 }
 
+#if defined(MOUSE_ENABLE) && defined(POINTING_DEVICE_HIRES_SCROLL)
+static uint8_t mouse_feature_buf[MOUSE_FEATURE_SIZE];
+static void    set_mouse_feature_cb(USBDriver *usbp) { mouse_resolution_multiplier = mouse_feature_buf[MOUSE_FEATURE_SIZE - 1] & 0x01; }
+#endif
+
 /* Callback for SETUP request on the endpoint 0 (control) */
 static bool usb_request_hook_cb(USBDriver *usbp) {
     const USBDescriptor *dp;
@@ -410,6 +419,14 @@ static bool usb_request_hook_cb(USBDriver *usbp) {
             case USB_RTYPE_DIR_DEV2HOST:
                 switch (usbp->setup[1]) { /* bRequest */
                     case HID_GET_REPORT:
+#if defined(MOUSE_ENABLE) && defined(POINTING_DEVICE_HIRES_SCROLL)
+                        if (IS_MOUSE_FEATURE_REPORT(usbp->setup[4], get_hword(&usbp->setup[2]))) {
+                            mouse_feature_buf[0]                      = MOUSE_FEATURE_REPORT_ID;
+                            mouse_feature_buf[MOUSE_FEATURE_SIZE - 1] = mouse_resolution_multiplier;
+                            usbSetupTransfer(usbp, mouse_feature_buf, MOUSE_FEATURE_SIZE, NULL);
+                            return TRUE;
+                        }
+#endif
                         switch (usbp->setup[4]) { /* LSB(wIndex) (check MSB==0?) */
                             case KEYBOARD_INTERFACE:
                                 usbSetupTransfer(usbp, (uint8_t *)&keyboard_report_sent, sizeof(keyboard_report_sent), NULL);
@@ -447,6 +464,12 @@ static bool usb_request_hook_cb(USBDriver *usbp) {
             case USB_RTYPE_DIR_HOST2DEV:
                 switch (usbp->setup[1]) { /* bRequest */
                     case HID_SET_REPORT:
+#if defined(MOUSE_ENABLE) && defined(POINTING_DEVICE_HIRES_SCROLL)
+                        if (IS_MOUSE_FEATURE_REPORT(usbp->setup[4], get_hword(&usbp->setup[2]))) {
+                            usbSetupTransfer(usbp, mouse_feature_buf, MOUSE_FEATURE_SIZE, set_mouse_feature_cb);
+                            return TRUE;
+                        }
+#endif
                         switch (usbp->setup[4]) { /* LSB(wIndex) (check MSB==0?) */
                             case KEYBOARD_INTERFACE:
 #if defined(SHARED_EP_ENABLE) && !defined(KEYBOARD_SHARED_EP)
@@ -833,6 +856,8 @@ void raw_hid_task(void) {
 
 void send_midi_packet(MIDI_EventPacket_t *event) { chnWrite(&drivers.midi_driver.driver, (uint8_t *)event, sizeof(MIDI_EventPacket_t)); }
 
+void send_midi_packets(MIDI_EventPacket_t *events, uint8_t count) { chnWrite(&drivers.midi_driver.driver, (uint8_t *)events, count * sizeof(MIDI_EventPacket_t)); }
+
 bool recv_midi_packet(MIDI_EventPacket_t *const event) {
     size_t size = chnReadTimeout(&drivers.midi_driver.driver, (uint8_t *)event, sizeof(MIDI_EventPacket_t), TIME_IMMEDIATE);
     return size == sizeof(MIDI_EventPacket_t);
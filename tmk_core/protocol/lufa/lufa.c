@@ -370,6 +370,11 @@ void EVENT_USB_Device_StartOfFrame(void) {
 void EVENT_USB_Device_ConfigurationChanged(void) {
     bool ConfigSuccess = true;
 
+#if defined(MOUSE_ENABLE) && defined(POINTING_DEVICE_HIRES_SCROLL)
+    /* The host enables the resolution multiplier again if it supports it */
+    mouse_resolution_multiplier = 0;
+#endif
+
     /* Setup Keyboard HID Report Endpoints */
 #ifndef KEYBOARD_SHARED_EP
     ConfigSuccess &= ENDPOINT_CONFIG(KEYBOARD_IN_EPNUM, EP_TYPE_INTERRUPT, ENDPOINT_DIR_IN, KEYBOARD_EPSIZE, ENDPOINT_BANK_SINGLE);
@@ -447,6 +452,13 @@ void EVENT_USB_Device_ControlRequest(void) {
                         ReportSize = sizeof(keyboard_report_sent);
                         break;
                 }
+#if defined(MOUSE_ENABLE) && defined(POINTING_DEVICE_HIRES_SCROLL)
+                uint8_t mouse_feature[] = {REPORT_ID_MOUSE, mouse_resolution_multiplier};
+                if (IS_MOUSE_FEATURE_REPORT(USB_ControlRequest.wIndex, USB_ControlRequest.wValue)) {
+                    ReportData = mouse_feature + sizeof(mouse_feature) - MOUSE_FEATURE_SIZE;
+                    ReportSize = MOUSE_FEATURE_SIZE;
+                }
+#endif
 
                 /* Write the report data to the control endpoint */
                 Endpoint_Write_Control_Stream_LE(ReportData, ReportSize);
@@ -456,6 +468,24 @@ void EVENT_USB_Device_ControlRequest(void) {
             break;
         case HID_REQ_SetReport:
             if (USB_ControlRequest.bmRequestType == (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE)) {
+#if defined(MOUSE_ENABLE) && defined(POINTING_DEVICE_HIRES_SCROLL)
+                if (IS_MOUSE_FEATURE_REPORT(USB_ControlRequest.wIndex, USB_ControlRequest.wValue)) {
+                    Endpoint_ClearSETUP();
+
+                    while (!(Endpoint_IsOUTReceived())) {
+                        if (USB_DeviceState == DEVICE_STATE_Unattached) return;
+                    }
+
+#    ifdef MOUSE_SHARED_EP
+                    Endpoint_Read_8();  // Report ID
+#    endif
+                    mouse_resolution_multiplier = Endpoint_Read_8() & 0x01;
+
+                    Endpoint_ClearOUT();
+                    Endpoint_ClearStatusStage();
+                    break;
+                }
+#endif
                 // Interface
                 switch (USB_ControlRequest.wIndex) {
                     case KEYBOARD_INTERFACE:
@@ -829,6 +859,15 @@ USB_ClassInfo_MIDI_Device_t USB_MIDI_Interface = {
 
 void send_midi_packet(MIDI_EventPacket_t *event) { MIDI_Device_SendEventPacket(&USB_MIDI_Interface, event); }
 
+void send_midi_packets(MIDI_EventPacket_t *events, uint8_t count) {
+    if (USB_DeviceState != DEVICE_STATE_Configured) return;
+
+    Endpoint_SelectEndpoint(USB_MIDI_Interface.Config.DataINEndpoint.Address);
+    if (Endpoint_Write_Stream_LE(events, count * sizeof(MIDI_EventPacket_t), NULL) == ENDPOINT_RWSTREAM_NoError) {
+        MIDI_Device_Flush(&USB_MIDI_Interface);
+    }
+}
+
 bool recv_midi_packet(MIDI_EventPacket_t *const event) { return MIDI_Device_ReceiveEventPacket(&USB_MIDI_Interface, event); }
 
 #endif
@@ -1,4 +1,4 @@
-// this is a single reader [maybe multiple writer?] byte queue
+// this is a single reader, single writer byte queue
 // Copyright 2008 Alex Norman
 // writen by Alex Norman
 //
@@ -40,6 +40,7 @@ typedef struct {
 void bytequeue_init(byteQueue_t* queue, uint8_t* dataArray, byteQueueIndex_t arrayLen);
 
 // add an item to the queue, returns false if the queue is full
+// only one context may add items, and only one other may get and remove them
 bool bytequeue_enqueue(byteQueue_t* queue, uint8_t item);
 
 // get the length of the queue
@@ -67,23 +67,42 @@ midi_packet_length_t midi_packet_length(uint8_t status) {
     }
 }
 
+uint8_t midi_running_status_encode(uint8_t* running_status, uint16_t cnt, uint8_t byte0, uint8_t byte1, uint8_t byte2, uint8_t* out) {
+    uint8_t bytes[3] = {byte0, byte1, byte2};
+    uint8_t skip     = 0;
+
+    if (cnt > 3) cnt = 3;
+    if (cnt > 0 && midi_is_statusbyte(byte0) && !midi_is_realtime(byte0)) {
+        if (byte0 < 0xF0) {
+            // channel messages may leave out a status byte that repeats
+            if (byte0 == *running_status) skip = 1;
+            *running_status = byte0;
+        } else {
+            // system common and sysex messages end the running status, realtime ones do not
+            *running_status = 0;
+        }
+    }
+    memcpy(out, bytes + skip, cnt - skip);
+    return cnt - skip;
+}
+
 void midi_send_cc(MidiDevice* device, uint8_t chan, uint8_t num, uint8_t val) {
     // CC Status: 0xB0 to 0xBF where the low nibble is the MIDI channel.
     // CC Data: Controller Num, Controller Val
-    device->send_func(device, 3, MIDI_CC | (chan & MIDI_CHANMASK), num & 0x7F, val & 0x7F);
+    midi_device_send(device, 3, MIDI_CC | (chan & MIDI_CHANMASK), num & 0x7F, val & 0x7F);
 }
 
 void midi_send_noteon(MidiDevice* device, uint8_t chan, uint8_t num, uint8_t vel) {
     // Note Data: Note Num, Note Velocity
-    device->send_func(device, 3, MIDI_NOTEON | (chan & MIDI_CHANMASK), num & 0x7F, vel & 0x7F);
+    midi_device_send(device, 3, MIDI_NOTEON | (chan & MIDI_CHANMASK), num & 0x7F, vel & 0x7F);
 }
 
 void midi_send_noteoff(MidiDevice* device, uint8_t chan, uint8_t num, uint8_t vel) {
     // Note Data: Note Num, Note Velocity
-    device->send_func(device, 3, MIDI_NOTEOFF | (chan & MIDI_CHANMASK), num & 0x7F, vel & 0x7F);
+    midi_device_send(device, 3, MIDI_NOTEOFF | (chan & MIDI_CHANMASK), num & 0x7F, vel & 0x7F);
 }
 
-void midi_send_aftertouch(MidiDevice* device, uint8_t chan, uint8_t note_num, uint8_t amt) { device->send_func(device, 3, MIDI_AFTERTOUCH | (chan & MIDI_CHANMASK), note_num & 0x7F, amt & 0x7F); }
+void midi_send_aftertouch(MidiDevice* device, uint8_t chan, uint8_t note_num, uint8_t amt) { midi_device_send(device, 3, MIDI_AFTERTOUCH | (chan & MIDI_CHANMASK), note_num & 0x7F, amt & 0x7F); }
 
 // XXX does this work right?
 // amt in range -0x2000, 0x1fff
@@ -99,44 +118,44 @@ void midi_send_pitchbend(MidiDevice* device, uint8_t chan, int16_t amt) {
     } else {
         uAmt = amt + 0x2000;
     }
-    device->send_func(device, 3, MIDI_PITCHBEND | (chan & MIDI_CHANMASK), uAmt & 0x7F, (uAmt >> 7) & 0x7F);
+    midi_device_send(device, 3, MIDI_PITCHBEND | (chan & MIDI_CHANMASK), uAmt & 0x7F, (uAmt >> 7) & 0x7F);
 }
 
-void midi_send_programchange(MidiDevice* device, uint8_t chan, uint8_t num) { device->send_func(device, 2, MIDI_PROGCHANGE | (chan & MIDI_CHANMASK), num & 0x7F, 0); }
+void midi_send_programchange(MidiDevice* device, uint8_t chan, uint8_t num) { midi_device_send(device, 2, MIDI_PROGCHANGE | (chan & MIDI_CHANMASK), num & 0x7F, 0); }
 
-void midi_send_channelpressure(MidiDevice* device, uint8_t chan, uint8_t amt) { device->send_func(device, 2, MIDI_CHANPRESSURE | (chan & MIDI_CHANMASK), amt & 0x7F, 0); }
+void midi_send_channelpressure(MidiDevice* device, uint8_t chan, uint8_t amt) { midi_device_send(device, 2, MIDI_CHANPRESSURE | (chan & MIDI_CHANMASK), amt & 0x7F, 0); }
 
-void midi_send_clock(MidiDevice* device) { device->send_func(device, 1, MIDI_CLOCK, 0, 0); }
+void midi_send_clock(MidiDevice* device) { midi_device_send(device, 1, MIDI_CLOCK, 0, 0); }
 
-void midi_send_tick(MidiDevice* device) { device->send_func(device, 1, MIDI_TICK, 0, 0); }
+void midi_send_tick(MidiDevice* device) { midi_device_send(device, 1, MIDI_TICK, 0, 0); }
 
-void midi_send_start(MidiDevice* device) { device->send_func(device, 1, MIDI_START, 0, 0); }
+void midi_send_start(MidiDevice* device) { midi_device_send(device, 1, MIDI_START, 0, 0); }
 
-void midi_send_continue(MidiDevice* device) { device->send_func(device, 1, MIDI_CONTINUE, 0, 0); }
+void midi_send_continue(MidiDevice* device) { midi_device_send(device, 1, MIDI_CONTINUE, 0, 0); }
 
-void midi_send_stop(MidiDevice* device) { device->send_func(device, 1, MIDI_STOP, 0, 0); }
+void midi_send_stop(MidiDevice* device) { midi_device_send(device, 1, MIDI_STOP, 0, 0); }
 
-void midi_send_activesense(MidiDevice* device) { device->send_func(device, 1, MIDI_ACTIVESENSE, 0, 0); }
+void midi_send_activesense(MidiDevice* device) { midi_device_send(device, 1, MIDI_ACTIVESENSE, 0, 0); }
 
-void midi_send_reset(MidiDevice* device) { device->send_func(device, 1, MIDI_RESET, 0, 0); }
+void midi_send_reset(MidiDevice* device) { midi_device_send(device, 1, MIDI_RESET, 0, 0); }
 
-void midi_send_tcquarterframe(MidiDevice* device, uint8_t time) { device->send_func(device, 2, MIDI_TC_QUARTERFRAME, time & 0x7F, 0); }
+void midi_send_tcquarterframe(MidiDevice* device, uint8_t time) { midi_device_send(device, 2, MIDI_TC_QUARTERFRAME, time & 0x7F, 0); }
 
 // XXX is this right?
-void midi_send_songposition(MidiDevice* device, uint16_t pos) { device->send_func(device, 3, MIDI_SONGPOSITION, pos & 0x7F, (pos >> 7) & 0x7F); }
+void midi_send_songposition(MidiDevice* device, uint16_t pos) { midi_device_send(device, 3, MIDI_SONGPOSITION, pos & 0x7F, (pos >> 7) & 0x7F); }
 
-void midi_send_songselect(MidiDevice* device, uint8_t song) { device->send_func(device, 2, MIDI_SONGSELECT, song & 0x7F, 0); }
+void midi_send_songselect(MidiDevice* device, uint8_t song) { midi_device_send(device, 2, MIDI_SONGSELECT, song & 0x7F, 0); }
 
-void midi_send_tunerequest(MidiDevice* device) { device->send_func(device, 1, MIDI_TUNEREQUEST, 0, 0); }
+void midi_send_tunerequest(MidiDevice* device) { midi_device_send(device, 1, MIDI_TUNEREQUEST, 0, 0); }
 
-void midi_send_byte(MidiDevice* device, uint8_t b) { device->send_func(device, 1, b, 0, 0); }
+void midi_send_byte(MidiDevice* device, uint8_t b) { midi_device_send(device, 1, b, 0, 0); }
 
 void midi_send_data(MidiDevice* device, uint16_t count, uint8_t byte0, uint8_t byte1, uint8_t byte2) {
     // ensure that the count passed along is always 3 or lower
     if (count > 3) {
         // TODO how to do this correctly?
     }
-    device->send_func(device, count, byte0, byte1, byte2);
+    midi_device_send(device, count, byte0, byte1, byte2);
 }
 
 void midi_send_array(MidiDevice* device, uint16_t count, uint8_t* array) {
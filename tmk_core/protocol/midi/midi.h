@@ -438,6 +438,18 @@ bool midi_is_realtime(uint8_t theByte);
  */
 midi_packet_length_t midi_packet_length(uint8_t status);
 
+/**
+ * @brief Write the bytes of a message for a serial midi port, leaving out
+ * the status byte when it repeats the last channel message (running status)
+ *
+ * @param running_status the last status byte written, keep it per port and
+ * start with 0
+ * @param cnt the number of bytes in the message, as given to a send function
+ * @param out where to write the bytes, room for 3
+ * @return the number of bytes written
+ */
+uint8_t midi_running_status_encode(uint8_t* running_status, uint16_t cnt, uint8_t byte0, uint8_t byte1, uint8_t byte2, uint8_t* out);
+
 /**@}*/
 
 /**
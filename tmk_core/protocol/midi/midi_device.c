@@ -56,6 +56,11 @@ void midi_device_init(MidiDevice* device) {
     device->input_catchall_callback    = NULL;
 
     device->pre_input_process_callback = NULL;
+
+    // batched output
+    device->send_batch_func = NULL;
+    device->output_start    = 0;
+    device->output_length   = 0;
 }
 
 void midi_device_input(MidiDevice* device, uint8_t cnt, uint8_t* input) {
@@ -65,6 +70,57 @@ void midi_device_input(MidiDevice* device, uint8_t cnt, uint8_t* input) {
 
 void midi_device_set_send_func(MidiDevice* device, midi_var_byte_func_t send_func) { device->send_func = send_func; }
 
+void midi_device_set_send_batch_func(MidiDevice* device, midi_batch_func_t send_batch_func) { device->send_batch_func = send_batch_func; }
+
+void midi_device_send(MidiDevice* device, uint16_t cnt, uint8_t byte0, uint8_t byte1, uint8_t byte2) {
+    if (!device->send_batch_func) {
+        device->send_func(device, cnt, byte0, byte1, byte2);
+        return;
+    }
+
+    // rather send early than drop a message, a lost note off leaves a note hanging
+    if (device->output_length == MIDI_OUTPUT_QUEUE_LENGTH) midi_device_flush(device);
+
+    midi_event_t* event = &device->output_queue[(device->output_start + device->output_length) % MIDI_OUTPUT_QUEUE_LENGTH];
+    event->count        = cnt;
+    event->data[0]      = byte0;
+    event->data[1]      = byte1;
+    event->data[2]      = byte2;
+    device->output_length++;
+}
+
+static bool is_cc(const midi_event_t* event) { return event->count == 3 && (event->data[0] & 0xF0) == MIDI_CC; }
+
+// RPN and NRPN sequences select a parameter and then set it, so none of them can be left out
+static bool is_parameter_cc(const midi_event_t* cc) {
+    uint8_t num = cc->data[1];
+    return num == 6 || num == 38 || (num >= 96 && num <= 101);
+}
+
+// whether the next message in the queue sets the same controller on the same channel
+static bool is_superseded(MidiDevice* device, const midi_event_t* cc) {
+    if (!is_cc(cc) || is_parameter_cc(cc) || device->output_length == 0) return false;
+    const midi_event_t* next = &device->output_queue[device->output_start];
+    return is_cc(next) && next->data[0] == cc->data[0] && next->data[1] == cc->data[1];
+}
+
+void midi_device_flush(MidiDevice* device) {
+    midi_event_t batch[MIDI_OUTPUT_BATCH_LENGTH];
+    uint8_t      count = 0;
+
+    while (device->output_length > 0) {
+        const midi_event_t* event = &device->output_queue[device->output_start];
+        device->output_start      = (device->output_start + 1) % MIDI_OUTPUT_QUEUE_LENGTH;
+        device->output_length--;
+
+        if (!is_superseded(device, event)) batch[count++] = *event;
+        if (count == MIDI_OUTPUT_BATCH_LENGTH || (count > 0 && device->output_length == 0)) {
+            device->send_batch_func(device, count, batch);
+            count = 0;
+        }
+    }
+}
+
 void midi_device_set_pre_input_process_func(MidiDevice* device, midi_no_byte_func_t pre_process_func) { device->pre_input_process_callback = pre_process_func; }
 
 void midi_device_process(MidiDevice* device) {
@@ -50,11 +50,29 @@ extern "C" {
 #include "midi_function_types.h"
 #include "bytequeue/bytequeue.h"
 #define MIDI_INPUT_QUEUE_LENGTH 192
+#ifndef MIDI_OUTPUT_QUEUE_LENGTH
+#    define MIDI_OUTPUT_QUEUE_LENGTH 32
+#endif
+// events handed to the batch function at once, a 64 byte USB endpoint of 4 byte packets
+#ifndef MIDI_OUTPUT_BATCH_LENGTH
+#    define MIDI_OUTPUT_BATCH_LENGTH 16
+#endif
 
 typedef enum { IDLE, ONE_BYTE_MESSAGE = 1, TWO_BYTE_MESSAGE = 2, THREE_BYTE_MESSAGE = 3, SYSEX_MESSAGE } input_state_t;
 
 typedef void (*midi_no_byte_func_t)(MidiDevice* device);
 
+/**
+ * @brief One message, or a part of a sysex message, as given to a send
+ * function
+ */
+typedef struct {
+    uint8_t count;
+    uint8_t data[3];
+} midi_event_t;
+
+typedef void (*midi_batch_func_t)(MidiDevice* device, uint8_t count, const midi_event_t* events);
+
 /**
  * \struct _midi_device
  *
@@ -68,6 +86,7 @@ typedef void (*midi_no_byte_func_t)(MidiDevice* device);
 struct _midi_device {
     // output send function
     midi_var_byte_func_t send_func;
+    midi_batch_func_t    send_batch_func;
 
     //********input callbacks
     // three byte funcs
@@ -105,6 +124,11 @@ struct _midi_device {
     // for queueing data between the input and the processing functions
     uint8_t     input_queue_data[MIDI_INPUT_QUEUE_LENGTH];
     byteQueue_t input_queue;
+
+    // for batching output until midi_device_flush
+    midi_event_t output_queue[MIDI_OUTPUT_QUEUE_LENGTH];
+    uint8_t      output_start;
+    uint8_t      output_length;
 };
 
 /**
@@ -131,6 +155,42 @@ void midi_device_input(MidiDevice* device, uint8_t cnt, uint8_t* input);
  */
 void midi_device_set_send_func(MidiDevice* device, midi_var_byte_func_t send_func);
 
+/**
+ * @brief Set the callback function that sends several output messages at
+ * once, instead of one call to the send function each.
+ *
+ * Once set, the send functions only queue their message, and
+ * midi_device_flush hands the queue to this callback, at most
+ * MIDI_OUTPUT_BATCH_LENGTH messages per call.  A control change that is
+ * followed right away by another one for the same controller on the same
+ * channel is dropped, except for the data entry and parameter number
+ * controllers (6, 38 and 96 to 101), which only mean something in sequence.
+ * The queue, the send functions and the flush must
+ * all be used from the same context, so none of them disables interrupts.
+ *
+ * \param device the midi device to associate this callback with
+ * \param send_batch_func the callback function that will do the sending
+ */
+void midi_device_set_send_batch_func(MidiDevice* device, midi_batch_func_t send_batch_func);
+
+/**
+ * @brief Send everything queued for a device with a batch send function.
+ * Call this once per transfer, a USB frame for instance, so that messages
+ * sent in between go out together.
+ *
+ * @param device the midi device to flush
+ */
+void midi_device_flush(MidiDevice* device);
+
+/**
+ * @brief Send or queue one message, this is what the midi send functions
+ * call.
+ *
+ * @param device the midi device to send through
+ * @param cnt the number of bytes to send, 1-3
+ */
+void midi_device_send(MidiDevice* device, uint16_t cnt, uint8_t byte0, uint8_t byte1, uint8_t byte2);
+
 /**
  * @brief Set a callback which is called at the beginning of the
  * midi_device_process call.  This can be used to poll for input
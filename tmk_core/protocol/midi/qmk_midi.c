@@ -23,11 +23,13 @@ MidiDevice midi_device;
 #define SYS_COMMON_2 0x20
 #define SYS_COMMON_3 0x30
 
-static void usb_send_func(MidiDevice* device, uint16_t cnt, uint8_t byte0, uint8_t byte1, uint8_t byte2) {
-    MIDI_EventPacket_t event;
-    event.Data1 = byte0;
-    event.Data2 = byte1;
-    event.Data3 = byte2;
+_Static_assert(MIDI_OUTPUT_BATCH_LENGTH * sizeof(MIDI_EventPacket_t) <= MIDI_STREAM_EPSIZE, "a batch must fit in the MIDI endpoint");
+
+// returns false for a message that cannot be sent
+static bool usb_event_packet(MIDI_EventPacket_t* event, uint16_t cnt, uint8_t byte0, uint8_t byte1, uint8_t byte2) {
+    event->Data1 = byte0;
+    event->Data2 = byte1;
+    event->Data3 = byte2;
 
     uint8_t cable = 0;
 
@@ -36,43 +38,58 @@ static void usb_send_func(MidiDevice* device, uint16_t cnt, uint8_t byte0, uint8
         switch (cnt) {
             case 3:
                 if (byte2 == SYSEX_END)
-                    event.Event = MIDI_EVENT(cable, SYSEX_ENDS_IN_3);
+                    event->Event = MIDI_EVENT(cable, SYSEX_ENDS_IN_3);
                 else
-                    event.Event = MIDI_EVENT(cable, SYSEX_START_OR_CONT);
+                    event->Event = MIDI_EVENT(cable, SYSEX_START_OR_CONT);
                 break;
             case 2:
                 if (byte1 == SYSEX_END)
-                    event.Event = MIDI_EVENT(cable, SYSEX_ENDS_IN_2);
+                    event->Event = MIDI_EVENT(cable, SYSEX_ENDS_IN_2);
                 else
-                    event.Event = MIDI_EVENT(cable, SYSEX_START_OR_CONT);
+                    event->Event = MIDI_EVENT(cable, SYSEX_START_OR_CONT);
                 break;
             case 1:
                 if (byte0 == SYSEX_END)
-                    event.Event = MIDI_EVENT(cable, SYSEX_ENDS_IN_1);
+                    event->Event = MIDI_EVENT(cable, SYSEX_ENDS_IN_1);
                 else
-                    event.Event = MIDI_EVENT(cable, SYSEX_START_OR_CONT);
+                    event->Event = MIDI_EVENT(cable, SYSEX_START_OR_CONT);
                 break;
             default:
-                return;  // invalid cnt
+                return false;  // invalid cnt
         }
     } else {
         // deal with 'system common' messages
         // TODO are there any more?
         switch (byte0 & 0xF0) {
             case MIDI_SONGPOSITION:
-                event.Event = MIDI_EVENT(cable, SYS_COMMON_3);
+                event->Event = MIDI_EVENT(cable, SYS_COMMON_3);
                 break;
             case MIDI_SONGSELECT:
             case MIDI_TC_QUARTERFRAME:
-                event.Event = MIDI_EVENT(cable, SYS_COMMON_2);
+                event->Event = MIDI_EVENT(cable, SYS_COMMON_2);
                 break;
             default:
-                event.Event = MIDI_EVENT(cable, byte0);
+                event->Event = MIDI_EVENT(cable, byte0);
                 break;
         }
     }
 
-    send_midi_packet(&event);
+    return true;
+}
+
+static void usb_send_func(MidiDevice* device, uint16_t cnt, uint8_t byte0, uint8_t byte1, uint8_t byte2) {
+    MIDI_EventPacket_t event;
+    if (usb_event_packet(&event, cnt, byte0, byte1, byte2)) send_midi_packet(&event);
+}
+
+// sends what was queued within one frame as one transfer
+static void usb_send_batch_func(MidiDevice* device, uint8_t count, const midi_event_t* events) {
+    MIDI_EventPacket_t packets[MIDI_OUTPUT_BATCH_LENGTH];
+    uint8_t            length = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (usb_event_packet(&packets[length], events[i].count, events[i].data[0], events[i].data[1], events[i].data[2])) length++;
+    }
+    if (length > 0) send_midi_packets(packets, length);
 }
 
 static void usb_get_midi(MidiDevice* device) {
@@ -167,6 +184,7 @@ void setup_midi(void) {
 #endif
     midi_device_init(&midi_device);
     midi_device_set_send_func(&midi_device, usb_send_func);
+    midi_device_set_send_batch_func(&midi_device, usb_send_batch_func);
     midi_device_set_pre_input_process_func(&midi_device, usb_get_midi);
     midi_register_fallthrough_callback(&midi_device, fallthrough_callback);
     midi_register_cc_callback(&midi_device, cc_callback);
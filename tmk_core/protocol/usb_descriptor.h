@@ -167,6 +167,25 @@ enum usb_interfaces {
     TOTAL_INTERFACES
 };
 
+#if defined(MOUSE_ENABLE) && defined(POINTING_DEVICE_HIRES_SCROLL)
+/*
+ * The mouse feature report holds the resolution multiplier of the wheels,
+ * after the report ID when the mouse shares an endpoint. GET_REPORT and
+ * SET_REPORT ask for it with the report type and ID in wValue.
+ */
+#    define HID_REPORT_TYPE_FEATURE 3
+#    ifdef MOUSE_SHARED_EP
+#        define MOUSE_FEATURE_INTERFACE SHARED_INTERFACE
+#        define MOUSE_FEATURE_REPORT_ID REPORT_ID_MOUSE
+#        define MOUSE_FEATURE_SIZE 2
+#    else
+#        define MOUSE_FEATURE_INTERFACE MOUSE_INTERFACE
+#        define MOUSE_FEATURE_REPORT_ID 0
+#        define MOUSE_FEATURE_SIZE 1
+#    endif
+#    define IS_MOUSE_FEATURE_REPORT(interface, value) ((interface) == MOUSE_FEATURE_INTERFACE && (value) == (HID_REPORT_TYPE_FEATURE << 8 | MOUSE_FEATURE_REPORT_ID))
+#endif
+
 #define NEXT_EPNUM __COUNTER__
 
 /*